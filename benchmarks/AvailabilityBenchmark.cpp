@@ -0,0 +1,97 @@
+// 全量重算可用數量的效能比較：逐筆 SummaryData::calculate_availables() 與 AvailabilityColumns 批次核心
+#include "domain/AvailabilityColumns.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using finance::domain::AvailabilityColumns;
+using finance::domain::SummaryData;
+
+namespace
+{
+    std::vector<SummaryData> makeSamples(size_t count)
+    {
+        std::vector<SummaryData> samples(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto &d = samples[i];
+            const auto base = static_cast<int64_t>(i);
+            d.stock_id = std::to_string(1000 + i % 9000);
+            d.area_center = "9A" + std::to_string(i % 10);
+            d.h01_margin_amount = base * 1000003;
+            d.h01_margin_buy_order_amount = base * 7;
+            d.h01_margin_sell_match_amount = base * 11;
+            d.h01_margin_qty = base % 50000;
+            d.h01_margin_buy_order_qty = base % 13;
+            d.h01_margin_sell_match_qty = base % 17;
+            d.h01_short_amount = base * 999983;
+            d.h01_short_sell_order_amount = base * 5;
+            d.h01_short_qty = base % 30000;
+            d.h01_short_sell_order_qty = base % 19;
+            d.h01_short_after_hour_sell_order_amount = base * 3;
+            d.h01_short_after_hour_sell_order_qty = base % 23;
+            d.h01_short_sell_match_amount = base * 2;
+            d.h01_short_sell_match_qty = base % 29;
+            d.h01_margin_after_hour_buy_order_amount = base * 13;
+            d.h01_margin_after_hour_buy_order_qty = base % 31;
+            d.h01_margin_buy_match_amount = base * 17;
+            d.h01_margin_buy_match_qty = base % 37;
+            d.h05p_margin_buy_offset_qty = base % 41;
+            d.h05p_short_sell_offset_qty = base % 43;
+        }
+        return samples;
+    }
+
+    template <typename Fn>
+    double nsPerEntry(size_t rounds, size_t entries, Fn &&fn)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; ++r)
+            fn();
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return elapsed / static_cast<double>(rounds * entries);
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // 預設約為 2000 檔股票 x 16 個區中心
+    const size_t entries = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 32000;
+    const size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200;
+    auto samples = makeSamples(entries);
+
+    int64_t checksum = 0;
+    double perRecord = nsPerEntry(rounds, entries, [&]
+                                  {
+        for (auto &d : samples)
+            d.calculate_availables();
+        checksum += samples[entries / 2].after_margin_available_qty; });
+
+    AvailabilityColumns columns;
+    columns.resize(entries);
+    for (size_t i = 0; i < entries; ++i)
+        columns.load(i, samples[i]);
+    double kernelOnly = nsPerEntry(rounds, entries, [&]
+                                   {
+        columns.recalculateAll();
+        checksum += columns.output(AvailabilityColumns::AfterMarginAvailableQty)[entries / 2]; });
+
+    // 與 RedisSummaryAdapter::recalculateAll() 相同：由快取載入、批次重算、再寫回
+    double roundTrip = nsPerEntry(rounds, entries, [&]
+                                  {
+        columns.resize(entries);
+        for (size_t i = 0; i < entries; ++i)
+            columns.load(i, samples[i]);
+        columns.recalculateAll();
+        for (size_t i = 0; i < entries; ++i)
+            columns.store(i, samples[i]);
+        checksum += samples[entries / 2].after_margin_available_qty; });
+
+    std::printf("entries: %zu x %zu rounds, isa %s (checksum %lld)\n",
+                entries, rounds, AvailabilityColumns::isaName(), static_cast<long long>(checksum));
+    std::printf("calculate_availables per record: %6.2f ns/entry\n", perRecord);
+    std::printf("AvailabilityColumns kernel     : %6.2f ns/entry (%.1fx)\n", kernelOnly, perRecord / kernelOnly);
+    std::printf("load + kernel + store          : %6.2f ns/entry (%.1fx)\n", roundTrip, perRecord / roundTrip);
+    return 0;
+}
@@ -0,0 +1,99 @@
+// 後台數字欄位解碼的效能比較：逐字元版本、SIMD 單欄位、整筆 HCRTM01 批次解碼
+#include "utils/BackOfficeDecoder.hpp"
+#include "infrastructure/network/MessageSchema.hpp"
+#include "domain/FinanceDataStructure.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using finance::domain::MessageDataHCRTM01;
+using finance::utils::BackOfficeDecoder;
+
+namespace
+{
+    using Hcrtm01Decoder = finance::infrastructure::network::SchemaDecoder<MessageDataHCRTM01>;
+    constexpr const BackOfficeDecoder::Field *FIELDS = Hcrtm01Decoder::DECODER_FIELDS.data();
+    constexpr size_t FIELD_COUNT = Hcrtm01Decoder::FIELD_COUNT;
+
+    // 以前補 0 的數字填滿欄位，約一半為負數 (最後一碼為負號碼)
+    std::vector<MessageDataHCRTM01> makeRecords(size_t count)
+    {
+        std::vector<MessageDataHCRTM01> records(count);
+        uint64_t seed = 88172645463325252ULL;
+        for (auto &r : records)
+        {
+            std::memset(&r, ' ', sizeof(r));
+            for (size_t k = 0; k < FIELD_COUNT; ++k)
+            {
+                const auto &f = FIELDS[k];
+                seed ^= seed << 13;
+                seed ^= seed >> 7;
+                seed ^= seed << 17;
+                char *p = reinterpret_cast<char *>(&r) + f.offset;
+                for (size_t i = 0; i < f.length; ++i)
+                    p[i] = static_cast<char>('0' + (seed >> (i * 3)) % 10);
+                if (seed & 1)
+                    p[f.length - 1] = "}JKLMNOPQR"[(seed >> 8) % 10];
+            }
+        }
+        return records;
+    }
+
+    template <typename Fn>
+    double nsPerRecord(size_t rounds, size_t records, Fn &&fn)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; ++r)
+            fn();
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return elapsed / static_cast<double>(rounds * records);
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    const size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200;
+    auto records = makeRecords(count);
+    int64_t values[FIELD_COUNT];
+    int64_t checksum = 0;
+
+    double scalar = nsPerRecord(rounds, count, [&]
+                                {
+        for (const auto &r : records)
+        {
+            const char *base = reinterpret_cast<const char *>(&r);
+            for (size_t i = 0; i < FIELD_COUNT; ++i)
+                BackOfficeDecoder::decodeScalar(base + FIELDS[i].offset, FIELDS[i].length, values[i]);
+            checksum += values[FIELD_COUNT - 1];
+        } });
+
+    double single = nsPerRecord(rounds, count, [&]
+                                {
+        for (const auto &r : records)
+        {
+            const char *base = reinterpret_cast<const char *>(&r);
+            for (size_t i = 0; i < FIELD_COUNT; ++i)
+                BackOfficeDecoder::decode(base + FIELDS[i].offset, FIELDS[i].length, values[i]);
+            checksum += values[FIELD_COUNT - 1];
+        } });
+
+    double batch = nsPerRecord(rounds, count, [&]
+                               {
+        BackOfficeDecoder::Status status;
+        for (const auto &r : records)
+        {
+            BackOfficeDecoder::decodeBatch(reinterpret_cast<const char *>(&r), sizeof(r), FIELDS, FIELD_COUNT, values, status);
+            checksum += values[FIELD_COUNT - 1];
+        } });
+
+    std::printf("records: %zu x %zu rounds, %zu fields each, isa %s (checksum %lld)\n",
+                count, rounds, FIELD_COUNT, BackOfficeDecoder::isaName(), static_cast<long long>(checksum));
+    std::printf("scalar per field : %6.1f ns/record\n", scalar);
+    std::printf("decode per field : %6.1f ns/record (%.1fx)\n", single, scalar / single);
+    std::printf("decodeBatch      : %6.1f ns/record (%.1fx)\n", batch, scalar / batch);
+    return 0;
+}
@@ -0,0 +1,167 @@
+// 封包處理管線比較：split (producer → RingBuffer → consumer)、run-to-completion (單一 thread) 與 sharded (依股票分到 N 個 shard)
+// 以本機 TCP 連線送出 HCRTM01，量測單筆來回延遲 (送出一筆、等處理完成再送下一筆) 與連續灌入時的吞吐量
+#include "infrastructure/network/TcpServiceAdapter.hpp"
+#include "infrastructure/network/MessageSchema.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <netinet/tcp.h> // TCP_NODELAY
+#include <string>
+#include <vector>
+
+using namespace finance;
+using infrastructure::network::PipelineMode;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // 解碼並套用到本地 SummaryData，代表 handler 的 decode → apply；Redis 投遞不在量測範圍
+    class DecodingHandler : public domain::IPackageHandler
+    {
+    public:
+        domain::Result<void, domain::ErrorResult> handle(const domain::FinancePackageMessage &pkg) override
+        {
+            thread_local domain::SummaryData summary; // sharded 模式下各 shard thread 各自一份
+            auto res = infrastructure::network::SchemaDecoder<domain::MessageDataHCRTM01>::decode(pkg, summary);
+            handled_.fetch_add(1, std::memory_order_release);
+            return res;
+        }
+
+        size_t handled() const noexcept { return handled_.load(std::memory_order_acquire); }
+
+    private:
+        std::atomic<size_t> handled_{0};
+    };
+
+    std::string makePacket(size_t stock)
+    {
+        domain::FinancePackageMessage pkg;
+        std::memset(&pkg, ' ', sizeof(pkg));
+        std::memcpy(pkg.p_code, "0200", 4);
+        std::memcpy(pkg.t_code, "ELD001", 6);
+        auto &data = pkg.ap_data.data.hcrtm01;
+        std::memcpy(data.area_center, "910", 3);
+        const std::string stockId = std::to_string(1000 + stock % 9000);
+        std::memcpy(data.stock_id, stockId.data(), stockId.size());
+        char *base = reinterpret_cast<char *>(&data);
+        for (const auto &f : infrastructure::network::SchemaDecoder<domain::MessageDataHCRTM01>::DECODER_FIELDS)
+            std::memset(base + f.offset, '1', f.length);
+        std::string packet(reinterpret_cast<const char *>(&pkg), sizeof(pkg));
+        packet.push_back('\n');
+        return packet;
+    }
+
+    int connectTo(int port)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<unsigned short>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            std::perror("connect");
+            std::exit(1);
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        return fd;
+    }
+
+    void sendAll(int fd, const char *data, size_t len)
+    {
+        while (len > 0)
+        {
+            ssize_t n = send(fd, data, len, 0);
+            if (n <= 0)
+            {
+                std::perror("send");
+                std::exit(1);
+            }
+            data += n;
+            len -= static_cast<size_t>(n);
+        }
+    }
+
+    void waitHandled(const DecodingHandler &handler, size_t target)
+    {
+        while (handler.handled() < target)
+            std::this_thread::yield();
+    }
+
+    void run(PipelineMode mode, int port, size_t packets, size_t rounds, int cpu, size_t shards)
+    {
+        auto handler = std::make_shared<DecodingHandler>();
+        infrastructure::network::TcpServiceAdapter adapter(handler, nullptr);
+        adapter.setPipelineMode(mode, cpu, shards);
+        adapter.start();
+        int fd = connectTo(port);
+        const std::string packet = makePacket(0);
+
+        // 延遲：一次只有一筆在途
+        std::vector<double> latencies;
+        latencies.reserve(rounds);
+        for (size_t i = 0; i < rounds; ++i)
+        {
+            size_t target = handler->handled() + 1;
+            auto start = Clock::now();
+            sendAll(fd, packet.data(), packet.size());
+            waitHandled(*handler, target);
+            latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        // 吞吐量：每次 send 64 筆 (不同股票)，持續灌入
+        constexpr size_t PACKETS_PER_SEND = 64;
+        std::string chunk;
+        for (size_t i = 0; i < PACKETS_PER_SEND; ++i)
+            chunk += makePacket(i);
+        size_t target = handler->handled() + packets;
+        auto start = Clock::now();
+        for (size_t sent = 0; sent < packets; sent += PACKETS_PER_SEND)
+        {
+            size_t n = std::min(PACKETS_PER_SEND, packets - sent);
+            sendAll(fd, chunk.data(), n * packet.size());
+        }
+        waitHandled(*handler, target);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        close(fd);
+        adapter.stop();
+
+        auto pct = [&](double p)
+        { return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))]; };
+        std::printf("%-18s latency p50 %7.1f us  p99 %7.1f us  max %8.1f us | throughput %9.0f packets/s\n",
+                    infrastructure::network::pipelineModeName(mode), pct(0.50), pct(0.99), latencies.back(),
+                    static_cast<double>(packets) / seconds);
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t packets = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    const size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000;
+    const int port = argc > 3 ? std::atoi(argv[3]) : 19516;
+    const int cpu = argc > 4 ? std::atoi(argv[4]) : -1;
+    const char *waitMode = argc > 5 ? argv[5] : "spin_park";
+    const size_t shards = argc > 6 ? std::strtoull(argv[6], nullptr, 10) : 4;
+    loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+
+    const std::string configPath = "pipeline_benchmark_connection.json";
+    std::ofstream(configPath) << "{\"redis_url\":\"tcp://127.0.0.1:6379\",\"redis_password\":\"\",\"server_port\":" << port
+                              << ",\"socket_timeout_ms\":5000,\"consumer_wait_mode\":\"" << waitMode << "\"}";
+    if (!infrastructure::config::ConnectionConfigProvider::loadFromFile(configPath))
+        return 1;
+    std::remove(configPath.c_str());
+
+    std::printf("%zu packets, %zu latency rounds, wait mode %s, run-to-completion cpu %d, %zu shards\n",
+                packets, rounds, waitMode, cpu, shards);
+    run(PipelineMode::Split, port, packets, rounds, cpu, shards);
+    run(PipelineMode::RunToCompletion, port, packets, rounds, cpu, shards);
+    run(PipelineMode::Sharded, port, packets, rounds, cpu, shards);
+    return 0;
+}
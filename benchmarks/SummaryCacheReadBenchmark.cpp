@@ -0,0 +1,143 @@
+// 快取讀寫競爭比較：讀者以 shared_mutex 共享鎖查詢並複製 SummaryData (原做法)，與以 seqlock 無鎖讀取 SummarySnapshot
+// 一個寫者持續更新並發佈資料，R 個讀者持續讀取隨機 key，量測固定時間內雙方的吞吐量
+#include "infrastructure/storage/SummaryTable.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using finance::domain::SummaryData;
+using finance::domain::SummaryKey;
+using finance::domain::SummarySnapshot;
+using finance::infrastructure::storage::SummaryTable;
+
+namespace
+{
+    struct Counts
+    {
+        double readsPerSecond;
+        double writesPerSecond;
+    };
+
+    std::vector<SummaryKey> makeKeys(size_t count)
+    {
+        std::vector<SummaryKey> keys;
+        keys.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            keys.push_back(*SummaryKey::make("9A" + std::to_string(i % 10), std::to_string(1000 + i / 10)));
+        return keys;
+    }
+
+    // reader(key, sink) 回傳讀取是否成功；writer(key, value) 更新一筆
+    template <typename Reader, typename Writer>
+    Counts contend(const std::vector<SummaryKey> &keys, size_t readers, double seconds, Reader &&reader, Writer &&writer)
+    {
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> reads{0};
+        std::vector<std::thread> threads;
+        for (size_t r = 0; r < readers; ++r)
+        {
+            threads.emplace_back([&, r]
+                                 {
+                                     uint64_t local = 0;
+                                     int64_t sink = 0;
+                                     size_t i = r * 7919;
+                                     while (!stop.load(std::memory_order_relaxed))
+                                     {
+                                         i = (i + 104729) % keys.size();
+                                         if (reader(keys[i], sink))
+                                             ++local;
+                                     }
+                                     reads.fetch_add(local);
+                                     if (sink == 42) // 避免讀取被最佳化掉
+                                         std::printf(" ");
+                                 });
+        }
+
+        uint64_t writes = 0;
+        const auto start = std::chrono::steady_clock::now();
+        const auto deadline = start + std::chrono::duration<double>(seconds);
+        size_t i = 0;
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            for (int batch = 0; batch < 256; ++batch, ++writes)
+            {
+                i = (i + 15485863) % keys.size();
+                writer(keys[i], static_cast<int64_t>(writes));
+            }
+        }
+        stop.store(true);
+        for (auto &t : threads)
+            t.join();
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return {static_cast<double>(reads.load()) / elapsed, static_cast<double>(writes) / elapsed};
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // 預設約為 2000 檔股票 x 10 個區中心
+    const size_t entries = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    const size_t maxReaders = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4;
+    const double seconds = argc > 3 ? std::atof(argv[3]) : 1.0;
+
+    const auto keys = makeKeys(entries);
+    SummaryTable table;
+    for (const auto &key : keys)
+    {
+        auto *data = table.emplace(key).first;
+        table.publish(key, *data);
+    }
+    std::shared_mutex mutex;
+
+    std::printf("%zu entries, %.1f s per run, 1 writer\n", entries, seconds);
+    for (size_t readers = 1; readers <= maxReaders; readers *= 2)
+    {
+        const Counts locked = contend(
+            keys, readers, seconds,
+            [&](SummaryKey key, int64_t &sink)
+            {
+                std::shared_lock<std::shared_mutex> lock(mutex);
+                const SummaryData *data = table.find(key);
+                if (data == nullptr)
+                    return false;
+                SummaryData copy = *data;
+                sink += copy.h01_margin_amount;
+                return true;
+            },
+            [&](SummaryKey key, int64_t value)
+            {
+                std::unique_lock<std::shared_mutex> lock(mutex);
+                auto *data = table.find(key);
+                data->h01_margin_amount = value;
+                data->margin_available_qty = value;
+            });
+
+        const Counts seqlock = contend(
+            keys, readers, seconds,
+            [&](SummaryKey key, int64_t &sink)
+            {
+                SummarySnapshot snapshot;
+                if (!table.readPublished(key, snapshot))
+                    return false;
+                sink += snapshot.h01_margin_amount;
+                return true;
+            },
+            [&](SummaryKey key, int64_t value)
+            {
+                auto *data = table.find(key);
+                data->h01_margin_amount = value;
+                data->margin_available_qty = value;
+                table.publish(key, *data);
+            });
+
+        std::printf("%zu readers | shared_mutex  reads %12.0f/s  writes %11.0f/s | seqlock  reads %12.0f/s  writes %11.0f/s\n",
+                    readers, locked.readsPerSecond, locked.writesPerSecond, seqlock.readsPerSecond, seqlock.writesPerSecond);
+    }
+    return 0;
+}
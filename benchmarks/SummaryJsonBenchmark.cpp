@@ -0,0 +1,96 @@
+// SummaryData 序列化效能比較：nlohmann::json DOM + dump() 與 SummaryJsonWriter
+#include "infrastructure/storage/SummaryJsonWriter.hpp"
+#include "infrastructure/config/AreaBranchProvider.hpp"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using finance::domain::SummaryData;
+using finance::infrastructure::config::AreaBranchProvider;
+using finance::infrastructure::storage::SummaryJsonWriter;
+
+namespace
+{
+    std::string domJson(const SummaryData &data)
+    {
+        nlohmann::json j;
+        j["stock_id"] = data.stock_id;
+        j["area_center"] = data.area_center;
+        j["margin_available_amount"] = data.margin_available_amount;
+        j["margin_available_qty"] = data.margin_available_qty;
+        j["short_available_amount"] = data.short_available_amount;
+        j["short_available_qty"] = data.short_available_qty;
+        j["after_margin_available_amount"] = data.after_margin_available_amount;
+        j["after_margin_available_qty"] = data.after_margin_available_qty;
+        j["after_short_available_amount"] = data.after_short_available_amount;
+        j["after_short_available_qty"] = data.after_short_available_qty;
+        j["belong_branches"] = data.belong_branches.get();
+        return j.dump();
+    }
+
+    std::vector<SummaryData> makeSamples(size_t count)
+    {
+        std::vector<SummaryData> samples(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto &d = samples[i];
+            d.stock_id = std::to_string(1000 + i % 9000);
+            d.area_center = i % 4 == 0 ? "ALL" : "9A" + std::to_string(i % 10);
+            d.margin_available_amount = static_cast<int64_t>(i) * 1234567;
+            d.margin_available_qty = static_cast<int64_t>(i % 5000);
+            d.short_available_amount = static_cast<int64_t>(i) * 7654321;
+            d.short_available_qty = static_cast<int64_t>(i % 3000);
+            d.after_margin_available_amount = d.margin_available_amount / 2;
+            d.after_margin_available_qty = d.margin_available_qty / 2;
+            d.after_short_available_amount = d.short_available_amount / 2;
+            d.after_short_available_qty = d.short_available_qty / 2;
+            std::vector<std::string> branches;
+            for (size_t b = 0; b < 1 + i % 12; ++b)
+                branches.push_back("9" + std::string(1, static_cast<char>('A' + b)) + "00");
+            d.belong_branches = AreaBranchProvider::internBranches(branches);
+        }
+        return samples;
+    }
+
+    template <typename Fn>
+    double nsPerOp(size_t iterations, Fn &&fn)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+            fn(i);
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return elapsed / static_cast<double>(iterations);
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const auto samples = makeSamples(4096);
+
+    size_t checksum = 0;
+    double dom = nsPerOp(iterations, [&](size_t i)
+                         { checksum += domJson(samples[i % samples.size()]).size(); });
+
+    std::string &buffer = SummaryJsonWriter::threadBuffer();
+    double writer = nsPerOp(iterations, [&](size_t i)
+                            {
+        SummaryJsonWriter::write(samples[i % samples.size()], buffer);
+        checksum += buffer.size(); });
+
+    // 與 RedisSummaryAdapter 相同：寫入緩衝區後複製出一份 payload
+    double writerCopy = nsPerOp(iterations, [&](size_t i)
+                                {
+        SummaryJsonWriter::write(samples[i % samples.size()], buffer);
+        std::string payload(buffer);
+        checksum += payload.size(); });
+
+    std::printf("iterations: %zu (checksum %zu)\n", iterations, checksum);
+    std::printf("nlohmann dom+dump     : %8.1f ns/op\n", dom);
+    std::printf("SummaryJsonWriter     : %8.1f ns/op (%.1fx)\n", writer, dom / writer);
+    std::printf("SummaryJsonWriter+copy: %8.1f ns/op (%.1fx)\n", writerCopy, dom / writerCopy);
+    return 0;
+}
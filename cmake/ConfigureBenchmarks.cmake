@@ -0,0 +1,16 @@
+function(ConfigureBenchmarks)
+    if(NOT BUILD_BENCHMARKS)
+        return()
+    endif()
+
+    # benchmarks/ 下每個 .cpp 為一個獨立的執行檔 (自帶 main)
+    file(GLOB BENCHMARK_SOURCES CONFIGURE_DEPENDS ${CMAKE_SOURCE_DIR}/benchmarks/*.cpp)
+
+    foreach(file IN LISTS BENCHMARK_SOURCES)
+        get_filename_component(name ${file} NAME_WE)
+        add_executable(${name} ${file})
+        target_include_directories(${name} PRIVATE ${CMAKE_SOURCE_DIR}/src)
+        LinkThirdparty(${name})
+        message(STATUS "已建立效能測試目標: ${name}")
+    endforeach()
+endfunction()
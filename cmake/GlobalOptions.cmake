@@ -10,6 +10,15 @@ function(DefineGlobalOptions)
 
     set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -fPIC")
 
+    # RingBuffer 分隔符掃描預設使用 SSE2，部署機器支援 AVX2 時可開啟
+    option(ENABLE_AVX2 "Compile with AVX2 (-mavx2)" OFF)
+    if(ENABLE_AVX2)
+        add_compile_options(-mavx2)
+    endif()
+
+    # benchmarks/ 下的效能測試程式，預設不建置
+    option(BUILD_BENCHMARKS "Build benchmarks" OFF)
+
     set(THIRD_PARTY_DIR ${CMAKE_SOURCE_DIR}/third_party CACHE STRING "Path to third-party libraries")
     include(${THIRD_PARTY_DIR}/LinkThirdparty.cmake OPTIONAL)
 
@@ -31,6 +40,8 @@ function(DefineGlobalOptions)
     message(STATUS " LINK_NLOHMANN_JSON: ${LINK_NLOHMANN_JSON}")
     message(STATUS " LINK_REDIS_PLUS_PLUS: ${LINK_REDIS_PLUS_PLUS}")
     message(STATUS " LINK_SPDLOG: ${LINK_SPDLOG}")
+    message(STATUS " ENABLE_AVX2: ${ENABLE_AVX2}")
+    message(STATUS " BUILD_BENCHMARKS: ${BUILD_BENCHMARKS}")
 
     message(STATUS "C++ 標準: ${CMAKE_CXX_STANDARD}")
     message(STATUS "第三方庫目錄: ${THIRD_PARTY_DIR}")
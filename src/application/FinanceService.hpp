@@ -10,15 +10,21 @@
 #include <csignal>
 #include <loguru.hpp>
 #include <functional>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
 
 #include "domain/IFinanceRepository.hpp"
 #include "domain/IPackageHandler.hpp"
 #include "domain/FinanceDataStructure.hpp"
 #include "infrastructure/network/TcpServiceAdapter.hpp"
 #include "infrastructure/config/ConnectionConfigProvider.hpp"
+#include "infrastructure/config/StockUniverse.hpp"
 #include "infrastructure/tasks/RedisTask.hpp"
-#include "infrastructure/tasks/RedisWorker.hpp"
+#include "infrastructure/tasks/RedisWorkerPool.hpp"
 #include "infrastructure/storage/RedisSummaryAdapter.hpp"
+#include "infrastructure/storage/PacketJournal.hpp"
 
 namespace finance::application
 {
@@ -28,7 +34,7 @@ namespace finance::application
     using finance::domain::SummaryData;
     using finance::infrastructure::tasks::RedisOperationType;
     using finance::infrastructure::tasks::RedisTask;
-    using finance::infrastructure::tasks::RedisWorker;
+    using finance::infrastructure::tasks::RedisWorkerPool;
 
     class FinanceService
     {
@@ -38,7 +44,18 @@ namespace finance::application
             std::shared_ptr<finance::domain::IPackageHandler> handler)
             : repository_(std::move(repo)), processor_(std::move(handler)) {}
 
-        ~FinanceService() = default;
+        ~FinanceService()
+        {
+            {
+                std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+                checkpoint_stop_ = true;
+            }
+            checkpoint_cv_.notify_one();
+            if (checkpoint_thread_.joinable())
+                checkpoint_thread_.join();
+            if (reconcile_thread_.joinable())
+                reconcile_thread_.join();
+        }
 
         // src/application/FinanceService.hpp
         Result<void, ErrorResult> initialize()
@@ -63,8 +80,22 @@ namespace finance::application
                 }
                 LOG_F(INFO, "FinanceService::initialize: Repository initialized successfully.");
 
+                // 設定快取檔時先由檔案還原；還原到資料就不需要 loadAll()，改在服務開始後於背景與 Redis 對帳
+                auto redis_adapter = std::dynamic_pointer_cast<infrastructure::storage::RedisSummaryAdapter>(repository_);
+                size_t restored = 0;
+                const auto &cacheFile = infrastructure::config::ConnectionConfigProvider::summaryCacheFile();
+                if (!cacheFile.empty() && redis_adapter)
+                {
+                    auto file = infrastructure::storage::MappedSummaryFile::open(
+                        cacheFile, infrastructure::config::ConnectionConfigProvider::summaryCacheCapacity());
+                    if (!file)
+                        return Result<void, ErrorResult>::Err(
+                            ErrorResult{ErrorCode::InternalError, "Cannot open summary cache file: " + cacheFile});
+                    restored = redis_adapter->attachPersistentCache(std::move(file));
+                }
+
                 LOG_F(INFO, "FinanceService::initialize: Loading all data from repository...");
-                auto loadAllResult = repository_->loadAll();
+                auto loadAllResult = restored > 0 ? Result<void, ErrorResult>::Ok() : repository_->loadAll();
                 if (loadAllResult.is_err())
                 {
                     LOG_F(ERROR, "FinanceService::initialize: Failed to load all data: %s", loadAllResult.unwrap_err().message.c_str());
@@ -78,11 +109,30 @@ namespace finance::application
                     LOG_F(INFO, "FinanceService::initialize: All data loaded from repository successfully (or no data to load).");
                 }
 
-                // 第二步：創建並啟動 Redis worker (它依賴於已初始化的 repository)
-                LOG_F(INFO, "FinanceService::initialize: Creating and starting RedisWorker...");
-                redis_worker_ = std::make_unique<RedisWorker>(repository_);
-                redis_worker_->start();
-                LOG_F(INFO, "FinanceService::initialize: RedisWorker started.");
+                // 設定股票清單時，預先建立所有快取項目 (需在 loadAll() 之後，保留已載入的值)
+                const auto &universeFile = infrastructure::config::ConnectionConfigProvider::stockUniverseFile();
+                if (!universeFile.empty())
+                {
+                    auto universe = infrastructure::config::StockUniverse::loadFromFile(universeFile);
+                    if (!universe)
+                        return Result<void, ErrorResult>::Err(
+                            ErrorResult{ErrorCode::InternalError, "Cannot load stock universe file: " + universeFile});
+                    if (redis_adapter)
+                        redis_adapter->preallocate(*universe);
+                    else
+                        LOG_F(WARNING, "FinanceService::initialize: Repository is not a RedisSummaryAdapter, stock universe ignored.");
+                }
+
+                // 第二步：創建並啟動 Redis worker pool (它依賴於已初始化的 repository)
+                LOG_F(INFO, "FinanceService::initialize: Creating and starting RedisWorkerPool...");
+                infrastructure::tasks::WriteBehindBuffer::Options flushOptions;
+                flushOptions.flushInterval = std::chrono::milliseconds(infrastructure::config::ConnectionConfigProvider::redisFlushIntervalMs());
+                flushOptions.maxBatchSize = infrastructure::config::ConnectionConfigProvider::redisFlushBatchSize();
+                flushOptions.idleFlush = std::chrono::microseconds(infrastructure::config::ConnectionConfigProvider::redisIdleFlushUs());
+                redis_workers_ = std::make_unique<RedisWorkerPool>(
+                    repository_, infrastructure::config::ConnectionConfigProvider::redisWorkerCount(), flushOptions);
+                redis_workers_->start();
+                LOG_F(INFO, "FinanceService::initialize: RedisWorkerPool started with %zu workers.", redis_workers_->size());
 
                 // 設定 Task Submitter 給 RedisAdapter
                 LOG_F(INFO, "FinanceService::initialize: Setting up task submitter for RedisAdapter...");
@@ -91,10 +141,12 @@ namespace finance::application
                     return this->submitRedisTask(std::move(task));
                 };
 
-                auto redis_adapter = std::dynamic_pointer_cast<infrastructure::storage::RedisSummaryAdapter>(repository_);
                 if (redis_adapter)
                 {
                     redis_adapter->setTaskSubmitter(submitter);
+                    // handler 熱路徑不需要結果，直接投遞到 worker pool (不配置 promise)
+                    redis_adapter->setTaskPoster([this](RedisTask task)
+                                                 { this->postRedisTask(std::move(task)); });
                     LOG_F(INFO, "FinanceService::initialize: Task submitter set for RedisAdapter.");
                 }
                 else
@@ -102,9 +154,42 @@ namespace finance::application
                     LOG_F(WARNING, "FinanceService::initialize: Repository is not a RedisSummaryAdapter, cannot set task submitter directly.");
                 }
 
+                // 設定封包日誌時，先以日誌中快取檔 checkpoint 之後的封包補上快取，再開啟日誌接續記錄
+                const auto &journalDir = infrastructure::config::ConnectionConfigProvider::journalDir();
+                if (!journalDir.empty())
+                {
+                    const uint64_t checkpointed = redis_adapter ? redis_adapter->checkpointedLsn() : 0;
+                    if (restored > 0)
+                        replayJournal(journalDir, checkpointed + 1);
+                    infrastructure::storage::PacketJournal::Options journalOptions;
+                    journalOptions.commitInterval = std::chrono::microseconds(infrastructure::config::ConnectionConfigProvider::journalCommitIntervalUs());
+                    journalOptions.segmentBytes = infrastructure::config::ConnectionConfigProvider::journalSegmentBytes();
+                    journal_ = infrastructure::storage::PacketJournal::open(journalDir, journalOptions, checkpointed + 1);
+                    if (!journal_)
+                        return Result<void, ErrorResult>::Err(
+                            ErrorResult{ErrorCode::InternalError, "Cannot open packet journal: " + journalDir});
+                    if (cacheFile.empty())
+                        LOG_F(WARNING, "FinanceService::initialize: journal_dir without summary_cache_file, the journal is not replayed on restart.");
+                    LOG_F(INFO, "FinanceService::initialize: Packet journal opened at %s, next LSN %llu (crc32c: %s).",
+                          journalDir.c_str(), static_cast<unsigned long long>(journal_->lastLsn() + 1),
+                          utils::Crc32c::isaName());
+                }
+
+                // 由快取檔還原時，Redis 對帳在背景進行，不延遲開始收封包
+                if (restored > 0)
+                {
+                    reconcile_thread_ = std::thread([redis_adapter]
+                                                    {
+                                                        auto res = redis_adapter->reconcile();
+                                                        if (res.is_err())
+                                                            LOG_F(ERROR, "FinanceService: Redis reconcile failed: %s", res.unwrap_err().message.c_str()); });
+                }
+
                 // 第三步：創建 TCP 服務適配器
                 LOG_F(INFO, "FinanceService::initialize: Creating TcpServiceAdapter...");
                 tcp_adapter_ = std::make_shared<infrastructure::network::TcpServiceAdapter>(processor_, repository_);
+                if (journal_)
+                    tcp_adapter_->setJournal(journal_);
                 LOG_F(INFO, "FinanceService::initialize: TcpServiceAdapter created.");
 
                 LOG_F(INFO, "FinanceService::initialize: Initialization complete.");
@@ -134,6 +219,8 @@ namespace finance::application
                     return Result<void, ErrorResult>::Err(
                         ErrorResult{ErrorCode::InternalError, "Failed to start TCP adapter"});
                 }
+                if (journal_ && !checkpoint_thread_.joinable())
+                    checkpoint_thread_ = std::thread(&FinanceService::checkpointLoop, this);
                 return Result<void, ErrorResult>::Ok();
             }
             catch (const std::exception &e)
@@ -154,14 +241,32 @@ namespace finance::application
 
         std::future<Result<void, ErrorResult>> submitRedisTask(RedisTask task)
         {
-            if (!redis_worker_)
+            if (!redis_workers_)
             {
                 std::promise<Result<void, ErrorResult>> promise;
                 promise.set_value(Result<void, ErrorResult>::Err(
                     ErrorResult{ErrorCode::InternalError, "Redis worker not initialized"}));
                 return promise.get_future();
             }
-            return redis_worker_->submit_task(std::move(task));
+            return redis_workers_->submit_task(std::move(task));
+        }
+
+        // 不需要結果的任務；worker 尚未初始化時丟棄並記錄
+        void postRedisTask(RedisTask task)
+        {
+            if (!redis_workers_)
+            {
+                LOG_F(ERROR, "FinanceService::postRedisTask: Redis worker not initialized, task for key '%s' dropped",
+                      task.resolveKey().c_str());
+                return;
+            }
+            redis_workers_->post(std::move(task));
+        }
+
+        // 各 Redis worker 目前待寫的筆數
+        std::vector<size_t> redisQueueDepths() const
+        {
+            return redis_workers_ ? redis_workers_->queueDepths() : std::vector<size_t>{};
         }
 
         std::shared_ptr<finance::domain::IFinanceRepository<SummaryData, ErrorResult>> getRepository() const
@@ -170,10 +275,52 @@ namespace finance::application
         }
 
     private:
-        std::unique_ptr<RedisWorker> redis_worker_;
+        /// 依序將日誌中 fromLsn 之後的封包交給 handler (快取檔還原後、開始收封包前呼叫)
+        void replayJournal(const std::string &dir, uint64_t fromLsn)
+        {
+            LOG_F(INFO, "FinanceService::initialize: Replaying packet journal from LSN %llu...",
+                  static_cast<unsigned long long>(fromLsn));
+            size_t failed = 0;
+            auto stats = infrastructure::storage::PacketJournal::replay(
+                dir, fromLsn, [&](const infrastructure::storage::PacketJournal::RecordHeader &record, const char *data)
+                {
+                    // 與 TcpServiceAdapter 相同以 FinancePackageMessage 解讀，不足的部分補空白
+                    domain::FinancePackageMessage pkg;
+                    std::memset(&pkg, ' ', sizeof(pkg));
+                    std::memcpy(&pkg, data, std::min<size_t>(record.length, sizeof(pkg)));
+                    failed += processor_->handle(pkg).is_err(); });
+            LOG_F(INFO, "FinanceService::initialize: Replayed %zu journal records (%zu failed), last LSN %llu.",
+                  stats.records, failed, static_cast<unsigned long long>(stats.lastLsn));
+        }
+
+        /// 定期將已套用的 LSN 水位寫入快取檔，並刪除水位之前的日誌段
+        void checkpointLoop()
+        {
+            auto redis_adapter = std::dynamic_pointer_cast<infrastructure::storage::RedisSummaryAdapter>(repository_);
+            const auto interval = std::chrono::milliseconds(infrastructure::config::ConnectionConfigProvider::journalCheckpointIntervalMs());
+            std::unique_lock<std::mutex> lock(checkpoint_mutex_);
+            while (!checkpoint_cv_.wait_for(lock, interval, [this]
+                                            { return checkpoint_stop_; }))
+            {
+                const uint64_t applied = tcp_adapter_->appliedLsnWatermark();
+                if (!redis_adapter || !redis_adapter->checkpoint(applied))
+                    continue; // 沒有快取檔可 checkpoint 時保留日誌
+                size_t removed = journal_->truncateBefore(applied);
+                DLOG_F(INFO, "FinanceService: checkpoint at LSN %llu, removed %zu journal segments.",
+                       static_cast<unsigned long long>(applied), removed);
+            }
+        }
+
+        std::unique_ptr<RedisWorkerPool> redis_workers_;
         std::shared_ptr<finance::domain::IFinanceRepository<SummaryData, ErrorResult>> repository_;
         std::shared_ptr<finance::domain::IPackageHandler> processor_;
         std::shared_ptr<infrastructure::network::TcpServiceAdapter> tcp_adapter_;
+        std::thread reconcile_thread_; // 快取檔還原後與 Redis 對帳
+        std::shared_ptr<infrastructure::storage::PacketJournal> journal_; // journal_dir 設定時啟用
+        std::thread checkpoint_thread_;
+        std::mutex checkpoint_mutex_;
+        std::condition_variable checkpoint_cv_;
+        bool checkpoint_stop_ = false;
     };
 
     static FinanceService *g_service = nullptr;
@@ -0,0 +1,253 @@
+#pragma once
+
+#include "FinanceDataStructure.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace finance::domain
+{
+
+    /**
+     * 可用數量計算的欄式 (struct-of-arrays) 存放：每個 HCRTM01 / HCRTM05P 原始欄位與八個可用數量各一個連續的 int64 陣列，
+     * 以緊密的 entry id (0 ~ size()-1) 為索引。recalculateAll() 以單一迴圈重算所有 entry，
+     * 結果與逐筆呼叫 SummaryData::calculate_availables() 相同 (int64 加減，溢位時同樣環繞)。
+     * 所有欄位存放於同一塊記憶體，依欄位連續排列；每個欄位長度補齊為 LANES 的倍數，補齊部分的輸入恆為 0，核心迴圈不需處理尾段。
+     * 編譯時有 AVX2 則一次處理 4 筆，否則退回逐筆迴圈 (欄位指標不重疊，編譯器可自動向量化)。
+     */
+    class AvailabilityColumns
+    {
+    public:
+        static constexpr size_t LANES = 4;
+
+        /// 原始輸入欄位
+        enum Input : size_t
+        {
+            MarginAmount,
+            MarginBuyOrderAmount,
+            MarginSellMatchAmount,
+            MarginQty,
+            MarginBuyOrderQty,
+            MarginSellMatchQty,
+            ShortAmount,
+            ShortSellOrderAmount,
+            ShortQty,
+            ShortSellOrderQty,
+            ShortAfterHourSellOrderAmount,
+            ShortAfterHourSellOrderQty,
+            ShortSellMatchAmount,
+            ShortSellMatchQty,
+            MarginAfterHourBuyOrderAmount,
+            MarginAfterHourBuyOrderQty,
+            MarginBuyMatchAmount,
+            MarginBuyMatchQty,
+            MarginBuyOffsetQty, // HCRTM05P
+            ShortSellOffsetQty, // HCRTM05P
+            INPUT_COUNT
+        };
+
+        /// 計算結果欄位
+        enum Output : size_t
+        {
+            MarginAvailableAmount,
+            MarginAvailableQty,
+            ShortAvailableAmount,
+            ShortAvailableQty,
+            AfterMarginAvailableAmount,
+            AfterMarginAvailableQty,
+            AfterShortAvailableAmount,
+            AfterShortAvailableQty,
+            OUTPUT_COUNT
+        };
+
+        /// 目前編譯使用的指令集，用於日誌
+        static constexpr const char *isaName() noexcept
+        {
+#if defined(__AVX2__)
+            return "AVX2";
+#else
+            return "scalar";
+#endif
+        }
+
+        /// 是否帶有任何原始輸入；全為 0 的 entry (例如只由 Redis 載入可用數量) 重算結果也全為 0
+        static bool hasRawInputs(const SummaryData &d) noexcept
+        {
+            return (d.h01_margin_amount | d.h01_margin_buy_order_amount | d.h01_margin_sell_match_amount |
+                    d.h01_margin_qty | d.h01_margin_buy_order_qty | d.h01_margin_sell_match_qty |
+                    d.h01_short_amount | d.h01_short_sell_order_amount | d.h01_short_qty | d.h01_short_sell_order_qty |
+                    d.h01_short_after_hour_sell_order_amount | d.h01_short_after_hour_sell_order_qty |
+                    d.h01_short_sell_match_amount | d.h01_short_sell_match_qty |
+                    d.h01_margin_after_hour_buy_order_amount | d.h01_margin_after_hour_buy_order_qty |
+                    d.h01_margin_buy_match_amount | d.h01_margin_buy_match_qty |
+                    d.h05p_margin_buy_offset_qty | d.h05p_short_sell_offset_qty) != 0;
+        }
+
+        /// 設定 entry 數量；既有內容不保留 (已配置的容量會重複使用)，呼叫後需以 load() 填入每一筆
+        void resize(size_t count)
+        {
+            size_ = count;
+            stride_ = (count + LANES - 1) / LANES * LANES;
+            const size_t needed = stride_ * (INPUT_COUNT + OUTPUT_COUNT);
+            if (data_.size() < needed)
+                data_.resize(needed);
+            // 補齊部分歸零，核心可整塊處理
+            for (size_t c = 0; c < INPUT_COUNT; ++c)
+                for (size_t i = count; i < stride_; ++i)
+                    data_[c * stride_ + i] = 0;
+        }
+
+        size_t size() const noexcept { return size_; }
+
+        /// 由 SummaryData 的原始欄位填入第 id 筆
+        void load(size_t id, const SummaryData &d) noexcept
+        {
+            column(MarginAmount)[id] = d.h01_margin_amount;
+            column(MarginBuyOrderAmount)[id] = d.h01_margin_buy_order_amount;
+            column(MarginSellMatchAmount)[id] = d.h01_margin_sell_match_amount;
+            column(MarginQty)[id] = d.h01_margin_qty;
+            column(MarginBuyOrderQty)[id] = d.h01_margin_buy_order_qty;
+            column(MarginSellMatchQty)[id] = d.h01_margin_sell_match_qty;
+            column(ShortAmount)[id] = d.h01_short_amount;
+            column(ShortSellOrderAmount)[id] = d.h01_short_sell_order_amount;
+            column(ShortQty)[id] = d.h01_short_qty;
+            column(ShortSellOrderQty)[id] = d.h01_short_sell_order_qty;
+            column(ShortAfterHourSellOrderAmount)[id] = d.h01_short_after_hour_sell_order_amount;
+            column(ShortAfterHourSellOrderQty)[id] = d.h01_short_after_hour_sell_order_qty;
+            column(ShortSellMatchAmount)[id] = d.h01_short_sell_match_amount;
+            column(ShortSellMatchQty)[id] = d.h01_short_sell_match_qty;
+            column(MarginAfterHourBuyOrderAmount)[id] = d.h01_margin_after_hour_buy_order_amount;
+            column(MarginAfterHourBuyOrderQty)[id] = d.h01_margin_after_hour_buy_order_qty;
+            column(MarginBuyMatchAmount)[id] = d.h01_margin_buy_match_amount;
+            column(MarginBuyMatchQty)[id] = d.h01_margin_buy_match_qty;
+            column(MarginBuyOffsetQty)[id] = d.h05p_margin_buy_offset_qty;
+            column(ShortSellOffsetQty)[id] = d.h05p_short_sell_offset_qty;
+        }
+
+        /// 將第 id 筆的計算結果寫回 SummaryData 的可用數量欄位
+        void store(size_t id, SummaryData &d) const noexcept
+        {
+            d.margin_available_amount = column(MarginAvailableAmount)[id];
+            d.margin_available_qty = column(MarginAvailableQty)[id];
+            d.short_available_amount = column(ShortAvailableAmount)[id];
+            d.short_available_qty = column(ShortAvailableQty)[id];
+            d.after_margin_available_amount = column(AfterMarginAvailableAmount)[id];
+            d.after_margin_available_qty = column(AfterMarginAvailableQty)[id];
+            d.after_short_available_amount = column(AfterShortAvailableAmount)[id];
+            d.after_short_available_qty = column(AfterShortAvailableQty)[id];
+        }
+
+        int64_t *input(Input c) noexcept { return data_.data() + c * stride_; }
+        const int64_t *output(Output c) const noexcept { return data_.data() + (INPUT_COUNT + c) * stride_; }
+
+        /// 以 calculate_availables() 的公式重算所有 entry 的八個可用數量
+        void recalculateAll() noexcept
+        {
+            // 以無號運算取得與 int64 加減相同的二補數環繞結果，避免有號溢位的未定義行為
+            const uint64_t *__restrict marginAmount = in(MarginAmount);
+            const uint64_t *__restrict marginBuyOrderAmount = in(MarginBuyOrderAmount);
+            const uint64_t *__restrict marginSellMatchAmount = in(MarginSellMatchAmount);
+            const uint64_t *__restrict marginQty = in(MarginQty);
+            const uint64_t *__restrict marginBuyOrderQty = in(MarginBuyOrderQty);
+            const uint64_t *__restrict marginSellMatchQty = in(MarginSellMatchQty);
+            const uint64_t *__restrict shortAmount = in(ShortAmount);
+            const uint64_t *__restrict shortSellOrderAmount = in(ShortSellOrderAmount);
+            const uint64_t *__restrict shortQty = in(ShortQty);
+            const uint64_t *__restrict shortSellOrderQty = in(ShortSellOrderQty);
+            const uint64_t *__restrict shortAfterHourSellOrderAmount = in(ShortAfterHourSellOrderAmount);
+            const uint64_t *__restrict shortAfterHourSellOrderQty = in(ShortAfterHourSellOrderQty);
+            const uint64_t *__restrict shortSellMatchAmount = in(ShortSellMatchAmount);
+            const uint64_t *__restrict marginAfterHourBuyOrderAmount = in(MarginAfterHourBuyOrderAmount);
+            const uint64_t *__restrict marginAfterHourBuyOrderQty = in(MarginAfterHourBuyOrderQty);
+            const uint64_t *__restrict marginBuyMatchAmount = in(MarginBuyMatchAmount);
+            const uint64_t *__restrict marginBuyMatchQty = in(MarginBuyMatchQty);
+            const uint64_t *__restrict buyOffsetQty = in(MarginBuyOffsetQty);
+            const uint64_t *__restrict sellOffsetQty = in(ShortSellOffsetQty);
+
+            uint64_t *__restrict marginAvailableAmount = out(MarginAvailableAmount);
+            uint64_t *__restrict marginAvailableQty = out(MarginAvailableQty);
+            uint64_t *__restrict shortAvailableAmount = out(ShortAvailableAmount);
+            uint64_t *__restrict shortAvailableQty = out(ShortAvailableQty);
+            uint64_t *__restrict afterMarginAvailableAmount = out(AfterMarginAvailableAmount);
+            uint64_t *__restrict afterMarginAvailableQty = out(AfterMarginAvailableQty);
+            uint64_t *__restrict afterShortAvailableAmount = out(AfterShortAvailableAmount);
+            uint64_t *__restrict afterShortAvailableQty = out(AfterShortAvailableQty);
+
+            size_t i = 0;
+#if defined(__AVX2__)
+            auto ld = [](const uint64_t *p)
+            { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); };
+            auto st = [](uint64_t *p, __m256i v)
+            { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); };
+            for (; i < stride_; i += LANES)
+            {
+                const __m256i mAmount = ld(marginAmount + i);
+                const __m256i mQty = ld(marginQty + i);
+                const __m256i sAmount = ld(shortAmount + i);
+                const __m256i sQty = ld(shortQty + i);
+                const __m256i mSellMatchAmount = ld(marginSellMatchAmount + i);
+                const __m256i mSellMatchQty = ld(marginSellMatchQty + i);
+                const __m256i sSellOrderQty = ld(shortSellOrderQty + i);
+                const __m256i buyOffset = ld(buyOffsetQty + i);
+                const __m256i sellOffset = ld(sellOffsetQty + i);
+
+                st(marginAvailableAmount + i,
+                   _mm256_add_epi64(_mm256_sub_epi64(mAmount, ld(marginBuyOrderAmount + i)), mSellMatchAmount));
+                st(marginAvailableQty + i,
+                   _mm256_add_epi64(_mm256_add_epi64(_mm256_sub_epi64(mQty, ld(marginBuyOrderQty + i)), mSellMatchQty), buyOffset));
+                st(shortAvailableAmount + i,
+                   _mm256_sub_epi64(sAmount, ld(shortSellOrderAmount + i)));
+                st(shortAvailableQty + i,
+                   _mm256_add_epi64(_mm256_sub_epi64(sQty, sSellOrderQty), sellOffset));
+                st(afterMarginAvailableAmount + i,
+                   _mm256_sub_epi64(_mm256_add_epi64(_mm256_sub_epi64(mAmount, ld(marginBuyMatchAmount + i)), mSellMatchAmount),
+                                    ld(marginAfterHourBuyOrderAmount + i)));
+                st(afterMarginAvailableQty + i,
+                   _mm256_add_epi64(_mm256_sub_epi64(_mm256_add_epi64(_mm256_sub_epi64(mQty, ld(marginBuyMatchQty + i)), mSellMatchQty),
+                                                     ld(marginAfterHourBuyOrderQty + i)),
+                                    buyOffset));
+                st(afterShortAvailableAmount + i,
+                   _mm256_sub_epi64(_mm256_sub_epi64(sAmount, ld(shortSellMatchAmount + i)), ld(shortAfterHourSellOrderAmount + i)));
+                st(afterShortAvailableQty + i,
+                   _mm256_add_epi64(_mm256_sub_epi64(_mm256_sub_epi64(sQty, sSellOrderQty), ld(shortAfterHourSellOrderQty + i)),
+                                    sellOffset));
+            }
+#endif
+            for (; i < stride_; ++i)
+            {
+                marginAvailableAmount[i] = marginAmount[i] - marginBuyOrderAmount[i] + marginSellMatchAmount[i];
+                marginAvailableQty[i] = marginQty[i] - marginBuyOrderQty[i] + marginSellMatchQty[i] + buyOffsetQty[i];
+                shortAvailableAmount[i] = shortAmount[i] - shortSellOrderAmount[i];
+                shortAvailableQty[i] = shortQty[i] - shortSellOrderQty[i] + sellOffsetQty[i];
+                afterMarginAvailableAmount[i] = marginAmount[i] - marginBuyMatchAmount[i] + marginSellMatchAmount[i] - marginAfterHourBuyOrderAmount[i];
+                afterMarginAvailableQty[i] = marginQty[i] - marginBuyMatchQty[i] + marginSellMatchQty[i] - marginAfterHourBuyOrderQty[i] + buyOffsetQty[i];
+                afterShortAvailableAmount[i] = shortAmount[i] - shortSellMatchAmount[i] - shortAfterHourSellOrderAmount[i];
+                afterShortAvailableQty[i] = shortQty[i] - shortSellOrderQty[i] - shortAfterHourSellOrderQty[i] + sellOffsetQty[i];
+            }
+        }
+
+    private:
+        int64_t *column(Input c) noexcept { return input(c); }
+        const int64_t *column(Output c) const noexcept { return output(c); }
+
+        // int64_t 與 uint64_t 可互相別名存取
+        const uint64_t *in(Input c) const noexcept
+        {
+            return reinterpret_cast<const uint64_t *>(data_.data() + c * stride_);
+        }
+
+        uint64_t *out(Output c) noexcept
+        {
+            return reinterpret_cast<uint64_t *>(data_.data() + (INPUT_COUNT + c) * stride_);
+        }
+
+        size_t size_ = 0;
+        size_t stride_ = 0;         // 每個欄位的長度 (size_ 補齊為 LANES 的倍數)
+        std::vector<int64_t> data_; // 依欄位連續排列：INPUT_COUNT 個輸入欄位後接 OUTPUT_COUNT 個輸出欄位
+    };
+
+} // namespace finance::domain
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace finance::domain
+{
+
+    /**
+     * 指向不可變分公司列表的輕量 handle (一個指標)，取代每筆 SummaryData 各自持有的 std::vector<std::string>。
+     * 列表本身由 AreaBranchProvider 集中保存 (同內容只存一份)，並在程式結束前保持有效；
+     * 複製與指派只複製指標，不配置記憶體。預設值為空列表。
+     */
+    class BranchListRef
+    {
+    public:
+        using List = std::vector<std::string>;
+        using const_iterator = List::const_iterator;
+
+        constexpr BranchListRef() noexcept = default;
+
+        /// 參照既有列表；呼叫端需保證 list 在此 handle 的所有副本使用期間有效
+        constexpr explicit BranchListRef(const List *list) noexcept : list_(list) {}
+
+        const List &get() const noexcept { return list_ ? *list_ : emptyList(); }
+
+        bool empty() const noexcept { return list_ == nullptr || list_->empty(); }
+        size_t size() const noexcept { return list_ ? list_->size() : 0; }
+        const std::string &operator[](size_t i) const noexcept { return (*list_)[i]; }
+        const_iterator begin() const noexcept { return get().begin(); }
+        const_iterator end() const noexcept { return get().end(); }
+
+        /// 內容相同即相等 (同一份列表時不逐一比較)
+        bool operator==(const BranchListRef &o) const noexcept
+        {
+            return list_ == o.list_ || get() == o.get();
+        }
+        bool operator!=(const BranchListRef &o) const noexcept { return !(*this == o); }
+
+    private:
+        static const List &emptyList() noexcept
+        {
+            static const List empty;
+            return empty;
+        }
+
+        const List *list_ = nullptr;
+    };
+
+} // namespace finance::domain
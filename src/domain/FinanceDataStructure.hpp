@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include "BranchListRef.hpp"
 
 namespace finance::domain
 {
@@ -25,7 +26,7 @@ namespace finance::domain
 
         std::string stock_id;
         std::string area_center;
-        std::vector<std::string> belong_branches;
+        BranchListRef belong_branches; // 由 AreaBranchProvider 保存的共用列表
 
         // --- 新增：儲存從 ELD001 (HCRTM01) 收到的關鍵原始數據 ---
         // 您需要根據 ELD001 的定義，選擇用於計算可用數量的所有相關欄位
@@ -3,7 +3,9 @@
 #include <string>
 #include <vector>
 #include <future>
+#include <utility>
 #include "FinanceDataStructure.hpp"
+#include "SummaryKey.hpp"
 #include "Result.hpp"
 
 namespace finance::domain
@@ -39,6 +41,17 @@ namespace finance::domain
          */
         virtual Result<T *, E> getData(const std::string &key) = 0;
 
+        /**
+         * @brief 以壓縮鍵獲取數據實體
+         * @details 預設轉成 "summary:AREA:STOCK" 字串後呼叫 getData(key)；儲存庫可覆寫以免產生字串。
+         * @param key (區中心, 股票代號) 壓縮鍵
+         * @return 指向數據實體的指標
+         */
+        virtual Result<T *, E> getData(const SummaryKey &key)
+        {
+            return getData(key.redisKey());
+        }
+
         /**
          * @brief 儲存數據實體
          * @param key 鍵值，用於標識數據實體
@@ -63,6 +76,29 @@ namespace finance::domain
          */
         virtual Result<void, E> sync(const std::string &key, const T *data) = 0;
 
+        /**
+         * @brief 批次同步數據到 Redis
+         * @details 預設逐筆呼叫 sync() 與 update()；儲存庫可覆寫為單次往返 (例如 pipeline)。
+         *          先套用所有 syncs，再計算 updates，讓彙總看到同一批的最新數據。
+         * @param syncs 要同步的 (鍵值, 數據) 列表
+         * @param updates 要更新的鍵值列表
+         * @param lane 呼叫端的寫入通道編號 (每個寫入執行緒固定一個)，儲存庫可據此使用專屬連線
+         * @return 依序對應 syncs 後接 updates 的結果
+         */
+        virtual std::vector<Result<void, E>> syncBatch(const std::vector<std::pair<std::string, const T *>> &syncs,
+                                                       const std::vector<std::string> &updates,
+                                                       size_t lane)
+        {
+            (void)lane;
+            std::vector<Result<void, E>> results;
+            results.reserve(syncs.size() + updates.size());
+            for (const auto &[key, data] : syncs)
+                results.push_back(sync(key, data));
+            for (const auto &key : updates)
+                results.push_back(update(key));
+            return results;
+        }
+
         /**
          * @brief 刪除數據實體
          * @param key 鍵值，用於標識要刪除的數據實體
@@ -84,6 +120,27 @@ namespace finance::domain
          * @return 異步操作結果的 future
          */
         virtual std::future<Result<void, E>> update_async(const std::string &key) = 0;
+
+        /**
+         * @brief 不需要結果的異步同步 (handler 熱路徑使用)
+         * @details 預設轉成字串 key 後呼叫 sync_async() 並忽略 future；儲存庫可覆寫為不配置記憶體的版本。
+         * @param key (區中心, 股票代號) 壓縮鍵
+         * @param data 要同步的數據
+         */
+        virtual void sync_detached(const SummaryKey &key, const T &data)
+        {
+            (void)sync_async(key.redisKey(), data);
+        }
+
+        /**
+         * @brief 不需要結果的異步更新 (handler 熱路徑使用)
+         * @details 預設呼叫 update_async(股票代號) 並忽略 future。
+         * @param key 該股票的任一壓縮鍵 (只使用股票代號部分)
+         */
+        virtual void update_detached(const SummaryKey &key)
+        {
+            (void)update_async(key.stock());
+        }
     };
 
 } // namespace finance::domain
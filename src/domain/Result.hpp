@@ -32,7 +32,8 @@ namespace finance::domain
         UnexpectedError,            // 未知錯誤
         BackOfficeIntParseError,    // BackOffice 數字解析錯誤
         BackOfficeStringParseError, // BackOffice 字串解析錯誤
-        GetDataNull                 // Null ptr
+        GetDataNull,                // Null ptr
+        UnknownStock                // 股票不在 stock universe 清單內
     };
 
     /**
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace finance::domain
+{
+
+    /**
+     * (區中心, 股票代號) 壓縮成的 64 位元鍵，取代 "summary:AREA:STOCK" 字串作為快取索引。
+     * 每個字元佔 7 位元 (ASCII 1~127)：bit 0~41 為股票代號 (最多 6 字)，bit 42~62 為區中心 (最多 3 字)，
+     * 0 表示字串結束；bit 63 恆為 0。長度與封包欄位一致 (area_center[3] / stock_id[6])。
+     * Redis key 只在實際 I/O 時由 redisKey() 產生。
+     */
+    class SummaryKey
+    {
+    public:
+        static constexpr size_t MAX_AREA_LENGTH = 3;
+        static constexpr size_t MAX_STOCK_LENGTH = 6;
+        static constexpr std::string_view REDIS_PREFIX = "summary:";
+
+        constexpr SummaryKey() noexcept = default;
+
+        /**
+         * 由區中心與股票代號建立 (右側空白會被忽略，可直接傳入封包的定長欄位)。
+         * 任一為空、超過長度、含非 ASCII 或 NUL 字元，或區中心含 ':' 時回傳 std::nullopt。
+         */
+        static std::optional<SummaryKey> make(std::string_view area, std::string_view stock) noexcept
+        {
+            area = trimRight(area);
+            stock = trimRight(stock);
+            if (area.empty() || area.size() > MAX_AREA_LENGTH || stock.empty() || stock.size() > MAX_STOCK_LENGTH)
+                return std::nullopt;
+            if (area.find(':') != std::string_view::npos)
+                return std::nullopt;
+
+            uint64_t packed = 0;
+            if (!packChars(stock, 0, packed) || !packChars(area, STOCK_BITS, packed))
+                return std::nullopt;
+            return SummaryKey(packed);
+        }
+
+        /// 解析 "summary:AREA:STOCK"；格式不符或無法壓縮時回傳 std::nullopt
+        static std::optional<SummaryKey> parse(std::string_view redisKey) noexcept
+        {
+            if (redisKey.substr(0, REDIS_PREFIX.size()) != REDIS_PREFIX)
+                return std::nullopt;
+            redisKey.remove_prefix(REDIS_PREFIX.size());
+            auto sep = redisKey.find(':');
+            if (sep == std::string_view::npos)
+                return std::nullopt;
+            auto area = redisKey.substr(0, sep);
+            auto stock = redisKey.substr(sep + 1);
+            // 帶有右側空白的 key 無法由 redisKey() 還原，視為不可壓縮
+            if (trimRight(area).size() != area.size() || trimRight(stock).size() != stock.size())
+                return std::nullopt;
+            return make(area, stock);
+        }
+
+        /// 區中心單獨壓縮後的位元 (與 make(area, 任意股票).areaBits() 相同)；無法壓縮時回傳 std::nullopt
+        static std::optional<uint64_t> areaBitsOf(std::string_view area) noexcept
+        {
+            auto key = make(area, "0");
+            return key ? std::optional<uint64_t>(key->areaBits()) : std::nullopt;
+        }
+
+        /// 股票代號單獨壓縮後的位元 (與 make(任意區中心, stock).stockBits() 相同)；無法壓縮時回傳 std::nullopt
+        static std::optional<uint64_t> stockBitsOf(std::string_view stock) noexcept
+        {
+            auto key = make("0", stock);
+            return key ? std::optional<uint64_t>(key->stockBits()) : std::nullopt;
+        }
+
+        /**
+         * 股票所屬的分片 (0 ~ shards-1)，只看股票代號部分：同一檔股票的所有區中心 (含 ALL) 落在同一分片。
+         * 分片處理管線、快取分區與 Redis 寫入通道共用此函式，同一檔股票因此永遠由同一組 thread 處理。
+         */
+        static constexpr size_t shardOf(uint64_t stockBits, size_t shards) noexcept
+        {
+            return static_cast<size_t>((stockBits * 0x9E3779B97F4A7C15ULL) >> 32) % shards;
+        }
+
+        constexpr size_t shard(size_t shards) const noexcept { return shardOf(stockBits(), shards); }
+
+        /// 還原 packed() 的值 (呼叫端需保證來自合法的 SummaryKey，例如索引中儲存的鍵)
+        static constexpr SummaryKey fromPacked(uint64_t packed) noexcept { return SummaryKey(packed); }
+
+        constexpr uint64_t packed() const noexcept { return packed_; }
+
+        /// 只含股票代號的部分 (同一檔股票的所有區中心相同)
+        constexpr uint64_t stockBits() const noexcept { return packed_ & STOCK_MASK; }
+
+        /// 只含區中心的部分 (同一區中心的所有股票相同)
+        constexpr uint64_t areaBits() const noexcept { return packed_ & ~STOCK_MASK; }
+
+        std::string area() const { return unpack(packed_ >> STOCK_BITS, MAX_AREA_LENGTH); }
+        std::string stock() const { return unpack(packed_, MAX_STOCK_LENGTH); }
+
+        /// 產生 Redis key "summary:AREA:STOCK"
+        std::string redisKey() const
+        {
+            std::string key;
+            key.reserve(REDIS_PREFIX.size() + MAX_AREA_LENGTH + 1 + MAX_STOCK_LENGTH);
+            key.append(REDIS_PREFIX);
+            key += area();
+            key.push_back(':');
+            key += stock();
+            return key;
+        }
+
+        constexpr bool operator==(const SummaryKey &o) const noexcept { return packed_ == o.packed_; }
+        constexpr bool operator!=(const SummaryKey &o) const noexcept { return packed_ != o.packed_; }
+
+    private:
+        static constexpr unsigned CHAR_BITS = 7;
+        static constexpr unsigned STOCK_BITS = CHAR_BITS * MAX_STOCK_LENGTH;
+        static constexpr uint64_t STOCK_MASK = (uint64_t{1} << STOCK_BITS) - 1;
+
+        constexpr explicit SummaryKey(uint64_t packed) noexcept : packed_(packed) {}
+
+        static std::string_view trimRight(std::string_view s) noexcept
+        {
+            // 與 FinanceUtils::trim_right 相同的空白定義
+            while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back())))
+                s.remove_suffix(1);
+            return s;
+        }
+
+        static bool packChars(std::string_view s, unsigned shift, uint64_t &packed) noexcept
+        {
+            for (size_t i = 0; i < s.size(); ++i)
+            {
+                auto c = static_cast<unsigned char>(s[i]);
+                if (c == 0 || c > 0x7F)
+                    return false;
+                packed |= static_cast<uint64_t>(c) << (shift + CHAR_BITS * i);
+            }
+            return true;
+        }
+
+        static std::string unpack(uint64_t bits, size_t maxLength)
+        {
+            std::string s;
+            for (size_t i = 0; i < maxLength; ++i)
+            {
+                char c = static_cast<char>((bits >> (CHAR_BITS * i)) & 0x7F);
+                if (c == 0)
+                    break;
+                s.push_back(c);
+            }
+            return s;
+        }
+
+        uint64_t packed_ = 0;
+    };
+
+} // namespace finance::domain
+
+namespace std
+{
+    template <>
+    struct hash<finance::domain::SummaryKey>
+    {
+        size_t operator()(const finance::domain::SummaryKey &key) const noexcept
+        {
+            return hash<uint64_t>{}(key.packed());
+        }
+    };
+} // namespace std
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "domain/FinanceDataStructure.hpp"
+#include "domain/SummaryKey.hpp"
+#include "domain/BranchListRef.hpp"
+#include <cstdint>
+#include <type_traits>
+
+namespace finance::domain
+{
+
+    /**
+     * SummaryData 的可平凡複製快照，供讀者以 seqlock 無鎖讀取。
+     * 字串欄位 (stock_id / area_center) 由 key 還原，分公司列表只複製共用列表的 handle。
+     * key 為 0 表示該位置尚未發佈資料。
+     */
+    struct SummarySnapshot
+    {
+        uint64_t key = 0; // SummaryKey::packed()
+        BranchListRef belong_branches;
+
+        int64_t margin_available_amount = 0;
+        int64_t margin_available_qty = 0;
+        int64_t short_available_amount = 0;
+        int64_t short_available_qty = 0;
+        int64_t after_margin_available_amount = 0;
+        int64_t after_margin_available_qty = 0;
+        int64_t after_short_available_amount = 0;
+        int64_t after_short_available_qty = 0;
+
+        int64_t h01_margin_amount = 0;
+        int64_t h01_margin_buy_order_amount = 0;
+        int64_t h01_margin_sell_match_amount = 0;
+        int64_t h01_margin_qty = 0;
+        int64_t h01_margin_buy_order_qty = 0;
+        int64_t h01_margin_sell_match_qty = 0;
+        int64_t h01_short_amount = 0;
+        int64_t h01_short_sell_order_amount = 0;
+        int64_t h01_short_qty = 0;
+        int64_t h01_short_sell_order_qty = 0;
+        int64_t h01_short_after_hour_sell_order_amount = 0;
+        int64_t h01_short_after_hour_sell_order_qty = 0;
+        int64_t h01_short_sell_match_amount = 0;
+        int64_t h01_short_sell_match_qty = 0;
+        int64_t h01_margin_after_hour_buy_order_amount = 0;
+        int64_t h01_margin_after_hour_buy_order_qty = 0;
+        int64_t h01_margin_buy_match_amount = 0;
+        int64_t h01_margin_buy_match_qty = 0;
+        int64_t h05p_margin_buy_offset_qty = 0;
+        int64_t h05p_short_sell_offset_qty = 0;
+
+        static SummarySnapshot from(SummaryKey summaryKey, const SummaryData &d) noexcept
+        {
+            SummarySnapshot s;
+            s.key = summaryKey.packed();
+            s.belong_branches = d.belong_branches;
+            s.margin_available_amount = d.margin_available_amount;
+            s.margin_available_qty = d.margin_available_qty;
+            s.short_available_amount = d.short_available_amount;
+            s.short_available_qty = d.short_available_qty;
+            s.after_margin_available_amount = d.after_margin_available_amount;
+            s.after_margin_available_qty = d.after_margin_available_qty;
+            s.after_short_available_amount = d.after_short_available_amount;
+            s.after_short_available_qty = d.after_short_available_qty;
+            s.h01_margin_amount = d.h01_margin_amount;
+            s.h01_margin_buy_order_amount = d.h01_margin_buy_order_amount;
+            s.h01_margin_sell_match_amount = d.h01_margin_sell_match_amount;
+            s.h01_margin_qty = d.h01_margin_qty;
+            s.h01_margin_buy_order_qty = d.h01_margin_buy_order_qty;
+            s.h01_margin_sell_match_qty = d.h01_margin_sell_match_qty;
+            s.h01_short_amount = d.h01_short_amount;
+            s.h01_short_sell_order_amount = d.h01_short_sell_order_amount;
+            s.h01_short_qty = d.h01_short_qty;
+            s.h01_short_sell_order_qty = d.h01_short_sell_order_qty;
+            s.h01_short_after_hour_sell_order_amount = d.h01_short_after_hour_sell_order_amount;
+            s.h01_short_after_hour_sell_order_qty = d.h01_short_after_hour_sell_order_qty;
+            s.h01_short_sell_match_amount = d.h01_short_sell_match_amount;
+            s.h01_short_sell_match_qty = d.h01_short_sell_match_qty;
+            s.h01_margin_after_hour_buy_order_amount = d.h01_margin_after_hour_buy_order_amount;
+            s.h01_margin_after_hour_buy_order_qty = d.h01_margin_after_hour_buy_order_qty;
+            s.h01_margin_buy_match_amount = d.h01_margin_buy_match_amount;
+            s.h01_margin_buy_match_qty = d.h01_margin_buy_match_qty;
+            s.h05p_margin_buy_offset_qty = d.h05p_margin_buy_offset_qty;
+            s.h05p_short_sell_offset_qty = d.h05p_short_sell_offset_qty;
+            return s;
+        }
+
+        /// 還原為 SummaryData (會配置字串，只在讀者端使用)
+        SummaryData toSummaryData() const
+        {
+            SummaryData d;
+            const auto summaryKey = SummaryKey::fromPacked(key);
+            d.stock_id = summaryKey.stock();
+            d.area_center = summaryKey.area();
+            d.belong_branches = belong_branches;
+            d.margin_available_amount = margin_available_amount;
+            d.margin_available_qty = margin_available_qty;
+            d.short_available_amount = short_available_amount;
+            d.short_available_qty = short_available_qty;
+            d.after_margin_available_amount = after_margin_available_amount;
+            d.after_margin_available_qty = after_margin_available_qty;
+            d.after_short_available_amount = after_short_available_amount;
+            d.after_short_available_qty = after_short_available_qty;
+            d.h01_margin_amount = h01_margin_amount;
+            d.h01_margin_buy_order_amount = h01_margin_buy_order_amount;
+            d.h01_margin_sell_match_amount = h01_margin_sell_match_amount;
+            d.h01_margin_qty = h01_margin_qty;
+            d.h01_margin_buy_order_qty = h01_margin_buy_order_qty;
+            d.h01_margin_sell_match_qty = h01_margin_sell_match_qty;
+            d.h01_short_amount = h01_short_amount;
+            d.h01_short_sell_order_amount = h01_short_sell_order_amount;
+            d.h01_short_qty = h01_short_qty;
+            d.h01_short_sell_order_qty = h01_short_sell_order_qty;
+            d.h01_short_after_hour_sell_order_amount = h01_short_after_hour_sell_order_amount;
+            d.h01_short_after_hour_sell_order_qty = h01_short_after_hour_sell_order_qty;
+            d.h01_short_sell_match_amount = h01_short_sell_match_amount;
+            d.h01_short_sell_match_qty = h01_short_sell_match_qty;
+            d.h01_margin_after_hour_buy_order_amount = h01_margin_after_hour_buy_order_amount;
+            d.h01_margin_after_hour_buy_order_qty = h01_margin_after_hour_buy_order_qty;
+            d.h01_margin_buy_match_amount = h01_margin_buy_match_amount;
+            d.h01_margin_buy_match_qty = h01_margin_buy_match_qty;
+            d.h05p_margin_buy_offset_qty = h05p_margin_buy_offset_qty;
+            d.h05p_short_sell_offset_qty = h05p_short_sell_offset_qty;
+            return d;
+        }
+    };
+
+    static_assert(std::is_trivially_copyable_v<SummarySnapshot>, "SummarySnapshot 需可平凡複製 (seqlock 以字組複製)");
+
+} // namespace finance::domain
@@ -74,7 +74,9 @@ int main(int argc, char *argv[])
         try
         {
             LOG_F(INFO, "Creating Redis adapter...");
-            redisRepo = std::make_shared<infrastructure::storage::RedisSummaryAdapter>();
+            // 快取分區數與 Redis 寫入 worker 數 (亦即分片管線的 shard 數) 相同
+            redisRepo = std::make_shared<infrastructure::storage::RedisSummaryAdapter>(
+                nullptr, infrastructure::config::ConnectionConfigProvider::redisWorkerCount());
             redisRepo->setRedisSearchIndex(initialize_redis_index);
         }
         catch (const std::exception &e)
@@ -11,6 +11,9 @@
 #include <algorithm>
 #include <vector> // 包含 vector
 #include <sstream>
+#include <set>
+#include "domain/BranchListRef.hpp"
+#include "domain/SummaryKey.hpp"
 
 namespace finance::infrastructure::config
 {
@@ -48,7 +51,19 @@ namespace finance::infrastructure::config
                     }
                     // *** 新增：將所有分支 ID 從 set 複製到 vector ***
                     allBranchesVec_.assign(allBranchesSet_.begin(), allBranchesSet_.end());
-                    backofficeIdsVec_.assign(backofficeIdsSet_.begin(), backofficeIdsSet_.end()); });
+                    backofficeIdsVec_.assign(backofficeIdsSet_.begin(), backofficeIdsSet_.end());
+
+                    // 每個區中心與總公司的分公司列表各存一份，SummaryData 只持有 BranchListRef
+                    areaBranchRefs_.clear();
+                    areaBranchRefsByBits_.clear();
+                    for (const auto& [areaId, vec] : areaToBranches_)
+                    {
+                        auto ref = internBranches(vec);
+                        areaBranchRefs_[areaId] = ref;
+                        if (auto bits = domain::SummaryKey::areaBitsOf(areaId))
+                            areaBranchRefsByBits_[*bits] = ref;
+                    }
+                    allBranchesRef_ = internBranches(allBranchesVec_); });
 
                 printAreaToBranches();
 
@@ -72,6 +87,35 @@ namespace finance::infrastructure::config
             return emptyVec;
         }
 
+        /// 區中心的分公司列表 handle；未知的區中心回傳空列表
+        inline static domain::BranchListRef getBranchListFromArea(const std::string &areaId) noexcept
+        {
+            auto it = areaBranchRefs_.find(areaId);
+            return it == areaBranchRefs_.end() ? domain::BranchListRef{} : it->second;
+        }
+
+        /// 以 SummaryKey 的區中心部分查詢分公司列表 (熱路徑用，不產生字串)；未知的區中心回傳空列表
+        inline static domain::BranchListRef getBranchListFromArea(domain::SummaryKey key) noexcept
+        {
+            auto it = areaBranchRefsByBits_.find(key.areaBits());
+            return it == areaBranchRefsByBits_.end() ? domain::BranchListRef{} : it->second;
+        }
+
+        /// 總公司 (ALL) 的分公司列表 handle，內容同 getAllBranches()
+        inline static domain::BranchListRef getAllBranchList() noexcept { return allBranchesRef_; }
+
+        /**
+         * 取得與 branches 內容相同的共用列表 handle (例如由 Redis 載入的資料)；相同內容只保存一份，保存到程式結束。
+         * 可由多執行緒呼叫。
+         */
+        inline static domain::BranchListRef internBranches(const std::vector<std::string> &branches)
+        {
+            if (branches.empty())
+                return domain::BranchListRef{};
+            std::lock_guard<std::mutex> lock(internMutex_);
+            return domain::BranchListRef(&*internedLists_.insert(branches).first);
+        }
+
         inline static void printAreaToBranches()
         {
             std::vector<std::string> sortedKeys;
@@ -113,6 +157,9 @@ namespace finance::infrastructure::config
 
         inline static bool IsValidAreaCenter(const std::string &area) noexcept { return backofficeIdsSet_.count(area) > 0; }
 
+        /// 以 SummaryKey 的區中心部分檢查 (熱路徑用，不產生字串)
+        inline static bool IsValidAreaCenter(domain::SummaryKey key) noexcept { return areaBranchRefsByBits_.count(key.areaBits()) > 0; }
+
     private:
         inline static std::once_flag initFlag_{};
         inline static nlohmann::json jsonData_{};
@@ -122,6 +169,11 @@ namespace finance::infrastructure::config
         inline static std::vector<std::string> allBranchesVec_{};               // *** 新增：儲存所有分支 ID 的 vector ***
         inline static std::unordered_set<std::string> followingBrokerIdsSet_{}; // 改為 unordered_set
         inline static std::unordered_map<std::string, std::vector<std::string>> areaToBranches_{};
+        inline static std::unordered_map<std::string, domain::BranchListRef> areaBranchRefs_{};
+        inline static std::unordered_map<uint64_t, domain::BranchListRef> areaBranchRefsByBits_{}; // SummaryKey::areaBits() -> 列表
+        inline static domain::BranchListRef allBranchesRef_{};
+        inline static std::mutex internMutex_{};
+        inline static std::set<std::vector<std::string>> internedLists_{}; // 節點位址固定，BranchListRef 直接指向元素
     };
 
 } // namespace finance::infrastructure::config
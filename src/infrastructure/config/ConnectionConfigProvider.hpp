@@ -6,6 +6,7 @@
 #include <nlohmann/json.hpp>
 #include <loguru.hpp>
 #include <mutex>
+#include <cstdint>
 
 namespace finance::infrastructure::config
 {
@@ -46,6 +47,41 @@ namespace finance::infrastructure::config
                                    redisPassword_ = jsonData_.at("redis_password").get<std::string>(); // Redis 密碼，可選
                                    serverPort_ = jsonData_.at("server_port").get<int>();               // 服務埠號
                                    socketTimeoutMs_ = jsonData_.at("socket_timeout_ms").get<int>();    // Socket 超時 (ms)
+                                   // 選填欄位：consumer 等待策略
+                                   consumerWaitMode_ = jsonData_.value("consumer_wait_mode", consumerWaitMode_);
+                                   consumerSpinCount_ = jsonData_.value("consumer_spin_count", consumerSpinCount_);
+                                   consumerYieldCount_ = jsonData_.value("consumer_yield_count", consumerYieldCount_);
+                                   consumerParkTimeoutMs_ = jsonData_.value("consumer_park_timeout_ms", consumerParkTimeoutMs_);
+                                   // 選填欄位：積壓超過此位元組數時合併 HCRTM01，0 表示停用
+                                   conflationThresholdBytes_ = jsonData_.value("conflation_threshold_bytes", conflationThresholdBytes_);
+                                   // 選填欄位：封包處理管線 ("split" / "run_to_completion" / "sharded") 與 run-to-completion thread 綁定的 CPU
+                                   pipelineMode_ = jsonData_.value("pipeline_mode", pipelineMode_);
+                                   pipelineCpu_ = jsonData_.value("pipeline_cpu", pipelineCpu_);
+                                   // 選填欄位：Redis write-behind flush 條件
+                                   redisFlushIntervalMs_ = jsonData_.value("redis_flush_interval_ms", redisFlushIntervalMs_);
+                                   redisFlushBatchSize_ = jsonData_.value("redis_flush_batch_size", redisFlushBatchSize_);
+                                   redisIdleFlushUs_ = jsonData_.value("redis_idle_flush_us", redisIdleFlushUs_);
+                                   redisPipelineTransaction_ = jsonData_.value("redis_pipeline_transaction", redisPipelineTransaction_);
+                                   redisWorkerCount_ = jsonData_.value("redis_worker_count", redisWorkerCount_);
+                                   // 選填欄位：Redis 連線池與連線參數，socket 超時未設定時沿用 socket_timeout_ms
+                                   redisPoolSize_ = jsonData_.value("redis_pool_size", redisPoolSize_);
+                                   redisPoolWaitTimeoutMs_ = jsonData_.value("redis_pool_wait_timeout_ms", redisPoolWaitTimeoutMs_);
+                                   redisConnectTimeoutMs_ = jsonData_.value("redis_connect_timeout_ms", redisConnectTimeoutMs_);
+                                   redisSocketTimeoutMs_ = jsonData_.value("redis_socket_timeout_ms", socketTimeoutMs_);
+                                   redisKeepAlive_ = jsonData_.value("redis_keep_alive", redisKeepAlive_);
+                                   redisKeepAliveIntervalS_ = jsonData_.value("redis_keep_alive_interval_s", redisKeepAliveIntervalS_);
+                                   // 選填欄位：除錯用，每次彙總總公司資料時以全量重算交叉檢查
+                                   summaryAggregateCrossCheck_ = jsonData_.value("summary_aggregate_cross_check", summaryAggregateCrossCheck_);
+                                   // 選填欄位：股票清單檔，設定時啟動即預先建立所有快取項目並過濾清單外股票
+                                   stockUniverseFile_ = jsonData_.value("stock_universe_file", stockUniverseFile_);
+                                   // 選填欄位：mmap 快取檔路徑與容量 (筆數)，設定時重啟由檔案還原快取，Redis 只用於對帳
+                                   summaryCacheFile_ = jsonData_.value("summary_cache_file", summaryCacheFile_);
+                                   summaryCacheCapacity_ = jsonData_.value("summary_cache_capacity", summaryCacheCapacity_);
+                                   // 選填欄位：封包日誌目錄與 group commit / 分段 / checkpoint 參數，設定目錄時啟用
+                                   journalDir_ = jsonData_.value("journal_dir", journalDir_);
+                                   journalCommitIntervalUs_ = jsonData_.value("journal_commit_interval_us", journalCommitIntervalUs_);
+                                   journalSegmentBytes_ = jsonData_.value("journal_segment_bytes", journalSegmentBytes_);
+                                   journalCheckpointIntervalMs_ = jsonData_.value("journal_checkpoint_interval_ms", journalCheckpointIntervalMs_);
                                });
                 return true; // 初次或重覆呼叫後皆回傳成功
             }
@@ -81,6 +117,162 @@ namespace finance::infrastructure::config
             return socketTimeoutMs_; // e.g. 5000
         }
 
+        // 純讀：consumer 等待策略 ("busy_spin" / "spin_yield" / "spin_park")
+        inline static const std::string &consumerWaitMode() noexcept
+        {
+            return consumerWaitMode_;
+        }
+
+        // 純讀：consumer 每輪忙等次數
+        inline static uint32_t consumerSpinCount() noexcept
+        {
+            return consumerSpinCount_;
+        }
+
+        // 純讀：consumer 忙等後的 yield 次數
+        inline static uint32_t consumerYieldCount() noexcept
+        {
+            return consumerYieldCount_;
+        }
+
+        // 純讀：consumer 單次休眠上限 (ms)
+        inline static uint32_t consumerParkTimeoutMs() noexcept
+        {
+            return consumerParkTimeoutMs_;
+        }
+
+        // 純讀：HCRTM01 合併門檻 (split 模式 RingBuffer 的積壓位元組數，分片模式依 shard ring 容量換算；0 表示停用)
+        inline static size_t conflationThresholdBytes() noexcept
+        {
+            return conflationThresholdBytes_;
+        }
+
+        // 純讀：封包處理管線 ("split" / "run_to_completion" / "sharded")
+        inline static const std::string &pipelineMode() noexcept
+        {
+            return pipelineMode_;
+        }
+
+        // 純讀：run-to-completion thread 綁定的 CPU，負數表示不綁定
+        inline static int pipelineCpu() noexcept
+        {
+            return pipelineCpu_;
+        }
+
+        // 純讀：write-behind 資料延遲上限 (ms)
+        inline static uint32_t redisFlushIntervalMs() noexcept
+        {
+            return redisFlushIntervalMs_;
+        }
+
+        // 純讀：write-behind 待寫筆數達此值即 flush
+        inline static size_t redisFlushBatchSize() noexcept
+        {
+            return redisFlushBatchSize_;
+        }
+
+        // 純讀：無新資料超過此時間 (us) 即 flush
+        inline static uint32_t redisIdleFlushUs() noexcept
+        {
+            return redisIdleFlushUs_;
+        }
+
+        // 純讀：批次寫入是否以 MULTI/EXEC 包成交易
+        inline static bool redisPipelineTransaction() noexcept
+        {
+            return redisPipelineTransaction_;
+        }
+
+        // 純讀：Redis 寫入 worker 數 (每個 worker 一條專屬連線)
+        inline static size_t redisWorkerCount() noexcept
+        {
+            return redisWorkerCount_;
+        }
+
+        // 純讀：共用連線池大小 (不含寫入 worker 的專屬連線)
+        inline static size_t redisPoolSize() noexcept
+        {
+            return redisPoolSize_;
+        }
+
+        // 純讀：等待連線池空出連線的上限 (ms)，0 表示無限等待
+        inline static uint32_t redisPoolWaitTimeoutMs() noexcept
+        {
+            return redisPoolWaitTimeoutMs_;
+        }
+
+        // 純讀：Redis 連線建立超時 (ms)
+        inline static uint32_t redisConnectTimeoutMs() noexcept
+        {
+            return redisConnectTimeoutMs_;
+        }
+
+        // 純讀：Redis 命令讀寫超時 (ms)，0 表示不設限
+        inline static uint32_t redisSocketTimeoutMs() noexcept
+        {
+            return redisSocketTimeoutMs_;
+        }
+
+        // 純讀：是否啟用 TCP keepalive
+        inline static bool redisKeepAlive() noexcept
+        {
+            return redisKeepAlive_;
+        }
+
+        // 純讀：TCP keepalive 間隔 (s)，0 表示使用系統預設
+        inline static uint32_t redisKeepAliveIntervalS() noexcept
+        {
+            return redisKeepAliveIntervalS_;
+        }
+
+        // 純讀：是否以全量重算交叉檢查增量維護的總公司彙總
+        inline static bool summaryAggregateCrossCheck() noexcept
+        {
+            return summaryAggregateCrossCheck_;
+        }
+
+        // 純讀：股票清單檔路徑，空字串表示不使用
+        inline static const std::string &stockUniverseFile() noexcept
+        {
+            return stockUniverseFile_;
+        }
+
+        // 純讀：mmap 快取檔路徑，空字串表示不使用
+        inline static const std::string &summaryCacheFile() noexcept
+        {
+            return summaryCacheFile_;
+        }
+
+        // 純讀：新建快取檔的容量 (筆數，進位到 2 的冪)
+        inline static size_t summaryCacheCapacity() noexcept
+        {
+            return summaryCacheCapacity_;
+        }
+
+        // 純讀：封包日誌目錄，空字串表示不記錄
+        inline static const std::string &journalDir() noexcept
+        {
+            return journalDir_;
+        }
+
+        // 純讀：日誌 group commit 的最長間隔 (微秒)
+        inline static uint32_t journalCommitIntervalUs() noexcept
+        {
+            return journalCommitIntervalUs_;
+        }
+
+        // 純讀：日誌單段檔案大小上限 (位元組)
+        inline static size_t journalSegmentBytes() noexcept
+        {
+            return journalSegmentBytes_;
+        }
+
+        // 純讀：快取檔 checkpoint 與刪除舊日誌段的間隔 (毫秒)
+        inline static uint32_t journalCheckpointIntervalMs() noexcept
+        {
+            return journalCheckpointIntervalMs_;
+        }
+
     private:
         // 確保 JSON 只解析一次
         inline static std::once_flag initFlag_{};
@@ -91,6 +283,32 @@ namespace finance::infrastructure::config
         inline static std::string redisPassword_ = {}; // Redis 密碼
         inline static int serverPort_ = 0;
         inline static int socketTimeoutMs_ = 0;
+        inline static std::string consumerWaitMode_ = "spin_park";
+        inline static uint32_t consumerSpinCount_ = 2000;
+        inline static uint32_t consumerYieldCount_ = 100;
+        inline static uint32_t consumerParkTimeoutMs_ = 100;
+        inline static size_t conflationThresholdBytes_ = 0;
+        inline static std::string pipelineMode_ = "split";
+        inline static int pipelineCpu_ = -1;
+        inline static uint32_t redisFlushIntervalMs_ = 50;
+        inline static size_t redisFlushBatchSize_ = 512;
+        inline static uint32_t redisIdleFlushUs_ = 200;
+        inline static bool redisPipelineTransaction_ = false;
+        inline static size_t redisWorkerCount_ = 4;
+        inline static size_t redisPoolSize_ = 8;
+        inline static uint32_t redisPoolWaitTimeoutMs_ = 100;
+        inline static uint32_t redisConnectTimeoutMs_ = 1000;
+        inline static uint32_t redisSocketTimeoutMs_ = 0;
+        inline static bool redisKeepAlive_ = true;
+        inline static uint32_t redisKeepAliveIntervalS_ = 0;
+        inline static bool summaryAggregateCrossCheck_ = false;
+        inline static std::string stockUniverseFile_ = {};
+        inline static std::string summaryCacheFile_ = {};
+        inline static size_t summaryCacheCapacity_ = 131072;
+        inline static std::string journalDir_ = {};
+        inline static uint32_t journalCommitIntervalUs_ = 1000;
+        inline static size_t journalSegmentBytes_ = size_t{64} << 20;
+        inline static uint32_t journalCheckpointIntervalMs_ = 10000;
     };
 
 } // namespace finance::infrastructure::config
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "domain/SummaryKey.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <loguru.hpp>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace finance::infrastructure::config
+{
+
+    /**
+     * 股票清單 (stock universe)：啟動時據以預先建立所有 (區中心, 股票) 快取項目，
+     * 並以 bloom filter 在查表前快速排除清單外的股票代號。
+     * 檔案格式為每行一個股票代號，空白行與 # 開頭的註解行忽略。
+     * bloom filter 不會誤判清單內的股票；清單外的股票約有 1% 機率通過，由後續查表處理。
+     */
+    class StockUniverse
+    {
+    public:
+        /// 由股票代號列表建立；無法壓縮成 SummaryKey 的代號與重複代號略過
+        explicit StockUniverse(const std::vector<std::string> &stockIds)
+        {
+            std::unordered_set<uint64_t> seen;
+            for (const auto &id : stockIds)
+            {
+                auto bits = domain::SummaryKey::stockBitsOf(id);
+                if (!bits)
+                {
+                    LOG_F(WARNING, "StockUniverse: invalid stock id '%s' ignored", id.c_str());
+                    continue;
+                }
+                if (seen.insert(*bits).second)
+                    stockIds_.push_back(id);
+            }
+
+            // 每個代號 16 個位元、2 個雜湊：誤判率約 1.4%，2 萬檔股票只需 40KB
+            size_t bitCount = MIN_BITS;
+            while (bitCount < stockIds_.size() * BITS_PER_STOCK)
+                bitCount <<= 1;
+            bits_.assign(bitCount / 64, 0);
+            mask_ = bitCount - 1;
+            for (uint64_t stockBits : seen)
+            {
+                const auto [h1, h2] = hashes(stockBits);
+                bits_[(h1 & mask_) >> 6] |= uint64_t{1} << (h1 & 63);
+                bits_[(h2 & mask_) >> 6] |= uint64_t{1} << (h2 & 63);
+            }
+        }
+
+        /// 讀取股票清單檔；無法開啟時回傳 std::nullopt
+        static std::optional<StockUniverse> loadFromFile(const std::string &filePath)
+        {
+            std::ifstream ifs(filePath);
+            if (!ifs)
+            {
+                LOG_F(ERROR, "StockUniverse: cannot open stock universe file: %s", filePath.c_str());
+                return std::nullopt;
+            }
+            return parse(ifs);
+        }
+
+        static StockUniverse parse(std::istream &in)
+        {
+            std::vector<std::string> ids;
+            std::string line;
+            while (std::getline(in, line))
+            {
+                auto begin = line.find_first_not_of(" \t\r");
+                if (begin == std::string::npos || line[begin] == '#')
+                    continue;
+                auto end = line.find_first_of(" \t\r", begin);
+                ids.push_back(line.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+            }
+            return StockUniverse(ids);
+        }
+
+        /// 股票是否可能在清單內 (SummaryKey::stockBits())；回傳 false 時一定不在清單內
+        bool mayContain(uint64_t stockBits) const noexcept
+        {
+            const auto [h1, h2] = hashes(stockBits);
+            return (bits_[(h1 & mask_) >> 6] >> (h1 & 63) & (bits_[(h2 & mask_) >> 6] >> (h2 & 63)) & 1) != 0;
+        }
+
+        const std::vector<std::string> &stockIds() const noexcept { return stockIds_; }
+
+        size_t size() const noexcept { return stockIds_.size(); }
+
+    private:
+        static constexpr size_t BITS_PER_STOCK = 16;
+        static constexpr size_t MIN_BITS = 4096;
+
+        // 兩個雜湊取自同一個 64 位元乘法混合的高低兩半
+        static std::pair<uint64_t, uint64_t> hashes(uint64_t stockBits) noexcept
+        {
+            uint64_t h = (stockBits ^ (stockBits >> 29)) * 0x9E3779B97F4A7C15ULL;
+            h ^= h >> 32;
+            return {h, (h >> 32) | (h << 32)};
+        }
+
+        std::vector<std::string> stockIds_;
+        std::vector<uint64_t> bits_;
+        uint64_t mask_ = 0;
+    };
+
+} // namespace finance::infrastructure::config
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace finance::infrastructure::network
+{
+
+    /**
+     * 分隔符掃描器：以 64 字節為一個區塊，一次比對整個區塊並產生分隔符位置的 bitmap，
+     * 再逐一取出 bitmap 中的位元，取代對每個封包重新呼叫 memchr。
+     * 編譯時有 AVX2 則使用 AVX2 (2 x 32 字節)，否則使用 SSE2 (4 x 16 字節)，兩者皆無時退回逐字節比對。
+     * 不足 64 字節的尾段一律逐字節處理，不會讀取超出範圍的記憶體。
+     */
+    class DelimiterScanner
+    {
+    public:
+        static constexpr size_t BLOCK_SIZE = 64;
+
+        /// 目前編譯使用的指令集，用於日誌
+        static constexpr const char *isaName() noexcept
+        {
+#if defined(__AVX2__)
+            return "AVX2";
+#elif defined(__SSE2__)
+            return "SSE2";
+#else
+            return "scalar";
+#endif
+        }
+
+        /**
+         * 產生 64 字節區塊中分隔符位置的 bitmap，第 i 位元為 1 表示 block[i] == delim。
+         * block 至少需有 BLOCK_SIZE 字節可讀，不要求對齊。
+         */
+        static uint64_t blockMask(const char *block, char delim) noexcept
+        {
+#if defined(__AVX2__)
+            const __m256i d = _mm256_set1_epi8(delim);
+            const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+            const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32));
+            uint64_t lo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v0, d)));
+            uint64_t hi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v1, d)));
+            return lo | (hi << 32);
+#elif defined(__SSE2__)
+            const __m128i d = _mm_set1_epi8(delim);
+            uint64_t mask = 0;
+            for (size_t i = 0; i < BLOCK_SIZE; i += 16)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+                mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, d)))) << i;
+            }
+            return mask;
+#else
+            uint64_t mask = 0;
+            for (size_t i = 0; i < BLOCK_SIZE; ++i)
+                mask |= static_cast<uint64_t>(block[i] == delim) << i;
+            return mask;
+#endif
+        }
+
+        /**
+         * 依序找出 [data, data + len) 中所有分隔符，對每個位置呼叫 onDelim(offset)。
+         * onDelim 回傳 false 時立即停止。
+         * @return 掃描停止的位置：提前停止時為該分隔符的下一個位置，否則為 len
+         */
+        template <typename OnDelim>
+        static size_t scan(const char *data, size_t len, char delim, OnDelim &&onDelim)
+        {
+            size_t i = 0;
+            for (; i + BLOCK_SIZE <= len; i += BLOCK_SIZE)
+            {
+                uint64_t mask = blockMask(data + i, delim);
+                while (mask != 0)
+                {
+                    size_t off = i + static_cast<size_t>(__builtin_ctzll(mask));
+                    mask &= mask - 1;
+                    if (!onDelim(off))
+                        return off + 1;
+                }
+            }
+            for (; i < len; ++i)
+            {
+                if (data[i] == delim && !onDelim(i))
+                    return i + 1;
+            }
+            return len;
+        }
+    };
+
+} // namespace finance::infrastructure::network
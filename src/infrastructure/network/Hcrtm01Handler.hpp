@@ -5,10 +5,11 @@
 #include "domain/Result.hpp"
 #include "domain/IFinanceRepository.hpp"
 #include "utils/FinanceUtils.hpp"
+#include "MessageSchema.hpp"
 #include "infrastructure/config/AreaBranchProvider.hpp"
 #include <memory>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <loguru.hpp>
 
 namespace finance::infrastructure::network
@@ -22,7 +23,7 @@ namespace finance::infrastructure::network
     using utils::FinanceUtils;
     namespace config = finance::infrastructure::config;
 
-    class Hcrtm01Handler : public domain::IPackageHandler
+    class Hcrtm01Handler final : public domain::IPackageHandler
     {
     public:
         explicit Hcrtm01Handler(std::shared_ptr<IFinanceRepository<SummaryData, ErrorResult>> repo)
@@ -30,35 +31,40 @@ namespace finance::infrastructure::network
 
         Result<void, ErrorResult> handle(const FinancePackageMessage &pkg) override
         {
-            LOG_F(INFO, "Hcrtm01Handler::handle (preparing async tasks)");
+            DLOG_F(INFO, "Hcrtm01Handler::handle (preparing async tasks)");
 
             const auto &hcrtm01 = pkg.ap_data.data.hcrtm01;
 
-            // Extract area_center
-            std::string headerAreaCenter = FinanceUtils::trim_right(pkg.ap_data.system, sizeof(pkg.ap_data.system));
-            std::string dataAreaCenter = FinanceUtils::trim_right(hcrtm01.area_center, sizeof(hcrtm01.area_center));
+            // 定長欄位以 string_view 取出，直到 Redis I/O 前都不產生字串
+            std::string_view headerAreaCenter = FinanceUtils::trim_right_view(pkg.ap_data.system, sizeof(pkg.ap_data.system));
+            std::string_view dataAreaCenter = FinanceUtils::trim_right_view(hcrtm01.area_center, sizeof(hcrtm01.area_center));
             // Validate area centers match
             if (headerAreaCenter != dataAreaCenter)
             {
-                LOG_F(ERROR, "Hcrtm01Handler::Header area center (%s) does not match data area center (%s)",
-                      headerAreaCenter.c_str(), dataAreaCenter.c_str());
+                LOG_F(ERROR, "Hcrtm01Handler::Header area center (%.*s) does not match data area center (%.*s)",
+                      static_cast<int>(headerAreaCenter.size()), headerAreaCenter.data(),
+                      static_cast<int>(dataAreaCenter.size()), dataAreaCenter.data());
                 return Result<void, ErrorResult>::Err(
                     ErrorResult{ErrorCode::InvalidPacket, "Area center mismatch"});
             }
 
-            if (!config::AreaBranchProvider::IsValidAreaCenter(headerAreaCenter))
-            {
-                LOG_F(ERROR, "Hcrtm01Handler::Header area center (%s) InValid !", headerAreaCenter.c_str());
-                return Result<void, ErrorResult>::Err(ErrorResult{ErrorCode::InvalidPacket, "Area center InValid"});
-            }
-
             // Extract stock_id from ap_data
-            std::string stock_id = FinanceUtils::trim_right(hcrtm01.stock_id, sizeof(hcrtm01.stock_id));
+            std::string_view stock_id = FinanceUtils::trim_right_view(hcrtm01.stock_id, sizeof(hcrtm01.stock_id));
 
-            auto get_result = repo_->getData(stock_id);
+            // 每個 (區中心, 股票) 各自一筆快取
+            auto summaryKey = domain::SummaryKey::make(dataAreaCenter, stock_id);
+            if (!summaryKey || !config::AreaBranchProvider::IsValidAreaCenter(*summaryKey))
+            {
+                LOG_F(ERROR, "Hcrtm01Handler::Invalid area center (%.*s) or stock_id (%.*s)",
+                      static_cast<int>(dataAreaCenter.size()), dataAreaCenter.data(),
+                      static_cast<int>(stock_id.size()), stock_id.data());
+                return Result<void, ErrorResult>::Err(ErrorResult{ErrorCode::InvalidPacket, summaryKey ? "Area center InValid" : "Invalid stock_id"});
+            }
+            auto get_result = repo_->getData(*summaryKey);
             if (get_result.is_err())
             {
-                LOG_F(ERROR, "Hcrtm01Handler:Failed to get summary data for stock_id=%s", stock_id.c_str());
+                LOG_F(ERROR, "Hcrtm01Handler:Failed to get summary data for stock_id=%.*s",
+                      static_cast<int>(stock_id.size()), stock_id.data());
                 return Result<void, ErrorResult>::Err(get_result.unwrap_err());
             }
 
@@ -66,84 +72,26 @@ namespace finance::infrastructure::network
 
             // 將從 ELD001 解析出的所有相關數值存入 SummaryData 的 h01_* 欄位
             summary_data->stock_id = stock_id;
-            summary_data->area_center = dataAreaCenter;                                                      // 確保 area_center 被設置
-            summary_data->belong_branches = config::AreaBranchProvider::getBranchesFromArea(dataAreaCenter); // 更新分支資訊
-
-            // 轉換並儲存所有 HCRTM01 的數值到 SummaryData 的 h01_* 欄位
-            // 使用 CONVERT_BACKOFFICE_INT64 宏來處理轉換和錯誤檢查
-            CONVERT_BACKOFFICE_INT64(hcrtm01, margin_amount); // 例如這樣轉換第一個欄位
-            summary_data->h01_margin_amount = margin_amount;  // 儲存轉換後的數值
-
-            CONVERT_BACKOFFICE_INT64(hcrtm01, margin_buy_order_amount);
-            summary_data->h01_margin_buy_order_amount = margin_buy_order_amount;
-
-            CONVERT_BACKOFFICE_INT64(hcrtm01, margin_sell_match_amount);
-            summary_data->h01_margin_sell_match_amount = margin_sell_match_amount;
-
-            CONVERT_BACKOFFICE_INT64(hcrtm01, margin_qty);
-            summary_data->h01_margin_qty = margin_qty;
-
-            CONVERT_BACKOFFICE_INT64(hcrtm01, margin_buy_order_qty);
-            summary_data->h01_margin_buy_order_qty = margin_buy_order_qty;
-
-            CONVERT_BACKOFFICE_INT64(hcrtm01, margin_sell_match_qty);
-            summary_data->h01_margin_sell_match_qty = margin_sell_match_qty;
-
-            CONVERT_BACKOFFICE_INT64(hcrtm01, short_amount);
-            summary_data->h01_short_amount = short_amount;
-
-            CONVERT_BACKOFFICE_INT64(hcrtm01, short_sell_order_amount);
-            summary_data->h01_short_sell_order_amount = short_sell_order_amount;
-
-            CONVERT_BACKOFFICE_INT64(hcrtm01, short_qty);
-            summary_data->h01_short_qty = short_qty;
+            summary_data->area_center = dataAreaCenter;                                                   // 確保 area_center 被設置
+            summary_data->belong_branches = config::AreaBranchProvider::getBranchListFromArea(*summaryKey); // 更新分支資訊 (共用列表，不複製)
 
-            CONVERT_BACKOFFICE_INT64(hcrtm01, short_sell_order_qty);
-            summary_data->h01_short_sell_order_qty = short_sell_order_qty;
-
-            CONVERT_BACKOFFICE_INT64(hcrtm01, short_after_hour_sell_order_amount);
-            summary_data->h01_short_after_hour_sell_order_amount = short_after_hour_sell_order_amount;
-
-            CONVERT_BACKOFFICE_INT64(hcrtm01, short_after_hour_sell_order_qty);
-            summary_data->h01_short_after_hour_sell_order_qty = short_after_hour_sell_order_qty;
-
-            CONVERT_BACKOFFICE_INT64(hcrtm01, short_sell_match_amount);
-            summary_data->h01_short_sell_match_amount = short_sell_match_amount;
-
-            CONVERT_BACKOFFICE_INT64(hcrtm01, short_sell_match_qty);
-            summary_data->h01_short_sell_match_qty = short_sell_match_qty;
-
-            CONVERT_BACKOFFICE_INT64(hcrtm01, margin_after_hour_buy_order_amount);
-            summary_data->h01_margin_after_hour_buy_order_amount = margin_after_hour_buy_order_amount;
-
-            CONVERT_BACKOFFICE_INT64(hcrtm01, margin_after_hour_buy_order_qty);
-            summary_data->h01_margin_after_hour_buy_order_qty = margin_after_hour_buy_order_qty;
-
-            CONVERT_BACKOFFICE_INT64(hcrtm01, margin_buy_match_amount);
-            summary_data->h01_margin_buy_match_amount = margin_buy_match_amount;
-
-            CONVERT_BACKOFFICE_INT64(hcrtm01, margin_buy_match_qty);
-            summary_data->h01_margin_buy_match_qty = margin_buy_match_qty;
+            // 依 MessageSchema 一次解碼所有 HCRTM01 數值欄位，全部成功才寫入 SummaryData 的 h01_* 欄位
+            auto decoded = SchemaDecoder<domain::MessageDataHCRTM01>::decode(pkg, *summary_data);
+            if (decoded.is_err())
+            {
+                LOG_F(ERROR, "Hcrtm01Handler::%s", decoded.unwrap_err().message.c_str());
+                return decoded;
+            }
 
             // --- 呼叫 SummaryData 的方法進行計算 ---
             summary_data->calculate_availables();
 
-            // Create a copy of the summary data for async operations
-            SummaryData summary_data_copy = *summary_data;
-
-            // Construct the Redis key
-            std::string redis_key = "summary:" + summary_data_copy.area_center + ":" + summary_data_copy.stock_id;
-
-            // Submit async tasks
-            LOG_F(INFO, "Hcrtm01Handler: Submitting async SYNC task for key: %s", redis_key.c_str());
-            auto sync_future = repo_->sync_async(redis_key, summary_data_copy);
-
-            LOG_F(INFO, "Hcrtm01Handler: Submitting async UPDATE task for stock_id: %s", summary_data_copy.stock_id.c_str());
-            auto update_future = repo_->update_async(summary_data_copy.stock_id);
+            // 送出不需要結果的任務：資料複製進任務，Redis key 延後到 worker 寫入時才產生
+            repo_->sync_detached(*summaryKey, *summary_data);
+            repo_->update_detached(*summaryKey);
 
-            // Log that tasks have been submitted
-            LOG_F(INFO, "Hcrtm01Handler: Async tasks for SYNC and UPDATE submitted for stock_id=%s, area_center=%s.",
-                  summary_data_copy.stock_id.c_str(), summary_data_copy.area_center.c_str());
+            DLOG_F(INFO, "Hcrtm01Handler: Async tasks for SYNC and UPDATE submitted for stock_id=%s, area_center=%s.",
+                   summary_data->stock_id.c_str(), summary_data->area_center.c_str());
 
             // Return success since tasks have been submitted
             return Result<void, ErrorResult>::Ok();
@@ -5,12 +5,12 @@
 #include "domain/Result.hpp"
 #include "domain/IFinanceRepository.hpp"
 #include "utils/FinanceUtils.hpp"
+#include "MessageSchema.hpp"
 #include "infrastructure/config/AreaBranchProvider.hpp"
 #include <memory>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <loguru.hpp>
-#include <future>
 
 namespace finance::infrastructure::network
 {
@@ -23,7 +23,7 @@ namespace finance::infrastructure::network
     using utils::FinanceUtils;
     namespace config = finance::infrastructure::config;
 
-    class Hcrtm05pHandler : public domain::IPackageHandler
+    class Hcrtm05pHandler final : public domain::IPackageHandler
     {
     public:
         explicit Hcrtm05pHandler(std::shared_ptr<IFinanceRepository<SummaryData, ErrorResult>> repo)
@@ -31,41 +31,49 @@ namespace finance::infrastructure::network
 
         Result<void, ErrorResult> handle(const FinancePackageMessage &pkg) override
         {
-            LOG_F(INFO, "Hcrtm05pHandler::handle (preparing async tasks)");
+            DLOG_F(INFO, "Hcrtm05pHandler::handle (preparing async tasks)");
 
             const auto &hcrtm05p = pkg.ap_data.data.hcrtm05p;
 
-            std::string stock_id = FinanceUtils::trim_right(hcrtm05p.stock_id, sizeof(hcrtm05p.stock_id));
-            std::string area_center = FinanceUtils::trim_right(hcrtm05p.broker_id, sizeof(hcrtm05p.broker_id));
+            // 定長欄位以 string_view 取出，直到 Redis I/O 前都不產生字串
+            std::string_view stock_id = FinanceUtils::trim_right_view(hcrtm05p.stock_id, sizeof(hcrtm05p.stock_id));
+            std::string_view area_center = FinanceUtils::trim_right_view(hcrtm05p.broker_id, sizeof(hcrtm05p.broker_id));
 
-            if (!config::AreaBranchProvider::IsValidAreaCenter(area_center))
+            auto summaryKey = domain::SummaryKey::make(area_center, stock_id);
+            if (!summaryKey || !config::AreaBranchProvider::IsValidAreaCenter(*summaryKey))
             {
-                LOG_F(ERROR, "Invalid area_center (%s) for stock_id=%s", area_center.c_str(), stock_id.c_str());
-                return Result<void, ErrorResult>::Err(ErrorResult{ErrorCode::InvalidPacket, "Invalid broker_id (not a valid AreaCenter)"});
+                LOG_F(ERROR, "Hcrtm05pHandler:Invalid area_center (%.*s) or stock_id (%.*s)",
+                      static_cast<int>(area_center.size()), area_center.data(),
+                      static_cast<int>(stock_id.size()), stock_id.data());
+                return Result<void, ErrorResult>::Err(ErrorResult{ErrorCode::InvalidPacket,
+                                                                  summaryKey ? "Invalid broker_id (not a valid AreaCenter)" : "Invalid stock_id"});
             }
-
-            std::string key = "summary:" + area_center + ":" + stock_id;
-            auto existing = repo_->getData(key);
+            auto existing = repo_->getData(*summaryKey);
             if (existing.is_err())
             {
-                LOG_F(ERROR, "Hcrtm05pHandler:Failed to get summary data for stock_id=%s, area_center=%s", stock_id.c_str(), area_center.c_str());
+                LOG_F(ERROR, "Hcrtm05pHandler:Failed to get summary data for stock_id=%.*s, area_center=%.*s",
+                      static_cast<int>(stock_id.size()), stock_id.data(),
+                      static_cast<int>(area_center.size()), area_center.data());
                 return Result<void, ErrorResult>::Err(existing.unwrap_err());
             }
 
             domain::SummaryData *summary_data_ptr = existing.unwrap();
             if (summary_data_ptr == nullptr)
             {
-                LOG_F(ERROR, "Hcrtm05pHandler:Unexpact Summary Data null after getData, StockId=%s, AreaCenter=%s", stock_id.c_str(), area_center.c_str());
+                LOG_F(ERROR, "Hcrtm05pHandler:Unexpact Summary Data null after getData, StockId=%.*s, AreaCenter=%.*s",
+                      static_cast<int>(stock_id.size()), stock_id.data(),
+                      static_cast<int>(area_center.size()), area_center.data());
                 return Result<void, ErrorResult>::Err(
                     ErrorResult{ErrorCode::UnexpectedError, "Hcrtm05pHandler:summary_data = nullptr after getData"});
             }
 
             // Convert and store HCRTM05P data to summary_data_ptr
-            CONVERT_BACKOFFICE_INT64(hcrtm05p, margin_buy_offset_qty);
-            summary_data_ptr->h05p_margin_buy_offset_qty = margin_buy_offset_qty;
-
-            CONVERT_BACKOFFICE_INT64(hcrtm05p, short_sell_offset_qty);
-            summary_data_ptr->h05p_short_sell_offset_qty = short_sell_offset_qty;
+            auto decoded = SchemaDecoder<domain::MessageDataHCRTM05P>::decode(pkg, *summary_data_ptr);
+            if (decoded.is_err())
+            {
+                LOG_F(ERROR, "Hcrtm05pHandler::%s", decoded.unwrap_err().message.c_str());
+                return decoded;
+            }
 
             // Ensure basic identification info (if summary_data_ptr is newly created)
             if (summary_data_ptr->stock_id.empty())
@@ -74,28 +82,22 @@ namespace finance::infrastructure::network
                 summary_data_ptr->area_center = area_center;
             if (summary_data_ptr->belong_branches.empty())
             {
-                summary_data_ptr->belong_branches = config::AreaBranchProvider::getBranchesFromArea(area_center);
+                summary_data_ptr->belong_branches = config::AreaBranchProvider::getBranchListFromArea(*summaryKey);
             }
 
-            LOG_F(INFO, "Processed 05p for stock_id=%s, area_center=%s, margin_buy_offset_qty=%lld, short_sell_offset_qty=%lld",
-                  stock_id.c_str(), area_center.c_str(), margin_buy_offset_qty, short_sell_offset_qty);
+            DLOG_F(INFO, "Processed 05p for stock_id=%.*s, area_center=%.*s, margin_buy_offset_qty=%lld, short_sell_offset_qty=%lld",
+                   static_cast<int>(stock_id.size()), stock_id.data(), static_cast<int>(area_center.size()), area_center.data(),
+                   static_cast<long long>(summary_data_ptr->h05p_margin_buy_offset_qty), static_cast<long long>(summary_data_ptr->h05p_short_sell_offset_qty));
 
             // Recalculate all available quantities
             summary_data_ptr->calculate_availables();
 
-            // Create a copy of the summary data for async operations
-            SummaryData summary_data_copy = *summary_data_ptr;
-
-            // Submit async tasks
-            LOG_F(INFO, "Hcrtm05pHandler: Submitting async SYNC task for key: %s", key.c_str());
-            auto sync_future = repo_->sync_async(key, summary_data_copy);
-
-            LOG_F(INFO, "Hcrtm05pHandler: Submitting async UPDATE task for stock_id: %s", stock_id.c_str());
-            auto update_future = repo_->update_async(stock_id);
+            // 送出不需要結果的任務：資料複製進任務，Redis key 延後到 worker 寫入時才產生
+            repo_->sync_detached(*summaryKey, *summary_data_ptr);
+            repo_->update_detached(*summaryKey);
 
-            // Log that tasks have been submitted
-            LOG_F(INFO, "Hcrtm05pHandler: Async tasks for SYNC and UPDATE submitted for stock_id=%s, area_center=%s.",
-                  stock_id.c_str(), area_center.c_str());
+            DLOG_F(INFO, "Hcrtm05pHandler: Async tasks for SYNC and UPDATE submitted for stock_id=%.*s, area_center=%.*s.",
+                   static_cast<int>(stock_id.size()), stock_id.data(), static_cast<int>(area_center.size()), area_center.data());
 
             // Return success since tasks have been submitted
             return Result<void, ErrorResult>::Ok();
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "domain/FinanceDataStructure.hpp"
+#include "domain/Result.hpp"
+#include "utils/BackOfficeDecoder.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+// 由訊息成員與對應的 SummaryData 成員產生 NumericFieldSpec
+#define SCHEMA_NUMERIC_FIELD(MESSAGE_TYPE, VAR_NAME, TARGET)                                        \
+    ::finance::infrastructure::network::NumericFieldSpec                                           \
+    {                                                                                              \
+        #VAR_NAME, static_cast<uint16_t>(offsetof(MESSAGE_TYPE, VAR_NAME)),                        \
+            static_cast<uint8_t>(sizeof(MESSAGE_TYPE::VAR_NAME)), &::finance::domain::SummaryData::TARGET \
+    }
+
+namespace finance::infrastructure::network
+{
+
+    /// 一個後台數值欄位：在訊息中的位移與寬度，以及解碼後寫入的 SummaryData 成員
+    struct NumericFieldSpec
+    {
+        const char *name;
+        uint16_t offset;
+        uint8_t width;
+        int64_t domain::SummaryData::*target;
+    };
+
+    /**
+     * 各訊息格式的欄位表 (編譯期常數)。每個特化提供：
+     *   NAME            訊息名稱，用於錯誤訊息
+     *   NUMERIC_FIELDS  std::array<NumericFieldSpec, N>
+     *   from(pkg)       從封包取出該格式的資料區
+     * 新增格式 (或同一 t_code 的不同 rcd_len_cnt 版本) 只需要新的資料結構與一個特化，
+     * 解碼與寫入 SummaryData 由 SchemaDecoder 產生。
+     */
+    template <typename Message>
+    struct MessageSchema;
+
+    template <>
+    struct MessageSchema<domain::MessageDataHCRTM01>
+    {
+        using M = domain::MessageDataHCRTM01;
+        static constexpr const char *NAME = "hcrtm01";
+
+        static constexpr std::array<NumericFieldSpec, 18> NUMERIC_FIELDS = {{
+            SCHEMA_NUMERIC_FIELD(M, margin_amount, h01_margin_amount),
+            SCHEMA_NUMERIC_FIELD(M, margin_buy_order_amount, h01_margin_buy_order_amount),
+            SCHEMA_NUMERIC_FIELD(M, margin_sell_match_amount, h01_margin_sell_match_amount),
+            SCHEMA_NUMERIC_FIELD(M, margin_qty, h01_margin_qty),
+            SCHEMA_NUMERIC_FIELD(M, margin_buy_order_qty, h01_margin_buy_order_qty),
+            SCHEMA_NUMERIC_FIELD(M, margin_sell_match_qty, h01_margin_sell_match_qty),
+            SCHEMA_NUMERIC_FIELD(M, short_amount, h01_short_amount),
+            SCHEMA_NUMERIC_FIELD(M, short_sell_order_amount, h01_short_sell_order_amount),
+            SCHEMA_NUMERIC_FIELD(M, short_qty, h01_short_qty),
+            SCHEMA_NUMERIC_FIELD(M, short_sell_order_qty, h01_short_sell_order_qty),
+            SCHEMA_NUMERIC_FIELD(M, margin_buy_match_amount, h01_margin_buy_match_amount),
+            SCHEMA_NUMERIC_FIELD(M, margin_buy_match_qty, h01_margin_buy_match_qty),
+            SCHEMA_NUMERIC_FIELD(M, margin_after_hour_buy_order_amount, h01_margin_after_hour_buy_order_amount),
+            SCHEMA_NUMERIC_FIELD(M, margin_after_hour_buy_order_qty, h01_margin_after_hour_buy_order_qty),
+            SCHEMA_NUMERIC_FIELD(M, short_sell_match_amount, h01_short_sell_match_amount),
+            SCHEMA_NUMERIC_FIELD(M, short_sell_match_qty, h01_short_sell_match_qty),
+            SCHEMA_NUMERIC_FIELD(M, short_after_hour_sell_order_amount, h01_short_after_hour_sell_order_amount),
+            SCHEMA_NUMERIC_FIELD(M, short_after_hour_sell_order_qty, h01_short_after_hour_sell_order_qty),
+        }};
+
+        static const M &from(const domain::FinancePackageMessage &pkg) noexcept { return pkg.ap_data.data.hcrtm01; }
+    };
+
+    template <>
+    struct MessageSchema<domain::MessageDataHCRTM05P>
+    {
+        using M = domain::MessageDataHCRTM05P;
+        static constexpr const char *NAME = "hcrtm05p";
+
+        static constexpr std::array<NumericFieldSpec, 2> NUMERIC_FIELDS = {{
+            SCHEMA_NUMERIC_FIELD(M, margin_buy_offset_qty, h05p_margin_buy_offset_qty),
+            SCHEMA_NUMERIC_FIELD(M, short_sell_offset_qty, h05p_short_sell_offset_qty),
+        }};
+
+        static const M &from(const domain::FinancePackageMessage &pkg) noexcept { return pkg.ap_data.data.hcrtm05p; }
+    };
+
+    /// 欄位表檢查：寬度非 0、不超出訊息、欄位不重疊、目標成員不重複
+    template <typename Message>
+    constexpr bool isValidSchema() noexcept
+    {
+        const auto &f = MessageSchema<Message>::NUMERIC_FIELDS;
+        for (size_t i = 0; i < f.size(); ++i)
+        {
+            if (f[i].width == 0 || f[i].offset + f[i].width > sizeof(Message) || f[i].target == nullptr)
+                return false;
+            for (size_t j = 0; j < i; ++j)
+            {
+                if (f[j].offset + f[j].width > f[i].offset && f[i].offset + f[i].width > f[j].offset)
+                    return false;
+                if (f[j].target == f[i].target)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Message>
+    constexpr auto makeDecoderFields() noexcept
+    {
+        const auto &specs = MessageSchema<Message>::NUMERIC_FIELDS;
+        std::array<utils::BackOfficeDecoder::Field, std::tuple_size_v<std::decay_t<decltype(specs)>>> fields{};
+        for (size_t i = 0; i < fields.size(); ++i)
+            fields[i] = utils::BackOfficeDecoder::Field{specs[i].name, specs[i].offset, specs[i].width};
+        return fields;
+    }
+
+    /**
+     * 由 MessageSchema 產生的解碼器：一次 BackOfficeDecoder::decodeBatch() 解出所有數值欄位，
+     * 全部成功才寫入 SummaryData；欄位表的正確性在編譯期以 isValidSchema() 檢查。
+     */
+    template <typename Message>
+    class SchemaDecoder
+    {
+        static_assert(isValidSchema<Message>(), "MessageSchema 欄位重疊、超出訊息或目標成員重複");
+
+    public:
+        using Schema = MessageSchema<Message>;
+        static constexpr size_t FIELD_COUNT = Schema::NUMERIC_FIELDS.size();
+
+        /// 交給 BackOfficeDecoder 的欄位表 (由 NUMERIC_FIELDS 產生)
+        static constexpr std::array<utils::BackOfficeDecoder::Field, FIELD_COUNT> DECODER_FIELDS = makeDecoderFields<Message>();
+
+        /**
+         * 解碼 message 的所有數值欄位並寫入 out。
+         * readable 為從 message 起可讀取的字節數 (同一封包中其後的資料也算)，足夠時以整段 16 字節載入。
+         */
+        static domain::Result<void, domain::ErrorResult> decode(const Message &message, size_t readable, domain::SummaryData &out)
+        {
+            int64_t values[FIELD_COUNT];
+            utils::BackOfficeDecoder::Status status;
+            size_t failed = utils::BackOfficeDecoder::decodeBatch(reinterpret_cast<const char *>(&message), readable,
+                                                                  DECODER_FIELDS.data(), FIELD_COUNT, values, status);
+            if (failed != FIELD_COUNT)
+                return domain::Result<void, domain::ErrorResult>::Err(
+                    domain::ErrorResult{domain::ErrorCode::BackOfficeIntParseError,
+                                        std::string("CONVERT_BACKOFFICE_INT64:backOfficeToInt parse error : ") + Schema::NAME + "." +
+                                            DECODER_FIELDS[failed].name + " (" + utils::BackOfficeDecoder::message(status) + ")"});
+            for (size_t i = 0; i < FIELD_COUNT; ++i)
+                out.*(Schema::NUMERIC_FIELDS[i].target) = values[i];
+            return domain::Result<void, domain::ErrorResult>::Ok();
+        }
+
+        /// 從封包取出資料區並解碼
+        static domain::Result<void, domain::ErrorResult> decode(const domain::FinancePackageMessage &pkg, domain::SummaryData &out)
+        {
+            const Message &message = Schema::from(pkg);
+            const auto readable = static_cast<size_t>(reinterpret_cast<const char *>(&pkg + 1) - reinterpret_cast<const char *>(&message));
+            return decode(message, readable, out);
+        }
+    };
+
+} // namespace finance::infrastructure::network
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "domain/FinanceDataStructure.hpp"
+#include "domain/SummaryKey.hpp"
+#include "infrastructure/config/AreaBranchProvider.hpp"
+#include "MessageSchema.hpp"
+#include "utils/BackOfficeDecoder.hpp"
+#include "utils/FinanceUtils.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace finance::infrastructure::network
+{
+
+    /**
+     * 積壓時的 HCRTM01 合併：每筆 ELD001 攜帶 (area_center, stock_id) 的完整額度狀態，
+     * 同一批封包中若同一個 key 之後還有另一筆有效的 ELD001，前面那筆的結果會被完全覆蓋，可直接略過。
+     * HCRTM05P (ELD002) 與其他封包一律保留並維持原順序；HCRTM05P 只更新 h05p_* 欄位，
+     * 略過較舊的 HCRTM01 不影響最後寫入的狀態。
+     * 僅由 consumer 執行緒使用，內部雜湊表跨批次重複使用以避免配置記憶體。
+     */
+    class PacketConflator
+    {
+    public:
+        /**
+         * 標記 segs 中被同批較新 HCRTM01 取代的封包。
+         * @param segs 單段連續封包 (ptr/len，例如 RingBuffer 的 PacketSpan)，依到達順序排列
+         * @param count 封包數
+         * @param skip 輸出：skip[i] 非 0 表示第 i 筆可略過，大小會調整為 count
+         * @return 可略過的封包數
+         */
+        template <typename Seg>
+        size_t markSuperseded(const Seg *segs, size_t count, std::vector<uint8_t> &skip)
+        {
+            skip.assign(count, 0);
+            resetTable(count);
+
+            size_t skipped = 0;
+            // 由新到舊掃描：第一次看到的 key 是最新一筆，之後再看到的都已被取代
+            for (size_t i = count; i-- > 0;)
+            {
+                const char *key = conflationKey(segs[i].ptr, segs[i].len);
+                if (key == nullptr)
+                    continue;
+                if (!insert(key))
+                {
+                    skip[i] = 1;
+                    ++skipped;
+                }
+            }
+            return skipped;
+        }
+
+        /**
+         * 取得可合併封包的 key (area_center + stock_id，共 KEY_SIZE 字節，於封包中連續)；
+         * 不是 handler 會接受的 ELD001 時回傳 nullptr，該筆不取代任何封包。
+         * 檢查與 TransactionProcessor / Hcrtm01Handler 相同：entry_type 為 'A' 或 'C'、表頭 system 與資料 area_center 相同、
+         * SummaryKey 可建立且區中心有效、所有數值欄位 (SchemaDecoder::DECODER_FIELDS) 都能解碼。
+         * repository 的 stock universe 過濾只依 (區中心, 股票) 判斷，同一 key 的每一筆結果相同，略過較舊者不會遺失資料。
+         */
+        static const char *conflationKey(const char *data, size_t len) noexcept
+        {
+            if (len < MIN_PACKET_SIZE)
+                return nullptr;
+            const auto *pkg = reinterpret_cast<const domain::FinancePackageMessage *>(data);
+            if (std::memcmp(pkg->t_code, "ELD001", sizeof(pkg->t_code)) != 0)
+                return nullptr;
+            char et = pkg->ap_data.entry_type[0];
+            if (et != 'A' && et != 'C')
+                return nullptr;
+
+            const auto &hcrtm01 = pkg->ap_data.data.hcrtm01;
+            std::string_view headerArea = utils::FinanceUtils::trim_right_view(pkg->ap_data.system, sizeof(pkg->ap_data.system));
+            std::string_view dataArea = utils::FinanceUtils::trim_right_view(hcrtm01.area_center, sizeof(hcrtm01.area_center));
+            if (headerArea != dataArea)
+                return nullptr;
+            auto key = domain::SummaryKey::make(dataArea, utils::FinanceUtils::trim_right_view(hcrtm01.stock_id, sizeof(hcrtm01.stock_id)));
+            if (!key || !config::AreaBranchProvider::IsValidAreaCenter(*key))
+                return nullptr;
+
+            // 數值欄位解碼失敗時 handler 會拒絕此筆，不可取代同 key 較舊的有效封包
+            using Decoder = SchemaDecoder<domain::MessageDataHCRTM01>;
+            int64_t values[Decoder::FIELD_COUNT];
+            utils::BackOfficeDecoder::Status status;
+            if (utils::BackOfficeDecoder::decodeBatch(reinterpret_cast<const char *>(&hcrtm01), len - DATA_OFFSET,
+                                                      Decoder::DECODER_FIELDS.data(), Decoder::FIELD_COUNT, values, status) != Decoder::FIELD_COUNT)
+                return nullptr;
+            return hcrtm01.area_center;
+        }
+
+        static constexpr size_t KEY_SIZE = sizeof(domain::MessageDataHCRTM01::area_center) +
+                                           sizeof(domain::MessageDataHCRTM01::stock_id);
+
+    private:
+        static_assert(offsetof(domain::MessageDataHCRTM01, stock_id) ==
+                          offsetof(domain::MessageDataHCRTM01, area_center) + sizeof(domain::MessageDataHCRTM01::area_center),
+                      "area_center 與 stock_id 必須相鄰");
+
+        // HCRTM01 資料區在封包中的位置；封包需包含完整資料區，數值欄位才不會讀到下一個封包
+        static constexpr size_t DATA_OFFSET = offsetof(domain::FinancePackageMessage, ap_data) + offsetof(domain::ApData, data);
+        static constexpr size_t MIN_PACKET_SIZE = DATA_OFFSET + sizeof(domain::MessageDataHCRTM01);
+
+        static uint64_t hashKey(const char *key) noexcept
+        {
+            // FNV-1a
+            uint64_t h = 1469598103934665603ULL;
+            for (size_t i = 0; i < KEY_SIZE; ++i)
+            {
+                h ^= static_cast<unsigned char>(key[i]);
+                h *= 1099511628211ULL;
+            }
+            return h;
+        }
+
+        // 雜湊表至少為元素數的兩倍 (2 的冪次)，並清空
+        void resetTable(size_t count)
+        {
+            size_t cap = 16;
+            while (cap < count * 2)
+                cap <<= 1;
+            if (slots_.size() < cap)
+                slots_.resize(cap);
+            std::fill(slots_.begin(), slots_.begin() + cap, nullptr);
+            mask_ = cap - 1;
+        }
+
+        // 開放定址 (線性探測)；key 已存在時回傳 false
+        bool insert(const char *key) noexcept
+        {
+            for (size_t idx = hashKey(key) & mask_;; idx = (idx + 1) & mask_)
+            {
+                const char *slot = slots_[idx];
+                if (slot == nullptr)
+                {
+                    slots_[idx] = key;
+                    return true;
+                }
+                if (std::memcmp(slot, key, KEY_SIZE) == 0)
+                    return false;
+            }
+        }
+
+        std::vector<const char *> slots_; // 指向封包內的 key，僅在單一批次內有效
+        size_t mask_ = 0;
+    };
+
+} // namespace finance::infrastructure::network
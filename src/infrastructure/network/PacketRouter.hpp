@@ -0,0 +1,57 @@
+#pragma once
+
+#include "domain/FinanceDataStructure.hpp"
+#include "domain/SummaryKey.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+namespace finance::infrastructure::network
+{
+
+    /**
+     * 分片管線的封包分派：依封包中的股票代號決定由哪個 shard 處理。
+     * 與 RedisSummaryAdapter 的快取分區、RedisWorkerPool 的寫入通道使用同一個 SummaryKey::shardOf()，
+     * 同一檔股票的 HCRTM01 / HCRTM05P (所有區中心) 因此都由同一個 shard 依到達順序處理。
+     * 無法辨識股票代號的封包 (keep alive、未知 t_code、過短) 一律交給 shard 0，由 handler 照常記錄錯誤。
+     */
+    class PacketRouter
+    {
+    public:
+        /// 封包的股票代號壓縮位元 (SummaryKey::stockBits())；無法取得時回傳 std::nullopt
+        static std::optional<uint64_t> stockBitsOf(const char *data, size_t len) noexcept
+        {
+            if (len < sizeof(domain::FinancePackageMessage::p_code) + sizeof(domain::FinancePackageMessage::t_code))
+                return std::nullopt;
+            const auto *pkg = reinterpret_cast<const domain::FinancePackageMessage *>(data);
+            if (std::memcmp(pkg->t_code, "ELD001", sizeof(pkg->t_code)) == 0)
+                return stockField(data, len, HCRTM01_STOCK_OFFSET, sizeof(domain::MessageDataHCRTM01::stock_id));
+            if (std::memcmp(pkg->t_code, "ELD002", sizeof(pkg->t_code)) == 0)
+                return stockField(data, len, HCRTM05P_STOCK_OFFSET, sizeof(domain::MessageDataHCRTM05P::stock_id));
+            return std::nullopt;
+        }
+
+        static size_t shardOf(const char *data, size_t len, size_t shards) noexcept
+        {
+            if (shards <= 1)
+                return 0;
+            auto bits = stockBitsOf(data, len);
+            return bits ? domain::SummaryKey::shardOf(*bits, shards) : 0;
+        }
+
+    private:
+        static constexpr size_t DATA_OFFSET = offsetof(domain::FinancePackageMessage, ap_data) + offsetof(domain::ApData, data);
+        static constexpr size_t HCRTM01_STOCK_OFFSET = DATA_OFFSET + offsetof(domain::MessageDataHCRTM01, stock_id);
+        static constexpr size_t HCRTM05P_STOCK_OFFSET = DATA_OFFSET + offsetof(domain::MessageDataHCRTM05P, stock_id);
+
+        static std::optional<uint64_t> stockField(const char *data, size_t len, size_t offset, size_t width) noexcept
+        {
+            if (len < offset + width)
+                return std::nullopt;
+            return domain::SummaryKey::stockBitsOf(std::string_view(data + offset, width));
+        }
+    };
+
+} // namespace finance::infrastructure::network
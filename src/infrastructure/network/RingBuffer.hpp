@@ -5,10 +5,18 @@
 #include <atomic>
 #include <thread>  // std::this_thread::yield
 #include <cstring> // memchr
+#include <cerrno>
 #include <stdexcept>
 #include <cinttypes> // PRIu64
 #include <loguru.hpp>
 #include <optional>
+#include <type_traits>
+#include <string>
+#include <sys/mman.h> // memfd_create, mmap
+#include <unistd.h>   // ftruncate, close, sysconf
+#include <algorithm>
+#include "infrastructure/network/DelimiterScanner.hpp"
+#include "infrastructure/network/WaitStrategy.hpp"
 
 namespace finance::infrastructure::network
 {
@@ -27,13 +35,110 @@ namespace finance::infrastructure::network
 #endif
     }
 
+    /**
+     * RingBuffer 的一般儲存：緩衝區直接內嵌於物件中，跨越環界的資料會被分成兩段。
+     */
+    template <size_t CAP>
+    class InlineRingStorage
+    {
+    public:
+        static constexpr bool IS_MIRRORED = false;
+
+        char *data() noexcept { return buffer_; }
+        const char *data() const noexcept { return buffer_; }
+
+    private:
+        // RingBuffer 緩衝區，使用 alignas 確保在快取行邊界對齊
+        alignas(64) char buffer_[CAP];
+    };
+
+    /**
+     * RingBuffer 的鏡像儲存：同一個 memfd 連續映射兩次，[CAP, 2*CAP) 與 [0, CAP) 指向相同的實體頁。
+     * 因此從任何位置開始、長度不超過 CAP 的資料在虛擬位址上都是連續的，封包永遠不會被環界切成兩段。
+     * CAP 必須是系統頁大小的整數倍。
+     */
+    template <size_t CAP>
+    class MirroredRingStorage
+    {
+    public:
+        static constexpr bool IS_MIRRORED = true;
+
+        MirroredRingStorage()
+        {
+            long pageSize = sysconf(_SC_PAGESIZE);
+            if (pageSize <= 0 || CAP % static_cast<size_t>(pageSize) != 0)
+                throw std::runtime_error("MirroredRingStorage: CAP must be a multiple of the page size");
+
+            int fd = memfd_create("finance_ring_buffer", MFD_CLOEXEC);
+            if (fd < 0)
+                throw std::runtime_error("MirroredRingStorage: memfd_create failed: " + std::string(strerror(errno)));
+            if (ftruncate(fd, static_cast<off_t>(CAP)) != 0)
+            {
+                close(fd);
+                throw std::runtime_error("MirroredRingStorage: ftruncate failed: " + std::string(strerror(errno)));
+            }
+
+            // 先保留 2*CAP 的連續位址空間，再把 memfd 以 MAP_FIXED 映射到前後兩半
+            void *reserved = mmap(nullptr, 2 * CAP, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (reserved == MAP_FAILED)
+            {
+                close(fd);
+                throw std::runtime_error("MirroredRingStorage: address reservation failed: " + std::string(strerror(errno)));
+            }
+            char *base = static_cast<char *>(reserved);
+            bool mapped = mmap(base, CAP, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+                          mmap(base + CAP, CAP, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+            int mapErrno = errno;
+            close(fd); // 映射會保有 memfd 的參考
+            if (!mapped)
+            {
+                munmap(base, 2 * CAP);
+                throw std::runtime_error("MirroredRingStorage: mirror mapping failed: " + std::string(strerror(mapErrno)));
+            }
+            base_ = base;
+        }
+
+        ~MirroredRingStorage()
+        {
+            if (base_)
+                munmap(base_, 2 * CAP);
+        }
+
+        MirroredRingStorage(const MirroredRingStorage &) = delete;
+        MirroredRingStorage &operator=(const MirroredRingStorage &) = delete;
+
+        char *data() noexcept { return base_; }
+        const char *data() const noexcept { return base_; }
+
+    private:
+        char *base_ = nullptr;
+    };
+
+    /// 一般儲存中的封包：跨越環界時分成兩段 (ptr2 為 nullptr 表示只有一段)
+    struct SplitPacketSeg
+    {
+        const char *ptr1;
+        size_t len1;
+        const char *ptr2;
+        size_t len2;
+        size_t totalLen() const noexcept { return len1 + len2; }
+    };
+
+    /// 鏡像儲存中的封包：永遠是單段連續記憶體，可直接轉型為訊息結構
+    struct PacketSpan
+    {
+        const char *ptr;
+        size_t len;
+    };
+
     /**
      * 單生產者單消費者（SPSC）環形緩衝區，編譯期固定容量 CAP（2 的冪次）。
      * 完全無鎖（0lock）實現，使用自旋等待取代 mutex/condition_variable。
      * 支援零拷貝多段讀寫、診斷日誌、版本號保護。
+     * Storage 決定底層記憶體：InlineRingStorage (預設) 或 MirroredRingStorage (單段連續讀寫)。
      * C++17 相容。
      */
-    template <size_t CAP>
+    template <size_t CAP, typename Storage = InlineRingStorage<CAP>>
     class RingBuffer
     {
         static_assert(CAP > 0, "CAP 必須大於 0");
@@ -46,20 +151,14 @@ namespace finance::infrastructure::network
             size_t length;
         };
 
-        // 代表一個封包的兩段記憶體
-        struct PacketSeg
-        {
-            const char *ptr1;
-            size_t len1;
-            const char *ptr2;
-            size_t len2;
-            size_t totalLen() const noexcept { return len1 + len2; }
-        };
+        // 代表一個封包的記憶體：鏡像儲存為單段 PacketSpan，一般儲存為可能跨越環界的 SplitPacketSeg
+        using PacketSeg = std::conditional_t<Storage::IS_MIRRORED, PacketSpan, SplitPacketSeg>;
 
-        RingBuffer() noexcept
+        RingBuffer() noexcept(std::is_nothrow_default_constructible_v<Storage>)
             : head_(0), tail_(0), clearGen_(0)
         {
-            LOG_F(INFO, "RingBuffer<%zu> constructed (0lock)", CAP);
+            LOG_F(INFO, "RingBuffer<%zu> constructed (0lock%s, delimiter scan: %s)", CAP,
+                  isMirrored() ? ", mirrored" : "", DelimiterScanner::isaName());
         }
 
         RingBuffer(const RingBuffer &) = delete;
@@ -76,6 +175,9 @@ namespace finance::infrastructure::network
         /// 環形緩衝區總容量 (實際可用容量是 CAP - 1)
         static constexpr size_t capacity() noexcept { return CAP; }
 
+        /// 是否為鏡像儲存 (所有讀寫區段皆為單段連續)
+        static constexpr bool isMirrored() noexcept { return Storage::IS_MIRRORED; }
+
         /// 是否為空
         [[nodiscard]]
         bool empty() const noexcept
@@ -113,12 +215,11 @@ namespace finance::infrastructure::network
 
             // 3) 計算總可用空間 (注意這裡和 free_space() 計算方式稍有不同，以便計算第一段長度)
             size_t totalFree = (h + CAP - t - 1) & Mask;
-            // 4) 計算第一段連續可寫長度，不跨界
+            // 4) 計算第一段連續可寫長度，不跨界 (鏡像儲存則整段可寫)
             size_t idx = t & Mask;
-            size_t first = CAP - idx;
-            maxLen = totalFree < first ? totalFree : first;
+            maxLen = contiguousFrom(idx, totalFree);
 
-            return buffer_ + idx;
+            return storage_.data() + idx;
         }
 
         /**
@@ -160,6 +261,10 @@ namespace finance::infrastructure::network
             tail_.store(tail_.load(std::memory_order_relaxed) + n,
                         std::memory_order_release);
 
+            // 只有在消費者確實休眠時才進行喚醒 syscall
+            if (waitMode_.load(std::memory_order_relaxed) == WaitMode::SpinPark)
+                parking_.unparkIfParked();
+
             // RingBuffer 滿的邏輯已經改由 waitForSpace 處理，這裡不再需要檢查並拋出異常
             // 原始的 if (n > avail) 判斷塊被移除了。
         }
@@ -171,8 +276,8 @@ namespace finance::infrastructure::network
             size_t t = tail_.load(std::memory_order_acquire); // 需要 acquire 確保讀到最新的 tail_
             size_t total = (t - h + CAP) & Mask;
             size_t idx = h & Mask;
-            len = std::min(total, CAP - idx);
-            return {buffer_ + idx, len};
+            len = contiguousFrom(idx, total);
+            return {storage_.data() + idx, len};
         }
 
         /// peek 第二段資料（跨環界後部分）
@@ -182,11 +287,11 @@ namespace finance::infrastructure::network
             size_t t = tail_.load(std::memory_order_acquire); // 需要 acquire 確保讀到最新的 tail_
             size_t total = (t - h + CAP) & Mask;
             size_t idx = h & Mask;
-            size_t len1 = std::min(total, CAP - idx);
+            size_t len1 = contiguousFrom(idx, total);
             // 如果 firstLen 大於第一段的實際長度，或者總長度就只有第一段，那麼第二段長度為 0
             size_t wrap = (firstLen < total) ? (total - len1) : 0;
 
-            return {buffer_, wrap};
+            return {storage_.data(), wrap};
         }
 
         /**
@@ -200,14 +305,15 @@ namespace finance::infrastructure::network
             if (total == 0)
                 return false;
 
+            const char *buffer = storage_.data();
             size_t idx = h & Mask;
-            size_t len1 = std::min(total, CAP - idx);
+            size_t len1 = contiguousFrom(idx, total);
             // 在第一段尋找 '\\n'
             if (auto p = static_cast<const char *>(
-                    std::memchr(buffer_ + idx, '\n', len1)))
+                    std::memchr(buffer + idx, '\n', len1)))
             {
                 ref.offset = h;
-                ref.length = (p - (buffer_ + idx)) + 1;
+                ref.length = (p - (buffer + idx)) + 1;
                 isCrossBoundary = false;
                 return true;
             }
@@ -216,10 +322,10 @@ namespace finance::infrastructure::network
             if (wrap > 0)
             {
                 if (auto q = static_cast<const char *>(
-                        std::memchr(buffer_, '\n', wrap)))
+                        std::memchr(buffer, '\n', wrap)))
                 {
                     ref.offset = h;
-                    ref.length = len1 + (q - buffer_) + 1;
+                    ref.length = len1 + (q - buffer) + 1;
                     isCrossBoundary = true;
                     return true;
                 }
@@ -297,15 +403,51 @@ namespace finance::infrastructure::network
         }
 
         /**
-         * 自旋等待直到有資料
+         * 依等待策略等待直到有資料
          */
         void waitForData() const noexcept
         {
-            while (empty())
+            while (!waitRound([this]
+                              { return head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_seq_cst); }))
             {
-                cpu_pause(); // 使用 cpu_pause 進行忙等
             }
-            // LOG_F(DEBUG, "waitForData: data available.");
+        }
+
+        /**
+         * 消費者依等待策略等待一輪，直到 tail_ 超過最近一次 getNextPackets() 看到的位置。
+         * 緩衝區只有不完整封包時也會等待，不會反覆重新掃描。
+         * @return true 表示有新資料；false 表示本輪等待結束 (逾時或被喚醒) 仍無新資料，呼叫端可檢查是否應結束
+         */
+        bool waitForNewData() noexcept
+        {
+            size_t seen = batchTail_;
+            return waitRound([this, seen]
+                             { return tail_.load(std::memory_order_seq_cst) != seen; });
+        }
+
+        /// 設定消費者等待策略，可在執行期間由其他執行緒呼叫
+        void setWaitPolicy(const WaitPolicy &policy) noexcept
+        {
+            spinCount_.store(policy.spinCount, std::memory_order_relaxed);
+            yieldCount_.store(policy.yieldCount, std::memory_order_relaxed);
+            parkTimeoutMs_.store(policy.parkTimeoutMs, std::memory_order_relaxed);
+            waitMode_.store(policy.mode, std::memory_order_relaxed);
+            // 從 SpinPark 切換到其他模式時，喚醒可能正在休眠的消費者
+            parking_.unpark();
+        }
+
+        WaitPolicy waitPolicy() const noexcept
+        {
+            return WaitPolicy{waitMode_.load(std::memory_order_relaxed),
+                              spinCount_.load(std::memory_order_relaxed),
+                              yieldCount_.load(std::memory_order_relaxed),
+                              parkTimeoutMs_.load(std::memory_order_relaxed)};
+        }
+
+        /// 無條件喚醒休眠中的消費者 (例如停止服務時)
+        void wakeConsumer() noexcept
+        {
+            parking_.unpark();
         }
 
         /**
@@ -335,8 +477,8 @@ namespace finance::infrastructure::network
         }
 
         /**
-         * 讀取完整封包的兩段連續記憶體區塊
-         * @return 若找到完整封包則回傳兩段區塊，否則回傳 nullopt
+         * 讀取下一個完整封包 (鏡像儲存為單段，一般儲存跨越環界時為兩段)
+         * @return 若找到完整封包則回傳其記憶體區段，否則回傳 nullopt
          */
         std::optional<PacketSeg> getNextPacket() const noexcept
         {
@@ -348,10 +490,11 @@ namespace finance::infrastructure::network
             if (total == 0)
                 return std::nullopt; // 緩衝區為空
 
-            // 2) 計算第一段可讀起點與長度
+            // 2) 計算第一段可讀起點與長度 (鏡像儲存時第一段即為全部資料)
+            const char *buffer = storage_.data();
             size_t idx = h & Mask;
-            size_t len1 = std::min(total, CAP - idx); // 第一段連續可讀的長度
-            const char *p1 = buffer_ + idx;
+            size_t len1 = contiguousFrom(idx, total); // 第一段連續可讀的長度
+            const char *p1 = buffer + idx;
 
             // 3) 在第一段找 '\\n'
             if (auto p = static_cast<const char *>(std::memchr(p1, '\n', len1)))
@@ -366,23 +509,26 @@ namespace finance::infrastructure::network
                     // 這裡返回 nullopt 或觸發錯誤處理。
                     return std::nullopt; // 或拋出異常
                 }
-                return PacketSeg{p1, packetLen, nullptr, 0}; // 封包在第一段
+                return segmentAt(h, packetLen); // 封包在第一段
             }
 
-            // 4) 如果第一段沒有找到 '\\n'，並且有跨界數據，在第二段找 '\\n'
-            size_t wrap = total - len1; // 第二段的長度 (如果 RingBuffer 跨界)
-            if (wrap > 0)
+            // 4) 如果第一段沒有找到 '\\n'，並且有跨界數據，在第二段找 '\\n' (鏡像儲存沒有第二段)
+            if constexpr (!Storage::IS_MIRRORED)
             {
-                if (auto q = static_cast<const char *>(std::memchr(buffer_, '\n', wrap)))
+                size_t wrap = total - len1; // 第二段的長度 (如果 RingBuffer 跨界)
+                if (wrap > 0)
                 {
-                    size_t packetLen = len1 + (q - buffer_) + 1; // 總長度 = 第一段長度 + 第二段中到 '\\n' 的長度 + 1
-                    // 驗證封包長度是否合理
-                    if (packetLen > total)
+                    if (auto q = static_cast<const char *>(std::memchr(buffer, '\n', wrap)))
                     {
-                        LOG_F(FATAL, "getNextPacket logic error: packetLen %zu > total %zu in second segment search.", packetLen, total);
-                        return std::nullopt;
+                        size_t packetLen = len1 + (q - buffer) + 1; // 總長度 = 第一段長度 + 第二段中到 '\\n' 的長度 + 1
+                        // 驗證封包長度是否合理
+                        if (packetLen > total)
+                        {
+                            LOG_F(FATAL, "getNextPacket logic error: packetLen %zu > total %zu in second segment search.", packetLen, total);
+                            return std::nullopt;
+                        }
+                        return segmentAt(h, packetLen); // 封包跨越兩段
                     }
-                    return PacketSeg{p1, len1, buffer_, packetLen - len1}; // 封包跨越兩段
                 }
             }
 
@@ -391,6 +537,73 @@ namespace finance::infrastructure::network
             return std::nullopt; // 沒有找到完整的封包
         }
 
+        /**
+         * 一次掃描取出目前緩衝區中所有完整封包 (最多 maxCount 個)，僅由消費者呼叫。
+         * 整批只讀取一次 tail_ (acquire)；處理完後以 dequeueBatch() 一次發佈 head_ (release)。
+         * 分隔符以 DelimiterScanner 逐 64 字節區塊比對，並記住已掃描到的位置：
+         * 尚未收齊的大封包在下一次呼叫時只會掃描新到的資料，不會重複掃描。
+         * @param out 輸出陣列，至少可容納 maxCount 個 PacketSeg
+         * @param maxCount 最多取出的封包數
+         * @param batchBytes 輸出：這批封包的總長度，處理完畢後傳給 dequeueBatch()
+         * @return 取出的封包數，0 表示沒有完整封包
+         */
+        size_t getNextPackets(PacketSeg *out, size_t maxCount, size_t &batchBytes) noexcept
+        {
+            size_t h = head_.load(std::memory_order_relaxed);
+            size_t t = tail_.load(std::memory_order_acquire);
+            batchTail_ = t;
+
+            // [scanFrom_, scanCursor_) 已確認沒有分隔符；head 未退回 scanFrom_ 之前就能從 scanCursor_ 接續
+            size_t scanPos = (h >= scanFrom_) ? std::max(h, scanCursor_) : h;
+            size_t pos = h;
+            size_t count = 0;
+            const char *buffer = storage_.data();
+
+            while (scanPos != t && count < maxCount)
+            {
+                // 鏡像儲存一次掃完；一般儲存在環界處分成兩次
+                size_t idx = scanPos & Mask;
+                size_t chunk = contiguousFrom(idx, t - scanPos);
+                size_t base = scanPos;
+                size_t stop = DelimiterScanner::scan(buffer + idx, chunk, '\n', [&](size_t off)
+                                                     {
+                                                         size_t end = base + off + 1;
+                                                         out[count++] = segmentAt(pos, end - pos);
+                                                         pos = end;
+                                                         return count < maxCount; });
+                scanPos = base + stop;
+            }
+
+            scanFrom_ = pos;
+            scanCursor_ = scanPos;
+            batchBytes = pos - h;
+            return count;
+        }
+
+        /**
+         * 一次釋放 getNextPackets() 取出的整批封包，只發佈一次 head_。
+         * 以 getNextPackets() 讀到的 tail 快照驗證長度，正常路徑不需再讀取 tail_。
+         */
+        void dequeueBatch(size_t bytes)
+        {
+            if (bytes == 0)
+                return;
+            size_t h = head_.load(std::memory_order_relaxed);
+            if (bytes > batchTail_ - h)
+            {
+                // 快照過舊 (例如未先呼叫 getNextPackets)，重新讀取一次 tail_
+                batchTail_ = tail_.load(std::memory_order_acquire);
+                if (bytes > batchTail_ - h)
+                {
+                    LOG_F(ERROR,
+                          "dequeueBatch underflow: need=%zu avail=%zu head=%zu tail=%zu gen=%" PRIu64,
+                          bytes, batchTail_ - h, h, batchTail_, generation());
+                    throw std::underflow_error("RingBuffer underflow on dequeueBatch");
+                }
+            }
+            head_.store(h + bytes, std::memory_order_release);
+        }
+
         // 提供公有方法來讀取 head_ 和 tail_ 的值（僅讀取）
         size_t getHead(std::memory_order order = std::memory_order_relaxed) const noexcept
         {
@@ -406,14 +619,94 @@ namespace finance::infrastructure::network
         static constexpr size_t Mask = CAP - 1;
         static constexpr size_t CACHELINE_SIZE = 64; // 通常為 64 字節
 
-        // RingBuffer 緩衝區，使用 alignas 確保在快取行邊界對齊
-        alignas(CACHELINE_SIZE) char buffer_[CAP];
+        /// 從 idx 開始、最多 avail 字節中可連續存取的長度
+        static constexpr size_t contiguousFrom(size_t idx, size_t avail) noexcept
+        {
+            if constexpr (Storage::IS_MIRRORED)
+                return avail;
+            else
+                return std::min(avail, CAP - idx);
+        }
+
+        /**
+         * 依等待策略等待一輪：忙等 spinCount 次，再 yield yieldCount 次，最後在 futex 上休眠。
+         * @return ready() 是否成立
+         */
+        template <typename Ready>
+        bool waitRound(Ready &&ready) const noexcept
+        {
+            const WaitMode mode = waitMode_.load(std::memory_order_relaxed);
+            const uint32_t spins = spinCount_.load(std::memory_order_relaxed);
+            for (uint32_t i = 0; i < spins; ++i)
+            {
+                if (ready())
+                    return true;
+                cpu_pause();
+            }
+            if (mode == WaitMode::BusySpin)
+                return ready();
+
+            const uint32_t yields = yieldCount_.load(std::memory_order_relaxed);
+            for (uint32_t i = 0; i < yields; ++i)
+            {
+                if (ready())
+                    return true;
+                std::this_thread::yield();
+            }
+            if (mode == WaitMode::SpinYield)
+                return ready();
+
+            // 先標記休眠再重新檢查，與生產者 enqueue() 中的 unparkIfParked() 配對，不會漏掉喚醒
+            uint32_t seq = parking_.prepare();
+            if (ready())
+            {
+                parking_.cancel();
+                return true;
+            }
+            parking_.park(seq, parkTimeoutMs_.load(std::memory_order_relaxed));
+            return ready();
+        }
+
+        /// 從絕對位置 pos 開始、長度 len 的封包區段
+        PacketSeg segmentAt(size_t pos, size_t len) const noexcept
+        {
+            const char *buffer = storage_.data();
+            size_t idx = pos & Mask;
+            if constexpr (Storage::IS_MIRRORED)
+            {
+                return PacketSeg{buffer + idx, len};
+            }
+            else
+            {
+                size_t len1 = contiguousFrom(idx, len);
+                return PacketSeg{buffer + idx, len1, len1 < len ? buffer : nullptr, len - len1};
+            }
+        }
+
+        // RingBuffer 底層儲存
+        Storage storage_;
         // 頭部指針，原子操作，表示下一個要讀取的數據位置 (消費者修改)
         alignas(CACHELINE_SIZE) std::atomic<size_t> head_;
         // 尾部指針，原子操作，表示下一個要寫入的數據位置 (生產者修改)
         alignas(CACHELINE_SIZE) std::atomic<size_t> tail_;
         // 清空操作版本號，用於診斷（可選）
         std::atomic<uint64_t> clearGen_;
+        // 消費者等待策略與休眠點
+        alignas(CACHELINE_SIZE) mutable ParkingSpot parking_;
+        std::atomic<WaitMode> waitMode_{WaitPolicy{}.mode};
+        std::atomic<uint32_t> spinCount_{WaitPolicy{}.spinCount};
+        std::atomic<uint32_t> yieldCount_{WaitPolicy{}.yieldCount};
+        std::atomic<uint32_t> parkTimeoutMs_{WaitPolicy{}.parkTimeoutMs};
+        // 以下僅由消費者存取
+        // 最近一次 getNextPackets() 讀到的 tail
+        size_t batchTail_ = 0;
+        // 分隔符掃描進度：[scanFrom_, scanCursor_) 已掃描且沒有 '\n'
+        size_t scanFrom_ = 0;
+        size_t scanCursor_ = 0;
     };
 
+    /// 以鏡像儲存實作的 RingBuffer，getNextPacket() 永遠回傳單段封包
+    template <size_t CAP>
+    using MirroredRingBuffer = RingBuffer<CAP, MirroredRingStorage<CAP>>;
+
 } // namespace finance::infrastructure::network
@@ -3,7 +3,7 @@
 #include <memory>
 #include <thread>
 #include <atomic>
-#include <vector>  // Required for consumer's tmp buffer
+#include <vector>
 #include <cstring> // For strerror, memset
 #include <cerrno>  // For errno
 
@@ -13,21 +13,84 @@
 #include <arpa/inet.h>
 #include <unistd.h> // For close()
 #include <fcntl.h>  // For fcntl() if using non-blocking sockets
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <pthread.h> // pthread_setaffinity_np
+#include <sched.h>
+#include <unordered_map>
+#include <optional>
+#include <string>
 
 #include "RingBuffer.hpp"
+#include "PacketConflator.hpp"
+#include "PacketRouter.hpp"
 #include "infrastructure/config/ConnectionConfigProvider.hpp"
+#include "infrastructure/storage/PacketJournal.hpp"
 #include "domain/IPackageHandler.hpp"
 #include "domain/IFinanceRepository.hpp"
 #include "domain/FinanceDataStructure.hpp"
-#include "infrastructure/tasks/RedisWorker.hpp"
 #include "utils/FinanceUtils.hpp" // Not directly used in this file but kept for context
 #include <loguru.hpp>
 
 namespace finance::infrastructure::network
 {
     static constexpr size_t RING_BUFFER_SIZE = 16 * 1024 * 1024; // 16MB
+    // 分片模式下每個 shard 各自的 RingBuffer
+    static constexpr size_t SHARD_RING_BUFFER_SIZE = 4 * 1024 * 1024; // 4MB
     // Backlog for listen()
     static constexpr int SOCKET_LISTEN_BACKLOG = SOMAXCONN; // Or a specific number like 128
+    // 單次 epoll_wait 最多取回的事件數
+    static constexpr int MAX_EPOLL_EVENTS = 64;
+    // 每條連線的接收暫存區大小 (需大於單一封包長度)
+    static constexpr size_t CONNECTION_BUFFER_SIZE = 64 * 1024;
+    // consumer 每批最多取出的封包數 (需足以一次框出單次 recv 的 64KB 資料)
+    static constexpr size_t CONSUMER_BATCH_SIZE = 1024;
+    // 接收暫存區尾端的保留空間：解碼器會讀取到 sizeof(FinancePackageMessage) 為止，
+    // 封包直接在暫存區處理 (run-to-completion) 時，位於暫存區末端的短封包也不會讀出界
+    static constexpr size_t CONNECTION_BUFFER_SLACK = sizeof(domain::FinancePackageMessage);
+
+    /**
+     * 封包處理管線的執行緒配置
+     * - Split:           recv/分包在 producer thread，經 RingBuffer 交給 consumer thread 解碼與套用；
+     *                    recv 與處理互相重疊，吞吐量較高，可在積壓時合併 HCRTM01
+     * - RunToCompletion: 單一 thread 依序 recv → 分包 → 解碼 → 套用 → 投遞非同步 Redis 任務，
+     *                    關鍵路徑上沒有跨 thread 交接，延遲最低；可綁定到指定 CPU
+     * - Sharded:         producer 分包後依股票代號 (PacketRouter) 把封包送到 N 個 shard 各自的 SPSC RingBuffer，
+     *                    每個 shard thread 獨立解碼與套用；shard、快取分區與 Redis 寫入通道使用同一個分派函式，
+     *                    套用的吞吐量可隨核心數擴充 (例如開盤時的大量封包)
+     */
+    enum class PipelineMode
+    {
+        Split,
+        RunToCompletion,
+        Sharded
+    };
+
+    /// 由設定字串 ("split" / "run_to_completion" / "sharded") 取得 PipelineMode
+    inline std::optional<PipelineMode> pipelineModeFromString(const std::string &name) noexcept
+    {
+        if (name == "split")
+            return PipelineMode::Split;
+        if (name == "run_to_completion")
+            return PipelineMode::RunToCompletion;
+        if (name == "sharded")
+            return PipelineMode::Sharded;
+        return std::nullopt;
+    }
+
+    inline const char *pipelineModeName(PipelineMode mode) noexcept
+    {
+        switch (mode)
+        {
+        case PipelineMode::Split:
+            return "split";
+        case PipelineMode::RunToCompletion:
+            return "run_to_completion";
+        case PipelineMode::Sharded:
+            return "sharded";
+        }
+        return "unknown";
+    }
 
     class TcpServiceAdapter
     {
@@ -37,7 +100,6 @@ namespace finance::infrastructure::network
             : serverSocketFd_(-1), // Initialize server socket descriptor to an invalid value
               handler_(std::move(handler)),
               repository_(std::move(repository)),
-              redis_worker_(std::make_unique<tasks::RedisWorker>(repository_)),
               ringBuffer_()
         {
             serverSocketFd_ = socket(AF_INET, SOCK_STREAM, 0);
@@ -80,11 +142,52 @@ namespace finance::infrastructure::network
                 throw std::runtime_error("Failed to listen on server socket: " + std::string(strerror(errno)));
             }
             LOG_F(INFO, "Server socket listening on port %d", config::ConnectionConfigProvider::serverPort());
+
+            // 監聽 socket 改為非阻塞，由 epoll 事件迴圈負責 accept
+            if (!setNonBlocking(serverSocketFd_))
+            {
+                LOG_F(FATAL, "Failed to set server socket non-blocking: %s", strerror(errno));
+                close(serverSocketFd_);
+                throw std::runtime_error("Failed to set server socket non-blocking: " + std::string(strerror(errno)));
+            }
+
+            epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+            wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (epollFd_ < 0 || wakeFd_ < 0 ||
+                !addToEpoll(serverSocketFd_, EPOLLIN | EPOLLET) ||
+                !addToEpoll(wakeFd_, EPOLLIN))
+            {
+                LOG_F(FATAL, "Failed to set up epoll: %s", strerror(errno));
+                closeEventFds();
+                close(serverSocketFd_);
+                throw std::runtime_error("Failed to set up epoll: " + std::string(strerror(errno)));
+            }
+
+            WaitPolicy policy;
+            auto mode = waitModeFromString(config::ConnectionConfigProvider::consumerWaitMode());
+            if (mode)
+                policy.mode = *mode;
+            else
+                LOG_F(WARNING, "Unknown consumer_wait_mode '%s', using %s",
+                      config::ConnectionConfigProvider::consumerWaitMode().c_str(), waitModeName(policy.mode));
+            policy.spinCount = config::ConnectionConfigProvider::consumerSpinCount();
+            policy.yieldCount = config::ConnectionConfigProvider::consumerYieldCount();
+            policy.parkTimeoutMs = config::ConnectionConfigProvider::consumerParkTimeoutMs();
+            setWaitPolicy(policy);
+
+            auto pipeline = pipelineModeFromString(config::ConnectionConfigProvider::pipelineMode());
+            if (!pipeline)
+                LOG_F(WARNING, "Unknown pipeline_mode '%s', using %s",
+                      config::ConnectionConfigProvider::pipelineMode().c_str(), pipelineModeName(pipelineMode_));
+            // shard 數與 Redis 寫入 worker 數相同，每個 shard 對應一條寫入通道與一個快取分區
+            setPipelineMode(pipeline.value_or(pipelineMode_), config::ConnectionConfigProvider::pipelineCpu(),
+                            config::ConnectionConfigProvider::redisWorkerCount());
         }
 
         ~TcpServiceAdapter()
         {
             stop();
+            releaseSockets(); // 未曾 start() 時 stop() 不會釋放 socket
         }
 
         bool start()
@@ -98,8 +201,35 @@ namespace finance::infrastructure::network
                 return false;
             }
 
+            // 每條處理 thread 一個進行中 LSN 欄位 (見 appliedLsnWatermark())，只在第一次啟動時建立
+            const size_t lanes = pipelineMode_ == PipelineMode::Sharded ? shardCount_ : 1;
+            if (journal_ && inFlightLsn_.size() != lanes)
+                inFlightLsn_ = std::vector<std::atomic<uint64_t>>(lanes);
+
             running_ = true;
-            redis_worker_->start();
+            if (pipelineMode_ == PipelineMode::RunToCompletion)
+            {
+                // 單一 thread 完成整條管線，不啟動 consumer
+                acceptThread_ = std::thread(&TcpServiceAdapter::runToCompletion, this);
+                return true;
+            }
+            if (pipelineMode_ == PipelineMode::Sharded)
+            {
+                // 先啟動 shard 再開始收資料；RingBuffer 只在第一次啟動時建立
+                if (shardRings_.size() != shardCount_)
+                {
+                    shardRings_.clear();
+                    for (size_t i = 0; i < shardCount_; ++i)
+                    {
+                        shardRings_.push_back(std::make_unique<ShardRing>());
+                        shardRings_.back()->setWaitPolicy(waitPolicy_);
+                    }
+                }
+                for (size_t i = 0; i < shardCount_; ++i)
+                    shardThreads_.emplace_back(&TcpServiceAdapter::shardConsumer, this, i);
+                acceptThread_ = std::thread(&TcpServiceAdapter::producer, this);
+                return true;
+            }
             acceptThread_ = std::thread(&TcpServiceAdapter::producer, this);
             processingThread_ = std::thread(&TcpServiceAdapter::consumer, this);
             return true;
@@ -121,30 +251,23 @@ namespace finance::infrastructure::network
                     acceptThread_.join();
                 if (processingThread_.joinable() && processingThread_.get_id() != std::this_thread::get_id())
                     processingThread_.join();
+                joinShardThreads();
                 return;
             }
 
             LOG_F(INFO, "TcpServiceAdapter: Initiating stop sequence...");
 
-            if (serverSocketFd_ >= 0)
+            // 喚醒阻塞在 epoll_wait 的 producer，令其檢查 running_ 後退出
+            if (wakeFd_ >= 0)
             {
-                LOG_F(INFO, "TcpServiceAdapter: Shutting down and closing server socket fd: %d", serverSocketFd_);
-                // Shutdown first to break any blocking calls on the socket.
-                // SHUT_RD will prevent further reads on the socket, helping accept() to unblock.
-                if (shutdown(serverSocketFd_, SHUT_RD) < 0)
-                { // SHUT_RD is often enough to unblock accept
-                    LOG_F(WARNING, "TcpServiceAdapter: shutdown(serverSocketFd_, SHUT_RD) failed: %s", strerror(errno));
-                }
-                if (close(serverSocketFd_) < 0)
+                uint64_t one = 1;
+                if (write(wakeFd_, &one, sizeof(one)) < 0)
                 {
-                    LOG_F(WARNING, "TcpServiceAdapter: close(serverSocketFd_) failed: %s", strerror(errno));
+                    LOG_F(WARNING, "TcpServiceAdapter: write(wakeFd_) failed: %s", strerror(errno));
                 }
-                serverSocketFd_ = -1;
             }
 
-            redis_worker_->stop();
-
-            // producer thread should exit as running_ is false and accept() unblocks.
+            // producer thread should exit as running_ is false and epoll_wait() unblocks.
             if (acceptThread_.joinable())
             {
                 LOG_F(INFO, "TcpServiceAdapter: Joining accept thread...");
@@ -152,92 +275,128 @@ namespace finance::infrastructure::network
                 LOG_F(INFO, "TcpServiceAdapter: Accept thread joined.");
             }
 
-            // consumer thread should exit as running_ is false.
-            // RingBuffer::waitForData() is a spin lock but consumer's outer loop checks running_.
+            // producer 已退出，可安全關閉所有客戶端連線與監聽 socket
+            releaseSockets();
+
+            // consumer thread should exit as running_ is false; wake it if it is parked.
+            ringBuffer_.wakeConsumer();
             if (processingThread_.joinable())
             {
                 LOG_F(INFO, "TcpServiceAdapter: Joining processing thread...");
                 processingThread_.join();
                 LOG_F(INFO, "TcpServiceAdapter: Processing thread joined.");
             }
+            for (auto &ring : shardRings_)
+                ring->wakeConsumer();
+            joinShardThreads();
             LOG_F(INFO, "TcpServiceAdapter: Stop sequence completed.");
         }
 
         void consumer()
         {
             LOG_F(INFO, "Consumer thread started (Asynchronous Redis processing).");
-            std::vector<char> tmp;
-            tmp.reserve(sizeof(domain::FinancePackageMessage) + 100);
-
-            while (running_.load())
-            {
-                if (ringBuffer_.empty())
-                {
-                    if (!running_.load())
-                    {
-                        break;
-                    }
-                    std::this_thread::yield();
-                    continue;
-                }
+            drainRing(ringBuffer_, 0);
+            LOG_F(INFO, "Consumer thread stopped.");
+        }
 
-                if (!running_.load())
-                    break;
+        /// 分片模式：第 index 個 shard 只處理分派到自己 RingBuffer 的封包
+        void shardConsumer(size_t index)
+        {
+            LOG_F(INFO, "Shard %zu/%zu thread started.", index, shardCount_);
+            drainRing(*shardRings_[index], index);
+            LOG_F(INFO, "Shard %zu/%zu thread stopped.", index, shardCount_);
+        }
 
-                auto segOpt = ringBuffer_.getNextPacket();
-                if (!segOpt)
-                {
-                    if (!running_.load())
-                    {
-                        break;
-                    }
-                    std::this_thread::yield();
-                    continue;
-                }
+        /**
+         * run-to-completion 模式：同一個 thread 執行 epoll 事件迴圈，
+         * 收到的完整封包直接在連線暫存區中解碼與套用 (見 forwardCompletePackets)，不經過 RingBuffer。
+         */
+        void runToCompletion()
+        {
+            LOG_F(INFO, "Run-to-completion thread started (cpu %d).", pipelineCpu_);
+            if (pipelineCpu_ >= 0)
+            {
+                cpu_set_t cpus;
+                CPU_ZERO(&cpus);
+                CPU_SET(pipelineCpu_, &cpus);
+                int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+                if (rc != 0)
+                    LOG_F(WARNING, "Run-to-completion: Failed to pin thread to cpu %d: %s", pipelineCpu_, strerror(rc));
+            }
+            if (config::ConnectionConfigProvider::conflationThresholdBytes() > 0)
+                LOG_F(WARNING, "Run-to-completion: conflation_threshold_bytes is ignored, packets are never backlogged.");
 
-                auto seg = *segOpt;
+            eventLoop();
+            LOG_F(INFO, "Run-to-completion thread stopped.");
+        }
 
-                if (seg.totalLen() <= 3)
-                {
-                    LOG_F(INFO, "Consumer: Dropping potential keep alive packet with size %zu", seg.totalLen());
-                    ringBuffer_.dequeue(seg.totalLen());
-                    continue;
-                }
+        /**
+         * 設定封包處理管線，只能在 start() 之前呼叫。
+         * @param cpu run-to-completion thread 綁定的 CPU，負數表示不綁定
+         * @param shards 分片模式的 shard 數 (至少 1)
+         */
+        bool setPipelineMode(PipelineMode mode, int cpu = -1, size_t shards = 1) noexcept
+        {
+            if (running_.load())
+                return false;
+            pipelineMode_ = mode;
+            pipelineCpu_ = cpu;
+            shardCount_ = shards == 0 ? 1 : shards;
+            LOG_F(INFO, "TcpServiceAdapter: pipeline mode set to %s (cpu %d, shards %zu)", pipelineModeName(mode), cpu, shardCount_);
+            return true;
+        }
 
-                const domain::FinancePackageMessage *pkg = nullptr;
-                if (seg.len2 == 0)
-                {
-                    pkg = reinterpret_cast<const domain::FinancePackageMessage *>(seg.ptr1);
-                }
-                else
-                {
-                    tmp.clear();
-                    if (tmp.capacity() < seg.totalLen())
-                    {
-                        tmp.reserve(seg.totalLen() + 100);
-                    }
-                    tmp.resize(seg.totalLen());
-                    std::memcpy(tmp.data(), seg.ptr1, seg.len1);
-                    std::memcpy(tmp.data() + seg.len1, seg.ptr2, seg.len2);
-                    pkg = reinterpret_cast<const domain::FinancePackageMessage *>(tmp.data());
-                }
+        PipelineMode pipelineMode() const noexcept { return pipelineMode_; }
 
-                auto res = handler_->handle(*pkg);
-                if (res.is_err())
-                {
-                    LOG_F(ERROR, "Consumer: Packet handling/task submission failed for packet size %zu: %s",
-                          seg.totalLen(), res.unwrap_err().message.c_str());
-                }
-                else
-                {
-                    LOG_F(INFO, "Consumer: Packet processed and async Redis tasks submitted for packet size %zu.",
-                          seg.totalLen());
-                }
+        /**
+         * 啟用封包日誌，只能在 start() 之前呼叫：每個通過 keep alive 檢查且未被合併的封包在交給 handler 之前先附加到日誌。
+         */
+        bool setJournal(std::shared_ptr<storage::PacketJournal> journal) noexcept
+        {
+            if (running_.load())
+                return false;
+            journal_ = std::move(journal);
+            return true;
+        }
 
-                ringBuffer_.dequeue(seg.totalLen());
+        /**
+         * 已套用到快取的封包日誌 LSN 水位：所有 LSN <= 水位的封包都已由 handler 處理完畢。
+         * 取日誌最後一筆與各處理 thread 進行中封包 LSN - 1 的較小值 (保守估計，重播時可能重複套用少數封包，
+         * H01/H05P 以絕對值覆寫，重複套用結果相同)。handler 在清除進行中 LSN 前已於自己的 thread 發佈快取並寫入快取檔，
+         * Redis worker 佇列中尚未處理的同步任務不影響水位。可由任意 thread 在 start() 之後呼叫；未啟用日誌時為 0。
+         */
+        uint64_t appliedLsnWatermark() const noexcept
+        {
+            if (!journal_)
+                return 0;
+            // 先讀 lastLsn：append() 在 LSN 對外可見之前已寫入進行中欄位
+            uint64_t watermark = journal_->lastLsn();
+            for (const auto &lane : inFlightLsn_)
+            {
+                const uint64_t lsn = lane.load(std::memory_order_acquire);
+                if (lsn != 0 && lsn - 1 < watermark)
+                    watermark = lsn - 1;
             }
+            return watermark;
+        }
 
-            LOG_F(INFO, "Consumer thread stopped.");
+        /**
+         * 設定 consumer 的等待策略，只能在 start() 之前呼叫：start() 會讀取 waitPolicy_ 並建立分片 RingBuffer，
+         * 執行期間呼叫會與 consumer / shard thread 競爭，因此回傳 false 且不變更。
+         */
+        bool setWaitPolicy(const WaitPolicy &policy) noexcept
+        {
+            if (running_.load())
+                return false;
+            waitPolicy_ = policy;
+            ringBuffer_.setWaitPolicy(policy);
+            for (auto &ring : shardRings_)
+                ring->setWaitPolicy(policy);
+            // run-to-completion 沒有 consumer 可等待：busy_spin 時改為以 epoll_wait(0) 輪詢
+            busyPoll_.store(policy.mode == WaitMode::BusySpin, std::memory_order_relaxed);
+            LOG_F(INFO, "TcpServiceAdapter: consumer wait policy set to %s (spin=%u, yield=%u, park timeout=%u ms)",
+                  waitModeName(policy.mode), policy.spinCount, policy.yieldCount, policy.parkTimeoutMs);
+            return true;
         }
 
         void wait()
@@ -250,9 +409,22 @@ namespace finance::infrastructure::network
             {
                 processingThread_.join();
             }
+            joinShardThreads();
         }
 
     private:
+        using ShardRing = MirroredRingBuffer<SHARD_RING_BUFFER_SIZE>;
+
+        void joinShardThreads()
+        {
+            for (auto &thread : shardThreads_)
+            {
+                if (thread.joinable() && thread.get_id() != std::this_thread::get_id())
+                    thread.join();
+            }
+            shardThreads_.clear();
+        }
+
         std::string getPeerAddress(const sockaddr_in &addr)
         {
             char ipStr[INET_ADDRSTRLEN];
@@ -260,197 +432,438 @@ namespace finance::infrastructure::network
             return std::string(ipStr) + ":" + std::to_string(ntohs(addr.sin_port));
         }
 
-        // TcpServiceAdapter.hpp - producer() method
+        // 非阻塞 socket 設定
+        static bool setNonBlocking(int fd) noexcept
+        {
+            int flags = fcntl(fd, F_GETFL, 0);
+            return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) >= 0;
+        }
+
+        bool addToEpoll(int fd, uint32_t events) noexcept
+        {
+            epoll_event ev{};
+            ev.events = events;
+            ev.data.fd = fd;
+            return epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) == 0;
+        }
+
+        void closeEventFds() noexcept
+        {
+            if (epollFd_ >= 0)
+            {
+                close(epollFd_);
+                epollFd_ = -1;
+            }
+            if (wakeFd_ >= 0)
+            {
+                close(wakeFd_);
+                wakeFd_ = -1;
+            }
+        }
+
+        /**
+         * @brief 單一上游連線的狀態
+         * @details 每條連線各自保存尚未收到 '\n' 的殘段，只有完整封包才會寫入 RingBuffer，
+         * 因此多條連線的資料不會在 RingBuffer 中交錯成半個封包。
+         */
+        struct ClientConnection
+        {
+            int fd = -1;
+            std::string peer;
+            std::vector<char> pending; // 接收暫存區
+            size_t pendingLen = 0;     // 暫存區中尚未成包的位元組數
+        };
+
+        /**
+         * conflation_threshold_bytes 以 split 模式的 RingBuffer (RING_BUFFER_SIZE) 為準，依 ring 容量等比例換算：
+         * 分片模式每個 shard ring 只有 SHARD_RING_BUFFER_SIZE，積壓佔容量的比例與 split 模式相同時才開始合併。
+         * 非 0 的門檻換算後至少為 1 位元組。
+         */
+        static size_t scaledConflationThreshold(size_t configured, size_t ringCapacity) noexcept
+        {
+            if (configured == 0)
+                return 0;
+            const size_t scaled = configured / RING_BUFFER_SIZE * ringCapacity +
+                                  configured % RING_BUFFER_SIZE * ringCapacity / RING_BUFFER_SIZE;
+            return scaled > 0 ? scaled : 1;
+        }
+
+        /**
+         * 持續取出 ring 中的完整封包並交給 handler；split 模式的 consumer 與分片模式的每個 shard 共用。
+         * 積壓超過門檻時合併同批的 HCRTM01。
+         */
+        template <typename Ring>
+        void drainRing(Ring &ring, size_t lane)
+        {
+            static_assert(Ring::isMirrored(), "drainRing() 依賴鏡像 RingBuffer 提供單段連續封包");
+
+            using PacketSeg = typename Ring::PacketSeg;
+            std::vector<PacketSeg> batch(CONSUMER_BATCH_SIZE);
+
+            // 積壓超過門檻時才合併 HCRTM01，0 表示停用；門檻依本 ring 的容量換算 (見 scaledConflationThreshold())
+            const size_t conflationThreshold =
+                scaledConflationThreshold(config::ConnectionConfigProvider::conflationThresholdBytes(), Ring::capacity());
+            PacketConflator conflator;
+            std::vector<uint8_t> skip;
+
+            while (running_.load())
+            {
+                size_t batchBytes = 0;
+                size_t count = ring.getNextPackets(batch.data(), batch.size(), batchBytes);
+                if (count == 0)
+                {
+                    // 緩衝區為空或只有不完整封包：依等待策略等待新資料
+                    ring.waitForNewData();
+                    continue;
+                }
+
+                bool conflate = conflationThreshold > 0 && ring.size() >= conflationThreshold;
+                if (conflate)
+                {
+                    size_t skipped = conflator.markSuperseded(batch.data(), count, skip);
+                    if (skipped > 0)
+                        LOG_F(INFO, "Consumer: Conflated %zu of %zu packets (backlog %zu bytes).",
+                              skipped, count, ring.size());
+                }
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    if (conflate && skip[i])
+                        continue; // 同批中已有同 (area, stock) 較新的 HCRTM01
+                    // 鏡像 RingBuffer 的封包為單段連續記憶體 (PacketSpan)，可直接零拷貝轉型
+                    handlePacket(batch[i].ptr, batch[i].len, lane);
+                }
+
+                // 整批處理完才釋放空間，每批只發佈一次 head_
+                ring.dequeueBatch(batchBytes);
+            }
+        }
+
+        // 處理單一完整封包 (含結尾 '\n')；各管線模式共用，lane 為處理 thread 的編號 (分片模式為 shard index，其餘為 0)
+        void handlePacket(const char *data, size_t len, size_t lane)
+        {
+            if (len <= 3)
+            {
+                LOG_F(INFO, "Consumer: Dropping potential keep alive packet with size %zu", len);
+                return;
+            }
+
+            const auto *pkg = reinterpret_cast<const domain::FinancePackageMessage *>(data);
+            if (journal_)
+                journal_->append(data, len, &inFlightLsn_[lane]);
+            auto res = handler_->handle(*pkg);
+            if (journal_)
+                inFlightLsn_[lane].store(0, std::memory_order_release); // 套用結果 (含快取檔) 對 appliedLsnWatermark() 可見
+            if (res.is_err())
+            {
+                LOG_F(ERROR, "Consumer: Packet handling/task submission failed for packet size %zu: %s",
+                      len, res.unwrap_err().message.c_str());
+            }
+            else
+            {
+                DLOG_F(INFO, "Consumer: Packet processed and async Redis tasks submitted for packet size %zu.", len);
+            }
+        }
+
         void producer()
         {
             LOG_F(INFO, "Producer thread started. TID: %zu. running_ initial value: %d",
                   std::hash<std::thread::id>{}(std::this_thread::get_id()),
                   running_.load(std::memory_order_relaxed));
+            eventLoop();
+            LOG_F(INFO, "Producer thread stopped. TID: %zu",
+                  std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        }
+
+        // epoll 事件迴圈：同時服務監聽 socket 與所有上游連線 (edge-triggered)
+        void eventLoop()
+        {
             try
             {
+                epoll_event events[MAX_EPOLL_EVENTS];
                 while (running_.load(std::memory_order_relaxed))
                 {
-                    sockaddr_in clientAddr;
-                    socklen_t clientAddrLen = sizeof(clientAddr);
-                    int clientSocketFd = -1;
-
-                    LOG_F(INFO, "Producer (TID: %zu): Loop top. Attempty to accept. running_=%d, serverSocketFd_=%d",
-                          std::hash<std::thread::id>{}(std::this_thread::get_id()),
-                          running_.load(std::memory_order_relaxed), serverSocketFd_);
-
-                    if (serverSocketFd_ < 0)
-                    { // 如果 socket 已經無效，直接退出
-                        LOG_F(WARNING, "Producer (TID: %zu): serverSocketFd_ is invalid (%d) before accept. Exiting.",
-                              std::hash<std::thread::id>{}(std::this_thread::get_id()), serverSocketFd_);
-                        break;
-                    }
-
-                    clientSocketFd = accept(serverSocketFd_, (struct sockaddr *)&clientAddr, &clientAddrLen);
-                    int accept_errno = errno; // Store errno immediately after accept returns
-
-                    LOG_F(INFO, "Producer (TID: %zu): accept returned %d. errno: %d (%s). running_=%d",
-                          std::hash<std::thread::id>{}(std::this_thread::get_id()),
-                          clientSocketFd, accept_errno, strerror(accept_errno),
-                          running_.load(std::memory_order_relaxed));
-
-                    if (!running_.load(std::memory_order_relaxed))
+                    const int timeout = (pipelineMode_ == PipelineMode::RunToCompletion &&
+                                         busyPoll_.load(std::memory_order_relaxed))
+                                            ? 0
+                                            : -1;
+                    int n = epoll_wait(epollFd_, events, MAX_EPOLL_EVENTS, timeout);
+                    if (n < 0)
                     {
-                        if (clientSocketFd >= 0)
-                        {
-                            LOG_F(INFO, "Producer (TID: %zu): Closing client socket %d as running_ is false.",
-                                  std::hash<std::thread::id>{}(std::this_thread::get_id()), clientSocketFd);
-                            close(clientSocketFd);
-                        }
-                        LOG_F(INFO, "Producer (TID: %zu): running_ is false after accept unblocked. Exiting main loop.",
-                              std::hash<std::thread::id>{}(std::this_thread::get_id()));
+                        if (errno == EINTR)
+                            continue;
+                        LOG_F(ERROR, "Producer: epoll_wait failed (errno %d: %s). Exiting.", errno, strerror(errno));
                         break;
                     }
 
-                    if (clientSocketFd < 0)
+                    for (int i = 0; i < n && running_.load(std::memory_order_relaxed); ++i)
                     {
-                        // EBADF or EINVAL are expected if the listening socket was closed by stop()
-                        if (accept_errno == EBADF || accept_errno == EINVAL)
+                        int fd = events[i].data.fd;
+                        if (fd == wakeFd_)
+                            continue; // stop() 的喚醒，迴圈頂端會檢查 running_
+                        if (fd == serverSocketFd_)
                         {
-                            LOG_F(INFO, "Producer (TID: %zu): accept() failed due to server socket closure (errno %d: %s). Exiting main loop.",
-                                  std::hash<std::thread::id>{}(std::this_thread::get_id()),
-                                  accept_errno, strerror(accept_errno));
-                            break;
+                            acceptPendingConnections();
+                            continue;
                         }
-                        if (accept_errno == EINTR)
-                        {
-                            LOG_F(INFO, "Producer (TID: %zu): accept() call interrupted by signal. Continuing loop to re-check running_ flag.",
-                                  std::hash<std::thread::id>{}(std::this_thread::get_id()));
+                        auto it = connections_.find(fd);
+                        if (it == connections_.end())
                             continue;
+                        if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+                        {
+                            if (!readConnection(it->second))
+                                closeConnection(fd);
                         }
-                        // For other errors, log and continue (or break if appropriate)
-                        LOG_F(ERROR, "Producer (TID: %zu): Accept connection error (errno %d: %s). Continuing.",
-                              std::hash<std::thread::id>{}(std::this_thread::get_id()),
-                              accept_errno, strerror(accept_errno));
-                        std::this_thread::sleep_for(std::chrono::milliseconds(50)); // Avoid tight loop on persistent accept errors
-                        continue;
                     }
+                }
+            }
+            catch (const std::exception &e)
+            {
+                LOG_F(ERROR, "Producer thread exception: %s", e.what());
+            }
+            catch (...)
+            {
+                LOG_F(ERROR, "Producer thread unknown exception");
+            }
+        }
 
-                    // ... (後續客戶端處理邏輯不變, 但也應包含TID日誌和running_檢查) ...
-                    LOG_F(INFO, "Producer (TID: %zu): Accepted new connection from %s on fd %d",
-                          std::hash<std::thread::id>{}(std::this_thread::get_id()),
-                          getPeerAddress(clientAddr).c_str(), clientSocketFd);
+        // edge-triggered：必須一次 accept 到 EAGAIN 為止
+        void acceptPendingConnections()
+        {
+            while (running_.load(std::memory_order_relaxed))
+            {
+                sockaddr_in clientAddr;
+                socklen_t clientAddrLen = sizeof(clientAddr);
+                int clientSocketFd = accept4(serverSocketFd_, (struct sockaddr *)&clientAddr, &clientAddrLen,
+                                             SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (clientSocketFd < 0)
+                {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK)
+                        return;
+                    if (errno == EINTR || errno == ECONNABORTED)
+                        continue;
+                    LOG_F(ERROR, "Producer: Accept connection error (errno %d: %s).", errno, strerror(errno));
+                    return;
+                }
 
-                    // TcpServiceAdapter.hpp - producer() method - Inner client handling loop excerpt
-                    // ... (accepts clientSocketFd) ...
-                    LOG_F(INFO, "Producer (TID: %zu): Accepted new connection from %s on fd %d",
-                          std::hash<std::thread::id>{}(std::this_thread::get_id()),
-                          getPeerAddress(clientAddr).c_str(), clientSocketFd);
+                if (!addToEpoll(clientSocketFd, EPOLLIN | EPOLLRDHUP | EPOLLET))
+                {
+                    LOG_F(ERROR, "Producer: Failed to register client fd %d to epoll: %s", clientSocketFd, strerror(errno));
+                    close(clientSocketFd);
+                    continue;
+                }
 
-                    // Inner client handling loop
-                    while (running_.load(std::memory_order_relaxed))
-                    {
-                        size_t maxLen;
-                        char *writePtr = ringBuffer_.writablePtr(maxLen); // 獲取 RingBuffer 的可寫入指標和長度
-
-                        if (maxLen == 0)
-                        { // 如果 RingBuffer 滿了
-                            if (!running_.load(std::memory_order_relaxed))
-                                break;
-                            LOG_F(INFO, "Producer (TID: %zu, client fd %d): RingBuffer full or no space. Yielding.",
-                                  std::hash<std::thread::id>{}(std::this_thread::get_id()), clientSocketFd);
-                            std::this_thread::yield();
-                            continue;
-                        }
+                ClientConnection &conn = connections_[clientSocketFd];
+                conn.fd = clientSocketFd;
+                conn.peer = getPeerAddress(clientAddr);
+                conn.pending.resize(CONNECTION_BUFFER_SIZE + CONNECTION_BUFFER_SLACK);
+                conn.pendingLen = 0;
+                LOG_F(INFO, "Producer: Accepted new connection from %s on fd %d (active connections: %zu)",
+                      conn.peer.c_str(), clientSocketFd, connections_.size());
+            }
+        }
 
-                        // Ensure to log TID here as well and check running_ frequently
-                        if (!running_.load(std::memory_order_relaxed))
-                        {
-                            LOG_F(INFO, "Producer (TID: %zu, client fd %d): running_ is false in client loop. Breaking.",
-                                  std::hash<std::thread::id>{}(std::this_thread::get_id()), clientSocketFd);
-                            break;
-                        }
+        /**
+         * @brief 讀取連線直到 EAGAIN，並把完整封包送入 RingBuffer
+         * @return false 表示連線已關閉或發生錯誤，應由呼叫端關閉
+         */
+        bool readConnection(ClientConnection &conn)
+        {
+            while (running_.load(std::memory_order_relaxed))
+            {
+                size_t space = CONNECTION_BUFFER_SIZE - conn.pendingLen;
+                if (space == 0)
+                {
+                    // 暫存區已滿仍未見 '\n'：視為異常封包，丟棄以重新對齊
+                    LOG_F(ERROR, "Producer (client %s, fd %d): %zu bytes without packet delimiter. Dropping.",
+                          conn.peer.c_str(), conn.fd, conn.pendingLen);
+                    conn.pendingLen = 0;
+                    space = CONNECTION_BUFFER_SIZE;
+                }
 
-                        LOG_F(INFO, "Producer (TID: %zu, client fd %d): Attempting to recv. maxLen=%zu",
-                              std::hash<std::thread::id>{}(std::this_thread::get_id()), clientSocketFd, maxLen);
-                        ssize_t n = recv(clientSocketFd, writePtr, maxLen, 0); // <<< 여기가 recv 로직입니다.
-                        int recv_errno = errno;                                // Store errno immediately
-
-                        LOG_F(INFO, "Producer (TID: %zu, client fd %d): recv returned %zd. errno: %d (%s). running_=%d",
-                              std::hash<std::thread::id>{}(std::this_thread::get_id()),
-                              clientSocketFd, n, recv_errno, strerror(recv_errno),
-                              running_.load(std::memory_order_relaxed));
-
-                        if (!running_.load(std::memory_order_relaxed))
-                        { // Check running_ immediately after recv returns
-                            LOG_F(INFO, "Producer (TID: %zu, client fd %d): running_ is false after recv. Exiting client loop.",
-                                  std::hash<std::thread::id>{}(std::this_thread::get_id()), clientSocketFd);
-                            break;
-                        }
+                ssize_t n = recv(conn.fd, conn.pending.data() + conn.pendingLen, space, 0);
+                if (n > 0)
+                {
+                    forwardCompletePackets(conn, static_cast<size_t>(n));
+                    continue;
+                }
+                if (n == 0)
+                {
+                    LOG_F(INFO, "Producer (client %s, fd %d): Client disconnected normally.", conn.peer.c_str(), conn.fd);
+                    return false;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    return true;
+                if (errno == EINTR)
+                    continue;
+                LOG_F(ERROR, "Producer (client %s, fd %d): Receive error (errno %d: %s)",
+                      conn.peer.c_str(), conn.fd, errno, strerror(errno));
+                return false;
+            }
+            return true;
+        }
 
-                        if (n > 0)
-                        { // 成功接收到數據
-                            ringBuffer_.enqueue(static_cast<size_t>(n));
-                            LOG_F(INFO, "Producer (client fd %d): Enqueued %zd bytes.", clientSocketFd, n);
-                        }
-                        else if (n == 0)
-                        { // 客戶端正常關閉連接
-                            LOG_F(INFO, "Producer (client fd %d): Client disconnected normally.", clientSocketFd);
-                            break; // 退出客戶端處理循環
-                        }
-                        else
-                        { // n < 0, recv 發生錯誤
-                            if (recv_errno == EINTR)
-                            { // 被信號中斷
-                                LOG_F(INFO, "Producer (client fd %d): recv() interrupted. Continuing client loop.", clientSocketFd);
-                                continue; // 繼續嘗試接收
-                            }
-                            if (recv_errno == EAGAIN || recv_errno == EWOULDBLOCK)
-                            { // 非阻塞模式下無數據，或超時 (如果設置了超時)
-                                LOG_F(INFO, "Producer (client fd %d): recv() timeout or wouldblock.", clientSocketFd);
-                                // 如果是阻塞socket且沒有超時，理論上不應頻繁出現此錯誤
-                                // 短暫讓出CPU，然後繼續嘗試
-                                if (!running_.load(std::memory_order_relaxed))
-                                    break;
-                                std::this_thread::yield();
-                                continue;
-                            }
-                            // 其他錯誤
-                            LOG_F(ERROR, "Producer (client fd %d): Receive error (errno %d: %s)", clientSocketFd, recv_errno, strerror(recv_errno));
-                            break; // 發生錯誤，退出客戶端處理循環
-                        }
-                    } // End inner client handling loop
+        /**
+         * 將暫存區中最後一個 '\n' 之前的完整封包寫入 RingBuffer，殘段搬回暫存區開頭。
+         * run-to-completion 模式則就地分包並逐一處理。
+         */
+        void forwardCompletePackets(ClientConnection &conn, size_t received)
+        {
+            char *base = conn.pending.data();
+            if (pipelineMode_ == PipelineMode::RunToCompletion)
+            {
+                // 先前的殘段不含 '\n'，從新資料開始掃描；封包起點仍是暫存區開頭
+                size_t start = 0;
+                const size_t from = conn.pendingLen;
+                DelimiterScanner::scan(base + from, received, '\n', [&](size_t off)
+                                       {
+                                           size_t end = from + off + 1;
+                                           handlePacket(base + start, end - start, 0);
+                                           start = end;
+                                           return true; });
+                conn.pendingLen += received;
+                if (start == 0)
+                    return;
+                size_t remain = conn.pendingLen - start;
+                if (remain > 0)
+                    std::memmove(base, base + start, remain);
+                conn.pendingLen = remain;
+                return;
+            }
+            if (pipelineMode_ == PipelineMode::Sharded)
+            {
+                routeCompletePackets(conn, received);
+                return;
+            }
+
+            // 先前的殘段不含 '\n'，只需在新收到的資料中尋找
+            const char *last = static_cast<const char *>(memrchr(base + conn.pendingLen, '\n', received));
+            conn.pendingLen += received;
+            if (last == nullptr)
+                return;
+
+            size_t complete = static_cast<size_t>(last - base) + 1;
+            writeToRing(base, complete);
+            size_t remain = conn.pendingLen - complete;
+            if (remain > 0)
+                std::memmove(base, base + complete, remain);
+            conn.pendingLen = remain;
+        }
+
+        /**
+         * 分片模式：逐一分包並依股票代號送到對應 shard 的 RingBuffer，殘段搬回暫存區開頭。
+         * 連續送往同一 shard 的封包合併成一次寫入。
+         */
+        void routeCompletePackets(ClientConnection &conn, size_t received)
+        {
+            char *base = conn.pending.data();
+            const size_t from = conn.pendingLen;
+            size_t start = 0;    // 下一個封包的起點
+            size_t runStart = 0; // 尚未寫出的同 shard 連續封包起點
+            size_t runShard = 0;
+            DelimiterScanner::scan(base + from, received, '\n', [&](size_t off)
+                                   {
+                                       size_t end = from + off + 1;
+                                       size_t shard = PacketRouter::shardOf(base + start, end - start, shardCount_);
+                                       if (shard != runShard && start > runStart)
+                                       {
+                                           writeToRing(*shardRings_[runShard], base + runStart, start - runStart);
+                                           runStart = start;
+                                       }
+                                       runShard = shard;
+                                       start = end;
+                                       return true; });
+            if (start > runStart)
+                writeToRing(*shardRings_[runShard], base + runStart, start - runStart);
+
+            conn.pendingLen += received;
+            if (start == 0)
+                return;
+            size_t remain = conn.pendingLen - start;
+            if (remain > 0)
+                std::memmove(base, base + start, remain);
+            conn.pendingLen = remain;
+        }
 
-                    LOG_F(INFO, "Producer (TID: %zu): Closing client socket fd %d.",
-                          std::hash<std::thread::id>{}(std::this_thread::get_id()), clientSocketFd);
-                    close(clientSocketFd); // 關閉客戶端 socket
+        void writeToRing(const char *data, size_t len)
+        {
+            writeToRing(ringBuffer_, data, len);
+        }
 
+        // 寫入 RingBuffer；空間不足時等待 consumer 釋放 (背壓)
+        template <typename Ring>
+        void writeToRing(Ring &ring, const char *data, size_t len)
+        {
+            while (len > 0)
+            {
+                size_t maxLen;
+                char *writePtr = ring.writablePtr(maxLen);
+                if (maxLen == 0)
+                {
                     if (!running_.load(std::memory_order_relaxed))
-                    {
-                        LOG_F(INFO, "Producer (TID: %zu): running_ is false after client handling. Exiting main loop.",
-                              std::hash<std::thread::id>{}(std::this_thread::get_id()));
-                        break;
-                    }
-                } // End main accept loop
+                        return;
+                    std::this_thread::yield();
+                    continue;
+                }
+                size_t chunk = len < maxLen ? len : maxLen;
+                std::memcpy(writePtr, data, chunk);
+                ring.enqueue(chunk);
+                data += chunk;
+                len -= chunk;
             }
-            catch (const std::exception &e)
+        }
+
+        void closeConnection(int fd)
+        {
+            auto it = connections_.find(fd);
+            if (it == connections_.end())
+                return;
+            if (it->second.pendingLen > 0)
             {
-                LOG_F(ERROR, "Producer thread exception: %s", e.what());
+                LOG_F(WARNING, "Producer (client %s, fd %d): Discarding %zu bytes of incomplete packet.",
+                      it->second.peer.c_str(), fd, it->second.pendingLen);
             }
-            catch (...)
+            LOG_F(INFO, "Producer: Closing client socket fd %d (%s).", fd, it->second.peer.c_str());
+            epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+            close(fd);
+            connections_.erase(it);
+        }
+
+        // 關閉所有客戶端連線、監聽 socket 與 epoll/eventfd (僅能在 producer 結束後呼叫)
+        void releaseSockets()
+        {
+            while (!connections_.empty())
+                closeConnection(connections_.begin()->first);
+            if (serverSocketFd_ >= 0)
             {
-                LOG_F(ERROR, "Producer thread unknown exception");
+                LOG_F(INFO, "TcpServiceAdapter: Closing server socket fd: %d", serverSocketFd_);
+                if (close(serverSocketFd_) < 0)
+                {
+                    LOG_F(WARNING, "TcpServiceAdapter: close(serverSocketFd_) failed: %s", strerror(errno));
+                }
+                serverSocketFd_ = -1;
             }
-            LOG_F(INFO, "Producer thread stopped. TID: %zu",
-                  std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            closeEventFds();
         }
 
         int serverSocketFd_; // Server's listening socket descriptor
+        int epollFd_ = -1;   // epoll instance
+        int wakeFd_ = -1;    // eventfd，用於 stop() 喚醒 epoll_wait
+        std::unordered_map<int, ClientConnection> connections_; // 僅 producer thread 存取
         std::shared_ptr<finance::domain::IPackageHandler> handler_;
         std::shared_ptr<finance::domain::IFinanceRepository<finance::domain::SummaryData, finance::domain::ErrorResult>> repository_;
-        std::unique_ptr<tasks::RedisWorker> redis_worker_;
-        RingBuffer<RING_BUFFER_SIZE> ringBuffer_;
+        MirroredRingBuffer<RING_BUFFER_SIZE> ringBuffer_;
         std::thread acceptThread_;
         std::thread processingThread_;
         std::atomic<bool> running_{false};
-        // cvMutex_ and cv_ are not directly used by socket operations anymore for unblocking,
-        // but might be kept if other logic relies on them.
-        // For now, their direct utility for socket thread synchronization is reduced.
-        // std::mutex cvMutex_;
-        // std::condition_variable cv_;
+        PipelineMode pipelineMode_ = PipelineMode::Split;
+        int pipelineCpu_ = -1;
+        std::atomic<bool> busyPoll_{false};
+        WaitPolicy waitPolicy_;
+        size_t shardCount_ = 1;
+        std::vector<std::unique_ptr<ShardRing>> shardRings_; // 分片模式：每個 shard 一個 SPSC RingBuffer
+        std::vector<std::thread> shardThreads_;
+        std::shared_ptr<storage::PacketJournal> journal_;  // setJournal() 後啟用，執行期間不變更
+        std::vector<std::atomic<uint64_t>> inFlightLsn_;   // 每條處理 thread 正在處理的封包 LSN，0 表示沒有
     };
 } // namespace finance::infrastructure::network
\ No newline at end of file
@@ -7,8 +7,12 @@
 #include "Hcrtm01Handler.hpp"
 #include "Hcrtm05pHandler.hpp"
 #include "utils/FinanceUtils.hpp"
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <utility>
+#include <vector>
 #include <memory>
 #include <loguru.hpp>
 #include <cstring>
@@ -22,13 +26,33 @@ namespace finance::infrastructure::network
     using finance::domain::SummaryData;
     using utils::FinanceUtils;
 
+    /// t_code 的整數表示：6 碼中第 i 個字元放在第 i 個 byte，constexpr，可作為 case label
+    namespace tcode
+    {
+        inline constexpr size_t LENGTH = sizeof(domain::FinancePackageMessage::t_code);
+
+        constexpr uint64_t value(const char *code) noexcept
+        {
+            uint64_t v = 0;
+            for (size_t i = 0; i < LENGTH; ++i)
+                v |= static_cast<uint64_t>(static_cast<unsigned char>(code[i])) << (8 * i);
+            return v;
+        }
+
+        inline constexpr uint64_t HCRTM01 = value("ELD001");
+        inline constexpr uint64_t HCRTM05P = value("ELD002");
+    } // namespace tcode
+
+    /**
+     * 依 t_code 分派封包。6 碼 t_code 直接載入成整數，內建格式 (ELD001 / ELD002) 以 switch 分派到具體型別的處理器
+     * (處理器為 final，呼叫可去虛擬化)；其他格式可於執行期以 registerHandler() 註冊，只在 switch 未命中時線性比對。
+     */
     class TransactionProcessor : public domain::IPackageHandler
     {
     public:
         explicit TransactionProcessor(std::shared_ptr<IFinanceRepository<SummaryData, ErrorResult>> repo)
+            : hcrtm01_(repo), hcrtm05p_(repo)
         {
-            registerHandler("ELD001", std::make_unique<infrastructure::network::Hcrtm01Handler>(repo));
-            registerHandler("ELD002", std::make_unique<infrastructure::network::Hcrtm05pHandler>(repo));
         }
 
         // Implement IPackageHandler interface
@@ -40,40 +64,74 @@ namespace finance::infrastructure::network
                 return Result<void, ErrorResult>::Err(
                     ErrorResult{ErrorCode::InvalidPacket, "Invalid entry type"});
 
-            // 2) Properly extract t_code with correct handling of null termination
-            std::string tcode = std::string(pkg.t_code, sizeof(pkg.t_code));
-            // Alternative using FinanceUtils:
-            // std::string tcode = FinanceUtils::trim_right(pkg.t_code, sizeof(pkg.t_code));
+            DLOG_F(INFO, "Processing message with t_code='%.*s'", static_cast<int>(tcode::LENGTH), pkg.t_code);
 
-            LOG_F(INFO, "Processing message with t_code='%s'", tcode.c_str());
+            // 2) 依 t_code 分派
+            auto result = dispatch(tcode::value(pkg.t_code), pkg);
 
-            // 3) 取得對應的處理器
-            auto it = handlers_.find(tcode);
-            if (it == handlers_.end())
-            {
-                LOG_F(WARNING, "找不到處理器 t_code='%s'", tcode.c_str());
-                return Result<void, ErrorResult>::Err(
-                    ErrorResult{ErrorCode::UnknownTransactionCode, "Unknown t_code"});
-            }
-
-            // 4) 動態呼叫 handler
-            auto result = it->second->handle(pkg);
-
-            // 5) 日誌結果狀態
-            LOG_F(INFO, "exit process, result=%s",
-                  result.is_ok() ? "OK" : result.unwrap_err().message.c_str());
+            // 3) 日誌結果狀態
+            if (result.is_err())
+                LOG_F(WARNING, "exit process, result=%s", result.unwrap_err().message.c_str());
+            else
+                DLOG_F(INFO, "exit process, result=OK");
 
             return result;
         }
 
+        /**
+         * 註冊額外格式的處理器；同一 t_code 重複註冊時取代舊的。
+         * 內建格式不可覆寫，t_code 長度不是 6 碼也會被拒絕，兩者皆回傳 false。
+         */
+        bool registerHandler(std::string_view code, std::unique_ptr<IPackageHandler> handler)
+        {
+            if (code.size() != tcode::LENGTH || handler == nullptr)
+            {
+                LOG_F(WARNING, "Invalid handler registration for t_code '%.*s'", static_cast<int>(code.size()), code.data());
+                return false;
+            }
+            const uint64_t codeValue = tcode::value(code.data());
+            if (codeValue == tcode::HCRTM01 || codeValue == tcode::HCRTM05P)
+            {
+                LOG_F(WARNING, "t_code '%.*s' is built in and cannot be replaced", static_cast<int>(code.size()), code.data());
+                return false;
+            }
+            for (auto &[registered, existing] : handlers_)
+            {
+                if (registered == codeValue)
+                {
+                    existing = std::move(handler);
+                    return true;
+                }
+            }
+            handlers_.emplace_back(codeValue, std::move(handler));
+            LOG_F(INFO, "Registered handler for t_code '%.*s'", static_cast<int>(code.size()), code.data());
+            return true;
+        }
+
     private:
-        // Register a handler for a specific transaction code
-        void registerHandler(const std::string &tcode, std::unique_ptr<IPackageHandler> handler)
+        Result<void, ErrorResult> dispatch(uint64_t code, const domain::FinancePackageMessage &pkg)
         {
-            handlers_[tcode] = std::move(handler);
-            LOG_F(INFO, "Registered handler for t_code '%s'", tcode.c_str());
+            switch (code)
+            {
+            case tcode::HCRTM01:
+                return hcrtm01_.handle(pkg);
+            case tcode::HCRTM05P:
+                return hcrtm05p_.handle(pkg);
+            default:
+                break;
+            }
+
+            for (const auto &[registered, handler] : handlers_)
+                if (registered == code)
+                    return handler->handle(pkg);
+
+            LOG_F(WARNING, "找不到處理器 t_code='%.*s'", static_cast<int>(tcode::LENGTH), pkg.t_code);
+            return Result<void, ErrorResult>::Err(
+                ErrorResult{ErrorCode::UnknownTransactionCode, "Unknown t_code"});
         }
 
-        std::unordered_map<std::string, std::unique_ptr<IPackageHandler>> handlers_;
+        Hcrtm01Handler hcrtm01_;
+        Hcrtm05pHandler hcrtm05p_;
+        std::vector<std::pair<uint64_t, std::unique_ptr<IPackageHandler>>> handlers_; // 執行期註冊的格式
     };
 }
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <optional>
+#include <string>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace finance::infrastructure::network
+{
+
+    /**
+     * consumer 等待新資料的方式
+     * - BusySpin:  只以 cpu_pause 忙等，延遲最低，佔滿一個核心
+     * - SpinYield: 忙等後改為 yield，仍會佔用 CPU
+     * - SpinPark:  忙等、yield 後在 futex 上休眠，由 producer 喚醒，閒置時幾乎不耗 CPU
+     */
+    enum class WaitMode
+    {
+        BusySpin,
+        SpinYield,
+        SpinPark
+    };
+
+    /// 等待策略參數
+    struct WaitPolicy
+    {
+        WaitMode mode = WaitMode::SpinPark;
+        uint32_t spinCount = 2000;     // 每輪等待的 cpu_pause 次數
+        uint32_t yieldCount = 100;     // 忙等後的 yield 次數 (BusySpin 不使用)
+        uint32_t parkTimeoutMs = 100;  // 單次休眠上限，讓 consumer 定期檢查是否應結束
+    };
+
+    /// 由設定字串 ("busy_spin" / "spin_yield" / "spin_park") 取得 WaitMode
+    inline std::optional<WaitMode> waitModeFromString(const std::string &name) noexcept
+    {
+        if (name == "busy_spin")
+            return WaitMode::BusySpin;
+        if (name == "spin_yield")
+            return WaitMode::SpinYield;
+        if (name == "spin_park")
+            return WaitMode::SpinPark;
+        return std::nullopt;
+    }
+
+    inline const char *waitModeName(WaitMode mode) noexcept
+    {
+        switch (mode)
+        {
+        case WaitMode::BusySpin:
+            return "busy_spin";
+        case WaitMode::SpinYield:
+            return "spin_yield";
+        case WaitMode::SpinPark:
+            return "spin_park";
+        }
+        return "unknown";
+    }
+
+    /**
+     * 單一等待者的 futex 休眠點。
+     * 等待者先 prepare() 取得序號並標記 parked，重新檢查條件後再 park()；
+     * 喚醒者在發佈資料後呼叫 unparkIfParked()，只有在等待者確實休眠時才會進行 syscall。
+     */
+    class ParkingSpot
+    {
+    public:
+        /// 標記即將休眠，回傳 park() 需要的序號
+        uint32_t prepare() noexcept
+        {
+            uint32_t seq = seq_.load(std::memory_order_acquire);
+            parked_.store(true, std::memory_order_seq_cst);
+            return seq;
+        }
+
+        /// 取消休眠 (prepare 後重新檢查發現條件已成立)
+        void cancel() noexcept
+        {
+            parked_.store(false, std::memory_order_relaxed);
+        }
+
+        /// 休眠直到被喚醒、逾時或序號已改變
+        void park(uint32_t seq, uint32_t timeoutMs) noexcept
+        {
+            timespec ts{static_cast<time_t>(timeoutMs / 1000), static_cast<long>(timeoutMs % 1000) * 1000000L};
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&seq_), FUTEX_WAIT_PRIVATE, seq, &ts, nullptr, 0);
+            parked_.store(false, std::memory_order_relaxed);
+        }
+
+        /// 喚醒者：發佈資料後呼叫，等待者未休眠時只有一次 fence 與 load
+        void unparkIfParked() noexcept
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (parked_.load(std::memory_order_relaxed))
+                unpark();
+        }
+
+        /// 無條件喚醒 (例如停止服務時)
+        void unpark() noexcept
+        {
+            seq_.fetch_add(1, std::memory_order_release);
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&seq_), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+        }
+
+    private:
+        static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex 需要 32 位元的字");
+
+        std::atomic<uint32_t> seq_{0};
+        std::atomic<bool> parked_{false};
+    };
+
+} // namespace finance::infrastructure::network
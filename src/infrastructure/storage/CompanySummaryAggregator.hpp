@@ -0,0 +1,172 @@
+#pragma once
+
+#include "domain/FinanceDataStructure.hpp"
+#include "domain/SummaryKey.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+namespace finance::infrastructure::storage
+{
+
+    /// 總公司彙總用的八個可用數量欄位
+    struct AvailableTotals
+    {
+        int64_t margin_available_amount = 0;
+        int64_t margin_available_qty = 0;
+        int64_t short_available_amount = 0;
+        int64_t short_available_qty = 0;
+        int64_t after_margin_available_amount = 0;
+        int64_t after_margin_available_qty = 0;
+        int64_t after_short_available_amount = 0;
+        int64_t after_short_available_qty = 0;
+
+        static AvailableTotals from(const domain::SummaryData &data) noexcept
+        {
+            return AvailableTotals{data.margin_available_amount, data.margin_available_qty,
+                                   data.short_available_amount, data.short_available_qty,
+                                   data.after_margin_available_amount, data.after_margin_available_qty,
+                                   data.after_short_available_amount, data.after_short_available_qty};
+        }
+
+        AvailableTotals &operator+=(const AvailableTotals &o) noexcept
+        {
+            margin_available_amount += o.margin_available_amount;
+            margin_available_qty += o.margin_available_qty;
+            short_available_amount += o.short_available_amount;
+            short_available_qty += o.short_available_qty;
+            after_margin_available_amount += o.after_margin_available_amount;
+            after_margin_available_qty += o.after_margin_available_qty;
+            after_short_available_amount += o.after_short_available_amount;
+            after_short_available_qty += o.after_short_available_qty;
+            return *this;
+        }
+
+        AvailableTotals &operator-=(const AvailableTotals &o) noexcept
+        {
+            margin_available_amount -= o.margin_available_amount;
+            margin_available_qty -= o.margin_available_qty;
+            short_available_amount -= o.short_available_amount;
+            short_available_qty -= o.short_available_qty;
+            after_margin_available_amount -= o.after_margin_available_amount;
+            after_margin_available_qty -= o.after_margin_available_qty;
+            after_short_available_amount -= o.after_short_available_amount;
+            after_short_available_qty -= o.after_short_available_qty;
+            return *this;
+        }
+
+        bool operator==(const AvailableTotals &o) const noexcept
+        {
+            return margin_available_amount == o.margin_available_amount &&
+                   margin_available_qty == o.margin_available_qty &&
+                   short_available_amount == o.short_available_amount &&
+                   short_available_qty == o.short_available_qty &&
+                   after_margin_available_amount == o.after_margin_available_amount &&
+                   after_margin_available_qty == o.after_margin_available_qty &&
+                   after_short_available_amount == o.after_short_available_amount &&
+                   after_short_available_qty == o.after_short_available_qty;
+        }
+
+        bool operator!=(const AvailableTotals &o) const noexcept { return !(*this == o); }
+
+        /// 寫入 SummaryData 的可用數量欄位
+        void copyTo(domain::SummaryData &data) const noexcept
+        {
+            data.margin_available_amount = margin_available_amount;
+            data.margin_available_qty = margin_available_qty;
+            data.short_available_amount = short_available_amount;
+            data.short_available_qty = short_available_qty;
+            data.after_margin_available_amount = after_margin_available_amount;
+            data.after_margin_available_qty = after_margin_available_qty;
+            data.after_short_available_amount = after_short_available_amount;
+            data.after_short_available_qty = after_short_available_qty;
+        }
+    };
+
+    /**
+     * 增量維護的總公司 (summary:ALL:<stock>) 彙總：區中心資料寫入快取時，
+     * 以「新值 - 上次計入的值」更新該股票的合計，取得彙總只需一次查表，不必逐一走訪所有區中心。
+     * 只計入區中心通過 isCompanyArea 的資料 (與全量重算的範圍相同)；判斷結果依區中心快取。
+     * 本身不加鎖，由呼叫端 (RedisSummaryAdapter 各快取分區的鎖) 保護。
+     */
+    class CompanySummaryAggregator
+    {
+    public:
+        using AreaPredicate = std::function<bool(const std::string &)>;
+
+        explicit CompanySummaryAggregator(AreaPredicate isCompanyArea)
+            : isCompanyArea_(std::move(isCompanyArea)) {}
+
+        /// 區中心資料寫入快取後呼叫；不屬於總公司彙總範圍的區中心會被忽略
+        void apply(domain::SummaryKey key, const domain::SummaryData &data)
+        {
+            if (!isCompanyArea(key))
+                return;
+
+            auto current = AvailableTotals::from(data);
+            auto &contributed = contributions_[key.packed()];
+            auto &total = totals_[key.stockBits()];
+            total -= contributed;
+            total += current;
+            contributed = current;
+        }
+
+        /// 區中心資料自快取移除時呼叫
+        void remove(domain::SummaryKey key)
+        {
+            auto it = contributions_.find(key.packed());
+            if (it == contributions_.end())
+                return;
+            totals_[key.stockBits()] -= it->second;
+            contributions_.erase(it);
+        }
+
+        void clear()
+        {
+            contributions_.clear();
+            totals_.clear();
+        }
+
+        /// key 所屬股票目前的總公司合計 (只看股票代號部分)；沒有任何區中心資料時為 0
+        AvailableTotals totals(domain::SummaryKey key) const
+        {
+            auto it = totals_.find(key.stockBits());
+            return it == totals_.end() ? AvailableTotals{} : it->second;
+        }
+
+        /**
+         * 以全量重算的結果覆蓋某檔股票的合計 (交叉檢查發現不一致時使用)。
+         * @param stockKey 該股票的任一 key
+         * @param areaValues 每個區中心的 (SummaryKey, 資料指標)
+         */
+        template <typename AreaValues>
+        void reset(domain::SummaryKey stockKey, const AreaValues &areaValues)
+        {
+            AvailableTotals total;
+            for (const auto &[key, data] : areaValues)
+            {
+                auto current = AvailableTotals::from(*data);
+                contributions_[key.packed()] = current;
+                total += current;
+            }
+            totals_[stockKey.stockBits()] = total;
+        }
+
+    private:
+        bool isCompanyArea(domain::SummaryKey key)
+        {
+            uint64_t areaBits = key.areaBits();
+            auto it = areaValid_.find(areaBits);
+            if (it == areaValid_.end())
+                it = areaValid_.emplace(areaBits, isCompanyArea_(key.area())).first;
+            return it->second;
+        }
+
+        AreaPredicate isCompanyArea_;
+        std::unordered_map<uint64_t, bool> areaValid_;                 // 區中心 bits -> 是否計入
+        std::unordered_map<uint64_t, AvailableTotals> contributions_; // SummaryKey -> 上次計入的值
+        std::unordered_map<uint64_t, AvailableTotals> totals_;        // 股票 bits -> 總公司合計
+    };
+
+} // namespace finance::infrastructure::storage
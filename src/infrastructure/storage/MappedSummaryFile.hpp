@@ -0,0 +1,306 @@
+#pragma once
+
+#include "domain/SummaryKey.hpp"
+#include "domain/SummarySnapshot.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <loguru.hpp>
+#include <memory>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace finance::infrastructure::storage
+{
+
+    /**
+     * 以 mmap 映射的 summary 快取檔：固定格式、帶版本的開放定址表，每筆記錄是一份 SummarySnapshot (分公司列表 handle 不寫入)。
+     * RedisSummaryAdapter 每次發佈快取資料時同步寫入，重啟時直接走訪映射內容還原快取，不需要從 Redis 逐筆載入。
+     *
+     * 檔案格式：64 位元組 Header，之後為 capacity 筆記錄；記錄為 [序號][SummarySnapshot 字組]。
+     * - 每筆記錄以序號 (seqlock) 保護，寫入中為奇數；程序在寫入途中結束時，下次開檔會捨棄該筆 (由 Redis 對帳補回)。
+     * - key 一旦寫入記錄就不再搬移 (只插入，不重建)，不同 key 的寫入可由不同 thread 同時進行，不需要鎖。
+     * - 寫入只進入 page cache：程序崩潰不會遺失，主機斷電則可能遺失最後一段，需要時呼叫 flush()。
+     * - Header 的 appliedLsn 記錄 checkpoint() 時快取已涵蓋的封包日誌 LSN，重啟時由此之後重播 PacketJournal。
+     * Header 的 magic / version / recordSize 任一不符 (例如 SummarySnapshot 欄位變更) 時重新初始化為空檔。
+     */
+    class MappedSummaryFile
+    {
+    public:
+        using Snapshot = domain::SummarySnapshot;
+
+        static constexpr uint32_t FORMAT_VERSION = 1;
+        static constexpr size_t HEADER_SIZE = 64;
+        static constexpr size_t RECORD_WORDS = 1 + sizeof(Snapshot) / sizeof(uint64_t);
+        static constexpr size_t RECORD_SIZE = RECORD_WORDS * sizeof(uint64_t);
+
+        struct Header
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t recordSize;
+            uint64_t capacity;
+            uint64_t appliedLsn; // 最近一次 checkpoint() 的 LSN，0 表示未曾 checkpoint
+            uint64_t reserved[4];
+        };
+        static_assert(sizeof(Header) == HEADER_SIZE, "MappedSummaryFile::Header 大小需固定");
+        static_assert(std::atomic<uint64_t>::is_always_lock_free && sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+                      "映射記憶體以 std::atomic<uint64_t> 存取");
+
+        /**
+         * 開啟 (不存在時建立) 快取檔並映射。既有且格式相符的檔案沿用其容量；否則以 capacity 筆重新初始化。
+         * @return 失敗時回傳 nullptr
+         */
+        static std::unique_ptr<MappedSummaryFile> open(const std::string &path, size_t capacity)
+        {
+            int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (fd < 0)
+            {
+                LOG_F(ERROR, "MappedSummaryFile: cannot open %s: %s", path.c_str(), std::strerror(errno));
+                return nullptr;
+            }
+
+            struct stat st{};
+            Header header{};
+            bool valid = ::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= HEADER_SIZE &&
+                         ::pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                         std::memcmp(header.magic, MAGIC, sizeof(header.magic)) == 0 &&
+                         header.version == FORMAT_VERSION && header.recordSize == RECORD_SIZE &&
+                         header.capacity != 0 && (header.capacity & (header.capacity - 1)) == 0 &&
+                         static_cast<size_t>(st.st_size) == fileSize(header.capacity);
+            if (!valid)
+            {
+                if (st.st_size != 0)
+                    LOG_F(WARNING, "MappedSummaryFile: %s has an incompatible layout, reinitializing", path.c_str());
+                size_t rounded = MIN_CAPACITY;
+                while (rounded < capacity)
+                    rounded <<= 1;
+                std::memset(&header, 0, sizeof(header));
+                std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+                header.version = FORMAT_VERSION;
+                header.recordSize = RECORD_SIZE;
+                header.capacity = rounded;
+                // 先截成 0 再擴充，舊內容一律清為 0
+                if (::ftruncate(fd, 0) != 0 || ::ftruncate(fd, static_cast<off_t>(fileSize(rounded))) != 0 ||
+                    ::pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+                {
+                    LOG_F(ERROR, "MappedSummaryFile: cannot initialize %s: %s", path.c_str(), std::strerror(errno));
+                    ::close(fd);
+                    return nullptr;
+                }
+            }
+
+            const size_t size = fileSize(header.capacity);
+            void *base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (base == MAP_FAILED)
+            {
+                LOG_F(ERROR, "MappedSummaryFile: mmap %s failed: %s", path.c_str(), std::strerror(errno));
+                return nullptr;
+            }
+            std::unique_ptr<MappedSummaryFile> file(new MappedSummaryFile(static_cast<char *>(base), size, header.capacity));
+            if (valid)
+                file->discardTornRecords();
+            return file;
+        }
+
+        ~MappedSummaryFile()
+        {
+            ::munmap(base_, size_);
+        }
+
+        MappedSummaryFile(const MappedSummaryFile &) = delete;
+        MappedSummaryFile &operator=(const MappedSummaryFile &) = delete;
+
+        /**
+         * 寫入 key 的快照 (不需要鎖；同一 key 的多個寫者由記錄的序號互斥)。
+         * @return 檔案已滿時回傳 false
+         */
+        bool store(domain::SummaryKey key, const Snapshot &snapshot) noexcept
+        {
+            std::atomic<uint64_t> *record = claim(key.packed());
+            if (record == nullptr)
+            {
+                if (!fullReported_.exchange(true, std::memory_order_relaxed))
+                    LOG_F(WARNING, "MappedSummaryFile: file is full (%zu records), new keys are not persisted", capacity_);
+                return false;
+            }
+            Snapshot persisted = snapshot;
+            persisted.key = key.packed();
+            persisted.belong_branches = {}; // 程序內的 handle，重啟後由設定還原
+            uint64_t words[RECORD_WORDS - 1];
+            std::memcpy(words, &persisted, sizeof(persisted));
+            write(record, words);
+            return true;
+        }
+
+        /// 標記 key 已移除；之後還原時略過
+        void erase(domain::SummaryKey key) noexcept
+        {
+            if (std::atomic<uint64_t> *record = find(key.packed()))
+            {
+                uint64_t words[RECORD_WORDS - 1] = {};
+                words[0] = TOMBSTONE;
+                write(record, words);
+            }
+        }
+
+        /// 清除所有記錄 (只在沒有其他寫者時呼叫，例如啟動時由 Redis 全量載入前)
+        void clear() noexcept
+        {
+            std::memset(base_ + HEADER_SIZE, 0, capacity_ * RECORD_SIZE);
+            fullReported_.store(false, std::memory_order_relaxed);
+        }
+
+        /**
+         * 走訪所有記錄，對每筆呼叫 fn(SummaryKey key, const Snapshot &snapshot)。只在沒有其他寫者時呼叫 (啟動還原)。
+         */
+        template <typename Fn>
+        void forEach(Fn &&fn) const
+        {
+            for (size_t i = 0; i < capacity_; ++i)
+            {
+                const std::atomic<uint64_t> *record = recordAt(i);
+                const uint64_t key = record[1].load(std::memory_order_acquire);
+                if (key == EMPTY || key == TOMBSTONE)
+                    continue;
+                uint64_t words[RECORD_WORDS - 1];
+                for (size_t w = 0; w < RECORD_WORDS - 1; ++w)
+                    words[w] = record[1 + w].load(std::memory_order_relaxed);
+                Snapshot snapshot;
+                std::memcpy(&snapshot, words, sizeof(snapshot));
+                fn(domain::SummaryKey::fromPacked(key), snapshot);
+            }
+        }
+
+        /// 開檔時因上次程序在寫入途中結束而捨棄的記錄數 (這些 key 需由 Redis 對帳補回)
+        size_t discardedRecords() const noexcept { return discarded_; }
+
+        /// 將映射內容寫回磁碟 (msync)；程序正常結束或需要防範斷電時呼叫
+        bool flush() noexcept
+        {
+            return ::msync(base_, size_, MS_SYNC) == 0;
+        }
+
+        /**
+         * 記錄快取已涵蓋到 appliedLsn 為止的封包：先將記錄寫回磁碟，再寫入並 msync Header，
+         * 確保 Header 的 LSN 不會領先於已落盤的記錄。
+         */
+        bool checkpoint(uint64_t appliedLsn) noexcept
+        {
+            if (::msync(base_, size_, MS_SYNC) != 0)
+                return false;
+            header()->appliedLsn = appliedLsn;
+            return ::msync(base_, HEADER_SIZE, MS_SYNC) == 0;
+        }
+
+        /// 最近一次 checkpoint() 的 LSN
+        uint64_t appliedLsn() const noexcept { return header()->appliedLsn; }
+
+        size_t capacity() const noexcept { return capacity_; }
+
+    private:
+        static constexpr char MAGIC[8] = {'F', 'S', 'U', 'M', 'M', 'A', 'P', '\0'};
+        static constexpr uint64_t EMPTY = 0;                 // 合法的 SummaryKey 不為 0
+        static constexpr uint64_t TOMBSTONE = ~uint64_t{0};  // 合法的 SummaryKey bit 63 為 0
+        static constexpr size_t MIN_CAPACITY = 1024;
+
+        MappedSummaryFile(char *base, size_t size, size_t capacity)
+            : base_(base), size_(size), capacity_(capacity), mask_(capacity - 1) {}
+
+        // 序號為奇數 (寫入途中結束) 或為 0 (已佔用但未寫入) 的記錄改為已移除，序號回到偶數讓之後的寫入可以取得
+        void discardTornRecords() noexcept
+        {
+            for (size_t i = 0; i < capacity_; ++i)
+            {
+                std::atomic<uint64_t> *record = recordAt(i);
+                const uint64_t key = record[1].load(std::memory_order_relaxed);
+                const uint64_t seq = record[0].load(std::memory_order_relaxed);
+                if (key == EMPTY || key == TOMBSTONE || (seq != 0 && (seq & 1) == 0))
+                    continue;
+                record[1].store(TOMBSTONE, std::memory_order_relaxed);
+                record[0].store((seq | 1) + 1, std::memory_order_relaxed);
+                ++discarded_;
+            }
+        }
+
+        Header *header() const noexcept
+        {
+            return reinterpret_cast<Header *>(base_);
+        }
+
+        static size_t fileSize(size_t capacity) noexcept
+        {
+            return HEADER_SIZE + capacity * RECORD_SIZE;
+        }
+
+        static size_t homeOf(uint64_t packed, size_t mask) noexcept
+        {
+            uint64_t h = packed;
+            h ^= h >> 30;
+            h *= 0xbf58476d1ce4e5b9ULL;
+            h ^= h >> 27;
+            h *= 0x94d049bb133111ebULL;
+            h ^= h >> 31;
+            return static_cast<size_t>(h) & mask;
+        }
+
+        std::atomic<uint64_t> *recordAt(size_t i) const noexcept
+        {
+            return reinterpret_cast<std::atomic<uint64_t> *>(base_ + HEADER_SIZE + i * RECORD_SIZE);
+        }
+
+        std::atomic<uint64_t> *find(uint64_t packed) const noexcept
+        {
+            for (size_t n = 0, i = homeOf(packed, mask_); n < capacity_; ++n, i = (i + 1) & mask_)
+            {
+                std::atomic<uint64_t> *record = recordAt(i);
+                uint64_t k = record[1].load(std::memory_order_acquire);
+                if (k == packed)
+                    return record;
+                if (k == EMPTY)
+                    return nullptr;
+            }
+            return nullptr;
+        }
+
+        // 找到 key 的記錄，不存在時以 CAS 佔用第一個空位 (移除留下的位置不重複使用)
+        std::atomic<uint64_t> *claim(uint64_t packed) noexcept
+        {
+            for (size_t n = 0, i = homeOf(packed, mask_); n < capacity_; ++n, i = (i + 1) & mask_)
+            {
+                std::atomic<uint64_t> *record = recordAt(i);
+                uint64_t k = record[1].load(std::memory_order_acquire);
+                if (k == EMPTY && record[1].compare_exchange_strong(k, packed, std::memory_order_acq_rel))
+                    return record;
+                if (k == packed)
+                    return record;
+            }
+            return nullptr;
+        }
+
+        static void write(std::atomic<uint64_t> *record, const uint64_t (&words)[RECORD_WORDS - 1]) noexcept
+        {
+            uint64_t seq = record[0].load(std::memory_order_relaxed);
+            while ((seq & 1) != 0 || !record[0].compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                seq = record[0].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t w = 0; w < RECORD_WORDS - 1; ++w)
+                record[1 + w].store(words[w], std::memory_order_relaxed);
+            record[0].store(seq + 2, std::memory_order_release);
+        }
+
+        char *base_;
+        size_t size_;
+        size_t capacity_;
+        size_t mask_;
+        size_t discarded_ = 0;
+        std::atomic<bool> fullReported_{false};
+    };
+
+} // namespace finance::infrastructure::storage
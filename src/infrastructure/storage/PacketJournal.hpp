@@ -0,0 +1,422 @@
+#pragma once
+
+#include "domain/FinanceDataStructure.hpp"
+#include "utils/Crc32c.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <loguru.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace finance::infrastructure::storage
+{
+
+    /**
+     * 已套用封包的預寫日誌 (write-ahead journal)：每筆記錄為封包原始位元組、接收時間與 ApData::jrnseqn，
+     * 以遞增的 LSN (log sequence number) 定位。
+     *
+     * - append() 只在記憶體緩衝區附加一筆 (鎖內只有 memcpy)，由背景 thread 整批寫入並 fdatasync (group commit)，
+     *   每筆封包的成本與批次大小無關；durableLsn() 為已落盤的最後一筆。
+     * - 寫入或 fdatasync 失敗時 durableLsn() 不前進：目前段截回本批之前的長度後關閉，該批保留在記憶體中，
+     *   下一次提交時連同新記錄從該批第一筆 LSN 開新段重寫，之後的記錄不會接在殘缺的記錄後面。
+     * - 日誌分段存放，檔名為該段第一筆的 LSN (journal-<LSN>.log)；單段超過 segmentBytes 即換新檔。
+     *   checkpoint 之後以 truncateBefore() 刪除已不需要的舊段。
+     * - 記錄格式：RecordHeader + 封包位元組；CRC-32C 涵蓋封包位元組與 header 中 LSN 之後的欄位。
+     *   replay() 遇到長度、LSN 或 CRC 不符 (寫入途中結束) 即停止讀取該段。
+     * jrnseqn 由上游各系統各自編號 (可能重複或每日歸零)，因此只記錄供對照，定位以 LSN 為準。
+     */
+    class PacketJournal
+    {
+    public:
+        struct Options
+        {
+            std::chrono::microseconds commitInterval{1000}; // 最長多久提交一次
+            size_t commitBytes = size_t{1} << 20;           // 緩衝區累積到此大小即提前提交
+            size_t segmentBytes = size_t{64} << 20;         // 單段檔案大小上限
+            bool fsync = true;                              // 提交時是否 fdatasync
+        };
+
+        struct RecordHeader
+        {
+            uint32_t length;     // 封包位元組數
+            uint32_t crc;        // CRC-32C (封包位元組 + lsn 之後的欄位)
+            uint64_t lsn;
+            uint64_t jrnseqn;    // ApData::jrnseqn，非數字時為 0
+            int64_t receivedNs;  // 寫入日誌時的系統時間 (ns since epoch)
+        };
+        static_assert(sizeof(RecordHeader) == 32, "PacketJournal::RecordHeader 大小需固定");
+
+        static constexpr size_t MAX_RECORD_BYTES = sizeof(domain::FinancePackageMessage) + 1;
+
+        /**
+         * 開啟日誌目錄 (不存在時建立)，LSN 接續既有日誌最後一筆完整記錄，且不小於 minNextLsn。
+         * 一律從新的一段開始寫入。
+         * @return 失敗時回傳 nullptr
+         */
+        static std::unique_ptr<PacketJournal> open(const std::string &dir, Options options, uint64_t minNextLsn = 1)
+        {
+            std::error_code ec;
+            std::filesystem::create_directories(dir, ec);
+            if (ec)
+            {
+                LOG_F(ERROR, "PacketJournal: cannot create %s: %s", dir.c_str(), ec.message().c_str());
+                return nullptr;
+            }
+            uint64_t lastLsn = 0;
+            for (const auto &[firstLsn, path] : listSegments(dir))
+                lastLsn = std::max(lastLsn, scanSegment(path, firstLsn, 0, [](const RecordHeader &, const char *) {}).lastLsn);
+            return std::unique_ptr<PacketJournal>(new PacketJournal(dir, options, std::max(lastLsn + 1, minNextLsn)));
+        }
+
+        ~PacketJournal()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            flushCv_.notify_one();
+            if (flusher_.joinable())
+                flusher_.join();
+            if (fd_ >= 0)
+                ::close(fd_);
+        }
+
+        PacketJournal(const PacketJournal &) = delete;
+        PacketJournal &operator=(const PacketJournal &) = delete;
+
+        /**
+         * 附加一筆封包並回傳其 LSN。inFlight 不為 nullptr 時，在 LSN 對外可見 (lastLsn()) 之前先寫入 *inFlight，
+         * 呼叫端套用完成後清為 0，用於計算已套用的 LSN 水位 (見 TcpServiceAdapter::appliedLsnWatermark())。
+         */
+        uint64_t append(const char *data, size_t len, std::atomic<uint64_t> *inFlight = nullptr)
+        {
+            RecordHeader header{};
+            header.length = static_cast<uint32_t>(std::min(len, MAX_RECORD_BYTES));
+            header.jrnseqn = jrnseqnOf(data, len);
+            header.receivedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::system_clock::now().time_since_epoch())
+                                    .count();
+            const uint32_t payloadCrc = utils::Crc32c::compute(data, header.length);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            header.lsn = nextLsn_++;
+            header.crc = recordCrc(payloadCrc, header);
+            if (inFlight != nullptr)
+                inFlight->store(header.lsn, std::memory_order_relaxed);
+            const auto *bytes = reinterpret_cast<const char *>(&header);
+            active_.insert(active_.end(), bytes, bytes + sizeof(header));
+            active_.insert(active_.end(), data, data + header.length);
+            lastLsn_.store(header.lsn, std::memory_order_release);
+            if (active_.size() >= options_.commitBytes)
+                flushCv_.notify_one();
+            return header.lsn;
+        }
+
+        /// 最後一筆已附加的 LSN
+        uint64_t lastLsn() const noexcept { return lastLsn_.load(std::memory_order_acquire); }
+
+        /// 最後一筆已寫入 (且 fsync 時已落盤) 的 LSN
+        uint64_t durableLsn() const noexcept { return durableLsn_.load(std::memory_order_acquire); }
+
+        /**
+         * 立即提交目前緩衝的記錄。
+         * @return true 表示 durableLsn() >= 呼叫當下的 lastLsn()；寫入失敗 (該批留待下次重試) 時回傳 false
+         */
+        bool commit()
+        {
+            const uint64_t target = lastLsn();
+            std::unique_lock<std::mutex> lock(mutex_);
+            const uint64_t failures = failedFlushes_;
+            commitRequested_ = true;
+            flushCv_.notify_one();
+            durableCv_.wait(lock, [&]
+                            { return durableLsn() >= target || failedFlushes_ != failures || stopping_; });
+            return durableLsn() >= target;
+        }
+
+        /**
+         * 刪除所有記錄都 <= appliedLsn 的舊段 (checkpoint 之後呼叫)；目前寫入中的段不刪除。
+         * @return 刪除的段數
+         */
+        size_t truncateBefore(uint64_t appliedLsn)
+        {
+            std::lock_guard<std::mutex> segmentLock(segmentMutex_);
+            auto segments = listSegments(dir_);
+            size_t removed = 0;
+            for (size_t i = 0; i + 1 < segments.size(); ++i)
+            {
+                if (segments[i + 1].first > appliedLsn + 1 || segments[i].second == currentSegment_)
+                    break;
+                std::error_code ec;
+                if (std::filesystem::remove(segments[i].second, ec))
+                    ++removed;
+            }
+            return removed;
+        }
+
+        struct ReplayStats
+        {
+            size_t records = 0;  // 交給 fn 的筆數
+            uint64_t lastLsn = 0; // 最後一筆完整記錄的 LSN
+        };
+
+        /**
+         * 依 LSN 順序讀取目錄中 LSN >= fromLsn 的記錄，對每筆呼叫 fn(const RecordHeader &, const char *data)。
+         * 可在 open() 之前呼叫 (啟動時以快取檔加上日誌尾端重建)。
+         */
+        template <typename Fn>
+        static ReplayStats replay(const std::string &dir, uint64_t fromLsn, Fn &&fn)
+        {
+            ReplayStats stats;
+            auto segments = listSegments(dir);
+            for (size_t i = 0; i < segments.size(); ++i)
+            {
+                if (i + 1 < segments.size() && segments[i + 1].first <= fromLsn)
+                    continue; // 整段都在 fromLsn 之前
+                auto segment = scanSegment(segments[i].second, segments[i].first, fromLsn, fn);
+                stats.records += segment.records;
+                stats.lastLsn = std::max(stats.lastLsn, segment.lastLsn);
+            }
+            return stats;
+        }
+
+    private:
+        PacketJournal(std::string dir, Options options, uint64_t nextLsn)
+            : dir_(std::move(dir)), options_(options), nextLsn_(nextLsn)
+        {
+            lastLsn_.store(nextLsn - 1, std::memory_order_relaxed);
+            durableLsn_.store(nextLsn - 1, std::memory_order_relaxed);
+            active_.reserve(options_.commitBytes * 2);
+            flushing_.reserve(options_.commitBytes * 2);
+            flusher_ = std::thread(&PacketJournal::flushLoop, this);
+        }
+
+        static uint32_t recordCrc(uint32_t payloadCrc, const RecordHeader &header) noexcept
+        {
+            constexpr size_t FIELDS = offsetof(RecordHeader, lsn);
+            return utils::Crc32c::extend(payloadCrc, reinterpret_cast<const char *>(&header) + FIELDS, sizeof(header) - FIELDS);
+        }
+
+        static uint64_t jrnseqnOf(const char *data, size_t len) noexcept
+        {
+            constexpr size_t OFFSET = offsetof(domain::FinancePackageMessage, ap_data) + offsetof(domain::ApData, jrnseqn);
+            constexpr size_t WIDTH = sizeof(domain::ApData::jrnseqn);
+            if (len < OFFSET + WIDTH)
+                return 0;
+            uint64_t value = 0;
+            for (size_t i = 0; i < WIDTH; ++i)
+            {
+                const char c = data[OFFSET + i];
+                if (c == ' ')
+                    continue;
+                if (c < '0' || c > '9')
+                    return 0;
+                value = value * 10 + static_cast<uint64_t>(c - '0');
+            }
+            return value;
+        }
+
+        static std::string segmentName(uint64_t firstLsn)
+        {
+            char name[40];
+            std::snprintf(name, sizeof(name), "journal-%020llu.log", static_cast<unsigned long long>(firstLsn));
+            return name;
+        }
+
+        /// 目錄中的日誌段 (第一筆 LSN, 路徑)，依 LSN 排序
+        static std::vector<std::pair<uint64_t, std::string>> listSegments(const std::string &dir)
+        {
+            std::vector<std::pair<uint64_t, std::string>> segments;
+            std::error_code ec;
+            for (const auto &entry : std::filesystem::directory_iterator(dir, ec))
+            {
+                const std::string name = entry.path().filename().string();
+                unsigned long long firstLsn = 0;
+                if (name.size() == segmentName(0).size() && std::sscanf(name.c_str(), "journal-%20llu.log", &firstLsn) == 1)
+                    segments.emplace_back(firstLsn, entry.path().string());
+            }
+            std::sort(segments.begin(), segments.end());
+            return segments;
+        }
+
+        // 依序讀取一段，第一筆損壞或不連續的記錄之後全部忽略
+        template <typename Fn>
+        static ReplayStats scanSegment(const std::string &path, uint64_t firstLsn, uint64_t fromLsn, Fn &&fn)
+        {
+            ReplayStats stats;
+            std::ifstream in(path, std::ios::binary);
+            std::vector<char> payload(MAX_RECORD_BYTES);
+            uint64_t expected = firstLsn;
+            RecordHeader header{};
+            while (in.read(reinterpret_cast<char *>(&header), sizeof(header)))
+            {
+                if (header.lsn != expected || header.length > MAX_RECORD_BYTES ||
+                    !in.read(payload.data(), header.length) ||
+                    recordCrc(utils::Crc32c::compute(payload.data(), header.length), header) != header.crc)
+                {
+                    LOG_F(WARNING, "PacketJournal: %s ends with an incomplete record after LSN %llu",
+                          path.c_str(), static_cast<unsigned long long>(expected - 1));
+                    break;
+                }
+                stats.lastLsn = header.lsn;
+                ++expected;
+                if (header.lsn >= fromLsn)
+                {
+                    fn(static_cast<const RecordHeader &>(header), static_cast<const char *>(payload.data()));
+                    ++stats.records;
+                }
+            }
+            return stats;
+        }
+
+        void flushLoop()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true)
+            {
+                flushCv_.wait_for(lock, options_.commitInterval, [&]
+                                  { return stopping_ || commitRequested_ || active_.size() >= options_.commitBytes; });
+                if (active_.empty() && flushing_.empty())
+                {
+                    commitRequested_ = false;
+                    durableCv_.notify_all();
+                    if (stopping_)
+                        return;
+                    continue;
+                }
+                // 交換緩衝區後放開鎖，寫檔期間 append() 不受影響；
+                // 上一批寫入失敗時 flushing_ 仍保留該批，新記錄接在其後一起重寫 (LSN 必須連續)
+                if (flushing_.empty())
+                {
+                    std::swap(active_, flushing_);
+                }
+                else
+                {
+                    flushing_.insert(flushing_.end(), active_.begin(), active_.end());
+                    active_.clear();
+                }
+                const uint64_t firstLsn = durableLsn() + 1;
+                const uint64_t lastLsn = lastLsn_.load(std::memory_order_relaxed);
+                commitRequested_ = false;
+                lock.unlock();
+
+                const bool written = writeBatch(firstLsn);
+                if (written)
+                {
+                    flushing_.clear();
+                    durableLsn_.store(lastLsn, std::memory_order_release);
+                }
+
+                lock.lock();
+                if (!written)
+                    ++failedFlushes_;
+                durableCv_.notify_all();
+                if (!written && stopping_)
+                {
+                    LOG_F(ERROR, "PacketJournal: stopping with LSN %llu..%llu not written",
+                          static_cast<unsigned long long>(firstLsn), static_cast<unsigned long long>(lastLsn));
+                    return;
+                }
+            }
+        }
+
+        /**
+         * 把 flushing_ 整批寫入目前段 (需要時開新段)，firstLsn 為該批第一筆的 LSN。
+         * 失敗時截回本批之前的長度並關閉此段，下一次從 firstLsn 開新段；截斷也失敗時舊段尾端可能留有本批的部分記錄，
+         * replay 讀到殘缺處即停止該段，完整的重複記錄會在新段中再套用一次 (H01/H05P 以絕對值覆寫，結果相同)。
+         * @return 整批已寫入 (且 fsync 時已落盤)
+         */
+        bool writeBatch(uint64_t firstLsn)
+        {
+            std::lock_guard<std::mutex> segmentLock(segmentMutex_);
+            if (fd_ >= 0 && segmentSize_ >= options_.segmentBytes)
+            {
+                ::close(fd_);
+                fd_ = -1;
+            }
+            if (fd_ < 0)
+            {
+                currentSegment_ = (std::filesystem::path(dir_) / segmentName(firstLsn)).string();
+                fd_ = ::open(currentSegment_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+                segmentSize_ = 0;
+                if (fd_ < 0)
+                {
+                    LOG_F(ERROR, "PacketJournal: cannot create %s: %s", currentSegment_.c_str(), std::strerror(errno));
+                    return false;
+                }
+            }
+            const char *p = flushing_.data();
+            size_t remaining = flushing_.size();
+            while (remaining > 0)
+            {
+                ssize_t n = ::write(fd_, p, remaining);
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    LOG_F(ERROR, "PacketJournal: write to %s failed: %s", currentSegment_.c_str(), std::strerror(errno));
+                    abandonSegment();
+                    return false;
+                }
+                p += n;
+                remaining -= static_cast<size_t>(n);
+            }
+            // fdatasync 失敗後頁面狀態不明 (可能已被丟棄，重試也可能誤報成功)，因此同樣放棄此段改寫新段
+            if (options_.fsync && ::fdatasync(fd_) != 0)
+            {
+                LOG_F(ERROR, "PacketJournal: fdatasync %s failed: %s", currentSegment_.c_str(), std::strerror(errno));
+                abandonSegment();
+                return false;
+            }
+            segmentSize_ += flushing_.size();
+            return true;
+        }
+
+        // 把目前段截回最後一批成功寫入後的長度並關閉 (此方法假設已持有 segmentMutex_)
+        void abandonSegment() noexcept
+        {
+            if (::ftruncate(fd_, static_cast<off_t>(segmentSize_)) != 0)
+                LOG_F(ERROR, "PacketJournal: cannot truncate %s to %zu bytes: %s",
+                      currentSegment_.c_str(), segmentSize_, std::strerror(errno));
+            ::close(fd_);
+            fd_ = -1;
+        }
+
+        const std::string dir_;
+        const Options options_;
+
+        std::mutex mutex_; // 保護 nextLsn_、active_ 與提交旗標
+        std::condition_variable flushCv_;
+        std::condition_variable durableCv_;
+        uint64_t nextLsn_;
+        std::vector<char> active_;   // append() 寫入中的緩衝區
+        bool commitRequested_ = false;
+        bool stopping_ = false;
+        uint64_t failedFlushes_ = 0; // 寫入失敗的批次數，commit() 以此得知本次提交失敗
+        std::atomic<uint64_t> lastLsn_{0};
+        std::atomic<uint64_t> durableLsn_{0};
+
+        std::mutex segmentMutex_;  // 保護目前段的檔案狀態 (寫入與 truncateBefore())
+        std::vector<char> flushing_; // 只由 flush thread 存取；寫入失敗時保留到下次重寫
+        int fd_ = -1;
+        size_t segmentSize_ = 0;
+        std::string currentSegment_;
+        std::thread flusher_;
+    };
+
+} // namespace finance::infrastructure::storage
@@ -7,8 +7,10 @@
 #include <vector>
 #include <memory>
 #include <chrono>
+#include <optional>
 #include <sw/redis++/redis++.h>
 #include "domain/Result.hpp"
+#include "infrastructure/storage/RedisPoolGate.hpp"
 #include <loguru.hpp>
 
 namespace finance::infrastructure::storage
@@ -20,13 +22,29 @@ namespace finance::infrastructure::storage
     using sw::redis::ConnectionOptions;
     using sw::redis::ConnectionPoolOptions;
     using sw::redis::Error;
+    using sw::redis::Pipeline;
     using sw::redis::Redis;
     using sw::redis::ReplyError;
 
+    /// Redis 連線設定；poolSize 為 0 時使用單一連線
+    struct RedisConnectionSettings
+    {
+        std::string url;
+        std::string password;
+        size_t poolSize = 0;
+        std::chrono::milliseconds poolWaitTimeout{0};   // 0 表示無限等待
+        std::chrono::milliseconds connectTimeout{0};    // 0 表示不設限
+        std::chrono::milliseconds socketTimeout{0};     // 0 表示不設限
+        bool keepAlive = true;
+        std::chrono::seconds keepAliveInterval{0};      // 0 表示使用系統預設
+    };
+
     template <typename T, typename E>
     class RedisPlusPlusClient
     {
     public:
+        static constexpr size_t NO_LANE = static_cast<size_t>(-1);
+
         inline RedisPlusPlusClient() noexcept : redis_(nullptr) {}
 
         inline ~RedisPlusPlusClient() { disconnect(); }
@@ -39,9 +57,24 @@ namespace finance::infrastructure::storage
          * @param poolTimeoutMs 從連接池獲取連接的超時時間 (毫秒)。
          * @return Result<void, E> 連接結果。
          */
-        // Removed noexcept as it can throw
         inline Result<void, E> connect(const std::string &url, const std::string &password = "",
                                        size_t poolSize = 0, int poolTimeoutMs = 0)
+        {
+            RedisConnectionSettings settings;
+            settings.url = url;
+            settings.password = password;
+            settings.poolSize = poolSize;
+            settings.poolWaitTimeout = std::chrono::milliseconds(poolTimeoutMs);
+            return connect(settings);
+        }
+
+        /**
+         * @brief 依完整設定連接 Redis (連接池、連線/讀寫超時與 TCP keepalive)。
+         * @param settings 連線設定。
+         * @return Result<void, E> 連接結果。
+         */
+        // Removed noexcept as it can throw
+        inline Result<void, E> connect(const RedisConnectionSettings &settings)
         {
             if (redis_) // Check if already connected
                 return Result<void, E>::Ok();
@@ -50,7 +83,7 @@ namespace finance::infrastructure::storage
             {
                 ConnectionOptions connOpts;
                 // 解析 URL 並設置 host 和 port
-                std::string u = url;
+                std::string u = settings.url;
                 if (u.rfind("tcp://", 0) == 0)
                     u.erase(0, 6); // 去掉前綴
                 if (u.rfind("redis://", 0) == 0)
@@ -59,19 +92,28 @@ namespace finance::infrastructure::storage
                 auto pos = u.find(':');
                 connOpts.host = (pos == std::string::npos) ? u : u.substr(0, pos);
                 connOpts.port = (pos == std::string::npos) ? 6379 : std::stoi(u.substr(pos + 1));
-                connOpts.password = password;
-                connOpts.keep_alive = true;
+                connOpts.password = settings.password;
+                connOpts.connect_timeout = settings.connectTimeout;
+                connOpts.socket_timeout = settings.socketTimeout;
+                connOpts.keep_alive = settings.keepAlive;
+                if (settings.keepAlive && settings.keepAliveInterval.count() > 0)
+                    connOpts.keep_alive_s = settings.keepAliveInterval;
 
                 LOG_F(INFO, "Connecting to Redis: host=%s, port=%d (password provided=%s)",
-                      connOpts.host.c_str(), connOpts.port, password.empty() ? "None" : password.c_str());
+                      connOpts.host.c_str(), connOpts.port, settings.password.empty() ? "None" : "Yes");
+                LOG_F(INFO, "Redis timeouts: connect=%lld ms, socket=%lld ms, keepalive=%s",
+                      static_cast<long long>(settings.connectTimeout.count()),
+                      static_cast<long long>(settings.socketTimeout.count()),
+                      settings.keepAlive ? "on" : "off");
 
-                if (poolSize > 0)
+                if (settings.poolSize > 0)
                 {
                     ConnectionPoolOptions poolOpts;
-                    poolOpts.size = poolSize;
-                    poolOpts.wait_timeout = std::chrono::milliseconds(poolTimeoutMs);
+                    poolOpts.size = settings.poolSize;
+                    poolOpts.wait_timeout = settings.poolWaitTimeout;
 
-                    LOG_F(INFO, "Using Redis connection pool: size=%zu, wait timeout=%d ms", poolSize, poolTimeoutMs);
+                    LOG_F(INFO, "Using Redis connection pool: size=%zu, wait timeout=%lld ms",
+                          settings.poolSize, static_cast<long long>(settings.poolWaitTimeout.count()));
 
                     // 使用支持 Connection Pool 的构造函数
                     redis_ = std::make_shared<Redis>(connOpts, poolOpts); // 使用 ConnectionOptions和 ConnectionPoolOptions 初始化 Redis
@@ -81,6 +123,8 @@ namespace finance::infrastructure::storage
                     LOG_F(INFO, "Using single Redis connection.");
                     redis_ = std::make_shared<Redis>(connOpts); // 使用单连接初始化 Redis
                 }
+                // 單一連線時閘門容量為 1：命令本來就在同一條連線上排隊，閘門只讓等待可被量測
+                poolGate_.configure(settings.poolSize, settings.poolWaitTimeout);
 
                 // 驗證 PING 命令
                 auto ping_res = command<std::string>("PING");
@@ -122,8 +166,25 @@ namespace finance::infrastructure::storage
             }
         }
 
+        /**
+         * @brief 設定批次寫入通道數。每條通道在首次使用時建立一條專屬連線的 Pipeline，
+         *        之後只由該通道的寫入執行緒使用；須在寫入執行緒啟動前呼叫。
+         */
+        void setPipelineLanes(size_t lanes)
+        {
+            lanePipelines_.clear();
+            lanePipelines_.resize(lanes);
+        }
+
+        /// 共用連線池的使用統計 (借用次數、等待時間、耗盡次數)
+        RedisPoolStats poolStats() const
+        {
+            return poolGate_.stats();
+        }
+
         inline Result<void, E> disconnect() noexcept
         {
+            lanePipelines_.clear();
             redis_.reset();
             LOG_F(INFO, "Redis client disconnected.");
             return Result<void, E>::Ok();
@@ -134,6 +195,9 @@ namespace finance::infrastructure::storage
             if (!redis_)
                 return Result<T, E>::Err({ErrorCode::RedisConnectionFailed,
                                           "Redis not connected"});
+            auto lease = poolGate_.acquire();
+            if (!lease.ok())
+                return Result<T, E>::Err(poolExhausted());
             try
             {
                 auto val = redis_->get(key);
@@ -156,6 +220,9 @@ namespace finance::infrastructure::storage
             if (!redis_)
                 return Result<void, E>::Err({ErrorCode::RedisConnectionFailed,
                                              "Redis not connected"});
+            auto lease = poolGate_.acquire();
+            if (!lease.ok())
+                return Result<void, E>::Err(poolExhausted());
             try
             {
                 redis_->set(key, value);
@@ -173,6 +240,9 @@ namespace finance::infrastructure::storage
             if (!redis_)
                 return Result<void, E>::Err({ErrorCode::RedisConnectionFailed,
                                              "Redis not connected"});
+            auto lease = poolGate_.acquire();
+            if (!lease.ok())
+                return Result<void, E>::Err(poolExhausted());
             try
             {
                 redis_->del(key);
@@ -190,6 +260,9 @@ namespace finance::infrastructure::storage
             if (!redis_)
                 return Result<std::vector<std::string>, E>::Err(ErrorResult(
                     ErrorCode::RedisConnectionFailed, "Redis not connected"));
+            auto lease = poolGate_.acquire();
+            if (!lease.ok())
+                return Result<std::vector<std::string>, E>::Err(poolExhausted());
             try
             {
                 std::vector<std::string> result;
@@ -217,6 +290,9 @@ namespace finance::infrastructure::storage
             if (!redis_)
                 return Result<ReplyT, E>::Err(ErrorResult(ErrorCode::RedisConnectionFailed, "Redis client not connected"));
 
+            auto lease = poolGate_.acquire();
+            if (!lease.ok())
+                return Result<ReplyT, E>::Err(poolExhausted());
             try
             {
                 // Execute command using the shared Redis connection pool instance
@@ -263,12 +339,99 @@ namespace finance::infrastructure::storage
             }
         }
 
+        /**
+         * @brief 以單一 Pipeline 送出多個命令 (一次網路往返)，可選以 MULTI/EXEC 包成交易。
+         * @param commands 每個元素為一個命令及其參數，例如 {"JSON.SET", key, "$", json}。
+         * @param transaction 是否以 MULTI/EXEC 原子執行。
+         * @param lane 寫入通道編號；小於 setPipelineLanes() 設定的數量時使用該通道專屬連線的 Pipeline，
+         *             否則向連線池借用一條連線。
+         * @return 依序對應每個命令的結果；整批送出失敗時每個結果皆為該錯誤。
+         */
+        std::vector<Result<void, E>> commandBatch(const std::vector<std::vector<std::string>> &commands,
+                                                  bool transaction = false, size_t lane = NO_LANE)
+        {
+            std::vector<Result<void, E>> results;
+            if (commands.empty())
+                return results;
+            if (!redis_)
+            {
+                results.assign(commands.size(), Result<void, E>::Err(
+                                                    ErrorResult(ErrorCode::RedisConnectionFailed, "Redis client not connected")));
+                return results;
+            }
+
+            results.reserve(commands.size());
+            // 通道專屬連線不佔用連線池；其餘路徑整批期間借用連線池中的一條連線
+            bool pooled = transaction || lane >= lanePipelines_.size();
+            std::optional<RedisPoolGate::Lease> lease;
+            if (pooled)
+            {
+                lease.emplace(poolGate_.acquire());
+                if (!lease->ok())
+                {
+                    results.assign(commands.size(), Result<void, E>::Err(poolExhausted()));
+                    return results;
+                }
+            }
+            try
+            {
+                if (transaction)
+                {
+                    auto tx = redis_->transaction(true, false);
+                    for (const auto &cmd : commands)
+                        tx.command(cmd.begin(), cmd.end());
+                    collectReplies(tx.exec(), commands.size(), results);
+                }
+                else if (lane < lanePipelines_.size())
+                {
+                    // 通道專屬連線：Pipeline 重複使用，出錯時丟棄並於下次重建
+                    auto &pipe = lanePipelines_[lane];
+                    if (!pipe)
+                        pipe = std::make_unique<Pipeline>(redis_->pipeline(true));
+                    try
+                    {
+                        for (const auto &cmd : commands)
+                            pipe->command(cmd.begin(), cmd.end());
+                        collectReplies(pipe->exec(), commands.size(), results);
+                    }
+                    catch (...)
+                    {
+                        pipe.reset();
+                        throw;
+                    }
+                }
+                else
+                {
+                    auto pipe = redis_->pipeline(false);
+                    for (const auto &cmd : commands)
+                        pipe.command(cmd.begin(), cmd.end());
+                    collectReplies(pipe.exec(), commands.size(), results);
+                }
+            }
+            catch (const Error &e)
+            {
+                LOG_F(WARNING, "Redis pipeline error (%zu commands): %s", commands.size(), e.what());
+                results.assign(commands.size(), Result<void, E>::Err(
+                                                    ErrorResult{ErrorCode::RedisCommandFailed, "Redis Pipeline Error: " + std::string(e.what())}));
+            }
+            catch (const std::exception &ex)
+            {
+                LOG_F(ERROR, "Unexpected exception during Redis pipeline: %s", ex.what());
+                results.assign(commands.size(), Result<void, E>::Err(
+                                                    ErrorResult{ErrorCode::UnexpectedError, "意外異常 (Redis Pipeline): " + std::string(ex.what())}));
+            }
+            return results;
+        }
+
         inline Result<std::string, E> getJson(const std::string &key,
                                               const std::string &path = "$")
         {
             if (!redis_)
                 return Result<std::string, E>::Err(ErrorResult(
                     ErrorCode::RedisConnectionFailed, "Redis not connected"));
+            auto lease = poolGate_.acquire();
+            if (!lease.ok())
+                return Result<std::string, E>::Err(poolExhausted());
             try
             {
                 auto str = redis_->command<std::string>("JSON.GET", key, path);
@@ -298,6 +461,9 @@ namespace finance::infrastructure::storage
             if (!redis_)
                 return Result<void, E>::Err({ErrorCode::RedisConnectionFailed,
                                              "Redis not connected"});
+            auto lease = poolGate_.acquire();
+            if (!lease.ok())
+                return Result<void, E>::Err(poolExhausted());
             try
             {
                 redis_->command<void>("JSON.SET", key, path, jsonValue);
@@ -310,7 +476,42 @@ namespace finance::infrastructure::storage
         }
 
     private:
+        // 等待連線池逾時：記錄並回傳錯誤，呼叫端不會在 redis++ 內部再等待一次
+        ErrorResult poolExhausted() const
+        {
+            auto stats = poolGate_.stats();
+            LOG_F(WARNING, "Redis connection pool exhausted (size=%zu, exhausted=%llu)",
+                  stats.size, static_cast<unsigned long long>(stats.exhausted));
+            return ErrorResult{ErrorCode::RedisCommandFailed, "Redis connection pool exhausted"};
+        }
+
+        // 逐一檢查 pipeline 回覆，單一命令失敗不影響其他命令的結果
+        template <typename Replies>
+        static void collectReplies(Replies &&replies, size_t count, std::vector<Result<void, E>> &results)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                try
+                {
+                    replies.template get<void>(i);
+                    results.push_back(Result<void, E>::Ok());
+                }
+                catch (const ReplyError &e)
+                {
+                    results.push_back(Result<void, E>::Err(
+                        ErrorResult{ErrorCode::RedisReplyTypeError, "Redis ReplyError: " + std::string(e.what())}));
+                }
+                catch (const Error &e)
+                {
+                    results.push_back(Result<void, E>::Err(
+                        ErrorResult{ErrorCode::RedisCommandFailed, "Redis Command Error: " + std::string(e.what())}));
+                }
+            }
+        }
+
         std::shared_ptr<Redis> redis_;
+        std::vector<std::unique_ptr<Pipeline>> lanePipelines_; // 每個寫入通道專屬的 Pipeline
+        RedisPoolGate poolGate_;                               // 共用連線池的借用閘門與統計
     };
 
 } // namespace finance::infrastructure::storage
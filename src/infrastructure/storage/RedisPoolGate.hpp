@@ -0,0 +1,117 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace finance::infrastructure::storage
+{
+
+    /// Redis 連線池使用統計
+    struct RedisPoolStats
+    {
+        size_t size = 0;          // 連線池大小
+        size_t inUse = 0;         // 目前借出的連線數
+        uint64_t acquired = 0;    // 累計借用次數
+        uint64_t waited = 0;      // 借用時需要等待的次數
+        uint64_t exhausted = 0;   // 等待逾時 (連線池耗盡) 的次數
+        uint64_t totalWaitUs = 0; // 累計等待時間 (us)
+        uint64_t maxWaitUs = 0;   // 單次最長等待時間 (us)
+    };
+
+    /**
+     * 連線池的計數閘門：同時執行的命令數不超過連線池大小，
+     * 因此 redis++ 內部的連線池不會再等待，等待時間與耗盡次數都能在這裡量測。
+     * 等待逾時 (waitTimeout > 0) 時借用失敗並計入 exhausted；waitTimeout 為 0 表示無限等待。
+     */
+    class RedisPoolGate
+    {
+    public:
+        /// 借用一條連線的 RAII 憑證；ok() 為 false 表示等待逾時
+        class Lease
+        {
+        public:
+            explicit Lease(RedisPoolGate *gate) noexcept : gate_(gate) {}
+            Lease(Lease &&other) noexcept : gate_(other.gate_) { other.gate_ = nullptr; }
+            Lease(const Lease &) = delete;
+            Lease &operator=(const Lease &) = delete;
+            Lease &operator=(Lease &&) = delete;
+            ~Lease()
+            {
+                if (gate_)
+                    gate_->release();
+            }
+
+            bool ok() const noexcept { return gate_ != nullptr; }
+
+        private:
+            RedisPoolGate *gate_;
+        };
+
+        void configure(size_t size, std::chrono::milliseconds waitTimeout)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.size = size == 0 ? 1 : size;
+            waitTimeout_ = waitTimeout;
+        }
+
+        Lease acquire()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ++stats_.acquired;
+            if (stats_.inUse < stats_.size)
+            {
+                ++stats_.inUse;
+                return Lease(this);
+            }
+
+            ++stats_.waited;
+            auto start = std::chrono::steady_clock::now();
+            auto available = [this]
+            { return stats_.inUse < stats_.size; };
+            bool got = true;
+            if (waitTimeout_.count() > 0)
+                got = cv_.wait_for(lock, waitTimeout_, available);
+            else
+                cv_.wait(lock, available);
+
+            auto waitedUs = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+            stats_.totalWaitUs += waitedUs;
+            if (waitedUs > stats_.maxWaitUs)
+                stats_.maxWaitUs = waitedUs;
+
+            if (!got)
+            {
+                ++stats_.exhausted;
+                return Lease(nullptr);
+            }
+            ++stats_.inUse;
+            return Lease(this);
+        }
+
+        RedisPoolStats stats() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return stats_;
+        }
+
+    private:
+        void release()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --stats_.inUse;
+            }
+            cv_.notify_one();
+        }
+
+        RedisPoolStats stats_{1, 0, 0, 0, 0, 0, 0};
+        std::chrono::milliseconds waitTimeout_{0};
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+    };
+
+} // namespace finance::infrastructure::storage
@@ -5,7 +5,15 @@
 #include "utils/FinanceUtils.hpp"
 #include "infrastructure/config/ConnectionConfigProvider.hpp"
 #include "infrastructure/config/AreaBranchProvider.hpp"
+#include "infrastructure/config/StockUniverse.hpp"
 #include "RedisPlusPlusClient.hpp"
+#include "SummaryJsonWriter.hpp"
+#include "CompanySummaryAggregator.hpp"
+#include "SummaryTable.hpp"
+#include "MappedSummaryFile.hpp"
+#include "domain/AvailabilityColumns.hpp"
+#include "domain/SummaryKey.hpp"
+#include "domain/SummarySnapshot.hpp"
 #include "domain/IFinanceRepository.hpp"
 #include "infrastructure/tasks/RedisTask.hpp"
 #include "infrastructure/tasks/RedisWorker.hpp"
@@ -16,6 +24,7 @@
 #include <loguru.hpp>
 #include <optional>
 #include <vector>
+#include <tuple>
 #include <future>
 #include <functional>
 
@@ -25,6 +34,8 @@ namespace finance::infrastructure::storage
     using finance::domain::ErrorResult;
     using finance::domain::Result;
     using finance::domain::SummaryData;
+    using finance::domain::SummaryKey;
+    using finance::domain::SummarySnapshot;
     using finance::infrastructure::tasks::RedisOperationType;
     using finance::infrastructure::tasks::RedisTask;
 
@@ -35,12 +46,22 @@ namespace finance::infrastructure::storage
     {
     public:
         using TaskSubmitter = std::function<std::future<Result<void, ErrorResult>>(RedisTask)>;
+        using TaskPoster = std::function<void(RedisTask)>; // 不需要結果的任務
 
         /**
          * @brief 構造函數但不立即連接 Redis，需要調用 init() 來初始化連線。
+         * @param cachePartitions 快取分區數：依 SummaryKey::shard() 把股票分到各分區，每個分區各有一把鎖與自己的總公司彙總。
+         *        與分片管線的 shard 數、Redis 寫入 worker 數相同時，每個分區只會被一個 shard thread 與一個 writer 存取。
          */
-        RedisSummaryAdapter(TaskSubmitter submitter = nullptr) noexcept
-            : task_submitter_(std::move(submitter)) {}
+        explicit RedisSummaryAdapter(TaskSubmitter submitter = nullptr, size_t cachePartitions = 1)
+            : task_submitter_(std::move(submitter))
+        {
+            if (cachePartitions == 0)
+                cachePartitions = 1;
+            partitions_.reserve(cachePartitions);
+            for (size_t i = 0; i < cachePartitions; ++i)
+                partitions_.push_back(std::make_unique<CachePartition>());
+        }
 
         ~RedisSummaryAdapter() noexcept = default;
 
@@ -50,16 +71,25 @@ namespace finance::infrastructure::storage
          */
         Result<void, ErrorResult> init() override
         {
-            // 此處不涉及 summaryCacheData_ 的並行存取，因為通常在單一執行緒中初始化
+            // 此處不涉及快取的並行存取，因為通常在單一執行緒中初始化
             if (redisClient_)
                 return Result<void, ErrorResult>::Ok();
 
+            using Config = config::ConnectionConfigProvider;
             auto client = std::make_unique<RedisPlusPlusClient<SummaryData, ErrorResult>>();
-            std::string uri = config::ConnectionConfigProvider::redisUri();
-            std::string password = config::ConnectionConfigProvider::redisPassword();
-            return client->connect(uri, password)
+            RedisConnectionSettings settings;
+            settings.url = Config::redisUri();
+            settings.password = Config::redisPassword();
+            settings.poolSize = Config::redisPoolSize();
+            settings.poolWaitTimeout = std::chrono::milliseconds(Config::redisPoolWaitTimeoutMs());
+            settings.connectTimeout = std::chrono::milliseconds(Config::redisConnectTimeoutMs());
+            settings.socketTimeout = std::chrono::milliseconds(Config::redisSocketTimeoutMs());
+            settings.keepAlive = Config::redisKeepAlive();
+            settings.keepAliveInterval = std::chrono::seconds(Config::redisKeepAliveIntervalS());
+            return client->connect(settings)
                 .and_then([&]
                           {
+                    client->setPipelineLanes(Config::redisWorkerCount());
                     this->redisClient_ = std::move(client);
                     return Result<void, ErrorResult>::Ok(); })
                 .and_then([this]
@@ -189,8 +219,9 @@ namespace finance::infrastructure::storage
 
             // Update local cache with exclusive lock
             {
-                std::unique_lock<std::shared_mutex> lock(cacheMutex_);
-                summaryCacheData_[key] = *data;
+                auto &partition = partitionFor(key);
+                std::unique_lock<std::shared_mutex> lock(partition.mutex);
+                storeLocked(partition, key, *data);
             }
 
             // Persist to Redis without holding the lock
@@ -209,21 +240,48 @@ namespace finance::infrastructure::storage
         // 於 RedisSummaryAdapter.hpp 內
         Result<finance::domain::SummaryData *, finance::domain::ErrorResult> getData(const std::string &key) override
         {
-            // 首先嘗試使用共享鎖進行讀取
-            {
-                std::shared_lock<std::shared_mutex> read_lock(cacheMutex_);
-                auto it = summaryCacheData_.find(key);
-                if (it != summaryCacheData_.end())
-                {
-                    return Result<finance::domain::SummaryData *, finance::domain::ErrorResult>::Ok(&(it->second));
-                }
-            } // read_lock 在此釋放
+            if (auto packed = SummaryKey::parse(key))
+                return getData(*packed);
+
+            // 非 summary:AREA:STOCK 格式的 key 一律放在第一個分區
+            auto &partition = *partitions_.front();
+            std::unique_lock<std::shared_mutex> write_lock(partition.mutex);
+            return Result<finance::domain::SummaryData *, finance::domain::ErrorResult>::Ok(partition.table.emplace(key).first);
+        }
+
+        /**
+         * @brief 以壓縮鍵讀取快取資料，不存在時建立空資料 (不產生 Redis key 字串)。
+         *        區中心項目只由處理該 key 封包的 handler 執行緒透過此指標修改，修改完成後以 sync_detached() 發佈；
+         *        其他執行緒一律以 snapshot() 讀取。
+         * @return Result<SummaryData*> 指向快取中物件的指標，移除前位址固定
+         */
+        Result<finance::domain::SummaryData *, finance::domain::ErrorResult> getData(const SummaryKey &key) override
+        {
+            // 設定 stock universe 時，清單外的股票在查表前即被排除
+            if (universe_ && !universe_->mayContain(key.stockBits()))
+                return Result<finance::domain::SummaryData *, finance::domain::ErrorResult>::Err(
+                    ErrorResult{ErrorCode::UnknownStock, "Stock not in universe: " + key.stock()});
+
+            auto &partition = partitionFor(key);
+            // 已存在的項目以無鎖索引查詢，不與寫者互相阻擋
+            if (auto *data = partition.table.find(key))
+                return Result<finance::domain::SummaryData *, finance::domain::ErrorResult>::Ok(data);
 
             // 若未找到，則取得獨占鎖以進行寫入
-            std::unique_lock<std::shared_mutex> write_lock(cacheMutex_);
+            std::unique_lock<std::shared_mutex> write_lock(partition.mutex);
+            return Result<finance::domain::SummaryData *, finance::domain::ErrorResult>::Ok(partition.table.emplace(key).first);
+        }
 
-            auto [it, inserted] = summaryCacheData_.emplace(key, finance::domain::SummaryData{});
-            return Result<finance::domain::SummaryData *, finance::domain::ErrorResult>::Ok(&(it->second));
+        /**
+         * @brief 無鎖讀取快取資料最近一次發佈的一致快照 (sync / setData / sync_detached 時發佈)，不會阻擋寫者。
+         * @return 不存在或尚未發佈時回傳 std::nullopt
+         */
+        std::optional<SummarySnapshot> snapshot(const SummaryKey &key) const noexcept
+        {
+            SummarySnapshot out;
+            if (!partitionFor(key).table.readPublished(key, out))
+                return std::nullopt;
+            return out;
         }
 
         /**
@@ -237,11 +295,11 @@ namespace finance::infrastructure::storage
                     ErrorResult{ErrorCode::RedisConnectionFailed, "Redis 未正確連線"});
 
             const auto pattern = "summary:*";
-            // Redis 的 keys 操作本身不直接影響 summaryCacheData_
+            // Redis 的 keys 操作本身不直接影響快取
             return redisClient_->keys(pattern)
                 .and_then([this](const std::vector<std::string> &keys)
                           {
-                              // loadAndCacheKeysData 會修改 summaryCacheData_，所以需要在其外部或內部加獨佔鎖
+                              // loadAndCacheKeysData 會修改快取，所以需要在其外部或內部加獨佔鎖
                               return this->loadAndCacheKeysData(keys); // 傳遞 this 指標
                           })
                 .map_err([](const ErrorResult &e)
@@ -256,8 +314,9 @@ namespace finance::infrastructure::storage
          */
         Result<void, ErrorResult> setData(const std::string &key, const SummaryData &data) override
         {
-            std::unique_lock<std::shared_mutex> lock(cacheMutex_);
-            summaryCacheData_[key] = data;
+            auto &partition = partitionFor(key);
+            std::unique_lock<std::shared_mutex> lock(partition.mutex);
+            storeLocked(partition, key, data);
             return Result<void, ErrorResult>::Ok();
         }
 
@@ -274,35 +333,79 @@ namespace finance::infrastructure::storage
                 return Result<void, ErrorResult>::Err(
                     ErrorResult{ErrorCode::RedisConnectionFailed, "Redis 未正確連線"});
 
-            SummaryData company_summary;
-            company_summary.stock_id = stock_id;
-            company_summary.area_center = "ALL";
-            company_summary.belong_branches = config::AreaBranchProvider::getAllBranches();
+            SummaryData company_summary = buildCompanySummary(stock_id);
+
+            auto all_key = "summary:ALL:" + stock_id;
+            return sync(all_key, &company_summary);
+        }
+
+        /**
+         * @brief 批次同步：所有區中心資料與總公司彙總以單一 Redis pipeline 寫入 (一次往返)。
+         * @param syncs 要同步的 (key, 資料) 列表
+         * @param updates 要重新彙總的股票 ID 列表
+         * @param lane 寫入通道編號，對應 RedisPlusPlusClient 的專屬 pipeline 連線
+         * @return 依序對應 syncs 後接 updates 的結果
+         */
+        std::vector<Result<void, ErrorResult>> syncBatch(const std::vector<std::pair<std::string, const SummaryData *>> &syncs,
+                                                         const std::vector<std::string> &updates,
+                                                         size_t lane) override
+        {
+            const size_t total = syncs.size() + updates.size();
+            if (!redisClient_)
+                return std::vector<Result<void, ErrorResult>>(
+                    total, Result<void, ErrorResult>::Err(ErrorResult{ErrorCode::RedisConnectionFailed, "Redis 未正確連線"}));
 
-            // Use shared lock for reading cache data
+            // 區中心資料只序列化任務中的副本送往 Redis，不寫回快取：快取項目只由 handler 執行緒寫入，
+            // 總公司彙總也已在 handler 發佈時 (commitEntry()) 更新，worker 寫回較舊的副本會覆蓋 handler 之後的修改
+            std::vector<std::string> keys;
+            std::vector<Result<std::string, ErrorResult>> payloads;
+            keys.reserve(total);
+            payloads.reserve(total);
+            for (const auto &[key, data] : syncs)
+            {
+                keys.push_back(key);
+                payloads.push_back(summaryDataToJson(data));
+            }
+            // 總公司 (ALL) 項目沒有 handler 寫入，由負責該股票通道的 worker 重算後寫入快取
+            for (const auto &stock_id : updates)
             {
-                std::shared_lock<std::shared_mutex> read_lock(cacheMutex_);
-                for (const std::string &officeId : config::AreaBranchProvider::getBackofficeIds())
+                SummaryData company_summary = buildCompanySummary(stock_id);
+                std::string all_key = "summary:ALL:" + stock_id;
                 {
-                    const std::string key = "summary:" + officeId + ":" + stock_id;
-                    auto it = summaryCacheData_.find(key);
-                    if (it != summaryCacheData_.end())
-                    {
-                        const auto &area_summary_data = it->second;
-                        company_summary.margin_available_amount += area_summary_data.margin_available_amount;
-                        company_summary.margin_available_qty += area_summary_data.margin_available_qty;
-                        company_summary.short_available_amount += area_summary_data.short_available_amount;
-                        company_summary.short_available_qty += area_summary_data.short_available_qty;
-                        company_summary.after_margin_available_amount += area_summary_data.after_margin_available_amount;
-                        company_summary.after_margin_available_qty += area_summary_data.after_margin_available_qty;
-                        company_summary.after_short_available_amount += area_summary_data.after_short_available_amount;
-                        company_summary.after_short_available_qty += area_summary_data.after_short_available_qty;
-                    }
+                    auto &partition = partitionFor(all_key);
+                    std::unique_lock<std::shared_mutex> lock(partition.mutex);
+                    storeLocked(partition, all_key, company_summary);
                 }
+                keys.push_back(std::move(all_key));
+                payloads.push_back(summaryDataToJson(&company_summary));
             }
 
-            auto all_key = "summary:ALL:" + stock_id;
-            return sync(all_key, &company_summary);
+            // 只送出序列化成功的項目，並記錄其在結果中的位置
+            std::vector<std::vector<std::string>> commands;
+            std::vector<size_t> commandIndex;
+            commands.reserve(total);
+            commandIndex.reserve(total);
+            std::vector<Result<void, ErrorResult>> results(total, Result<void, ErrorResult>::Ok());
+            for (size_t i = 0; i < total; ++i)
+            {
+                if (payloads[i].is_err())
+                {
+                    results[i] = Result<void, ErrorResult>::Err(
+                        ErrorResult{payloads[i].unwrap_err().code, "Sync 失敗: " + payloads[i].unwrap_err().message});
+                    continue;
+                }
+                commands.push_back({"JSON.SET", std::move(keys[i]), "$", std::move(payloads[i].unwrap())});
+                commandIndex.push_back(i);
+            }
+
+            auto replies = redisClient_->commandBatch(commands, config::ConnectionConfigProvider::redisPipelineTransaction(), lane);
+            for (size_t c = 0; c < replies.size(); ++c)
+            {
+                if (replies[c].is_err())
+                    results[commandIndex[c]] = Result<void, ErrorResult>::Err(
+                        ErrorResult{replies[c].unwrap_err().code, "Sync 失敗: " + replies[c].unwrap_err().message});
+            }
+            return results;
         }
 
         /**
@@ -319,8 +422,19 @@ namespace finance::infrastructure::storage
             auto res = redisClient_->del(key);
             if (res.is_ok())
             {
-                std::unique_lock<std::shared_mutex> lock(cacheMutex_);
-                summaryCacheData_.erase(key);
+                auto &partition = partitionFor(key);
+                std::unique_lock<std::shared_mutex> lock(partition.mutex);
+                if (auto packed = SummaryKey::parse(key))
+                {
+                    partition.table.erase(*packed);
+                    partition.aggregate.remove(*packed);
+                    if (persistentCache_)
+                        persistentCache_->erase(*packed);
+                }
+                else
+                {
+                    partition.table.erase(key);
+                }
                 return true;
             }
             return false;
@@ -342,7 +456,7 @@ namespace finance::infrastructure::storage
                 return err_promise.get_future();
             }
 
-            LOG_F(INFO, "RedisSummaryAdapter: Queuing async SYNC task for key %s", key.c_str());
+            DLOG_F(INFO, "RedisSummaryAdapter: Queuing async SYNC task for key %s", key.c_str());
             return task_submitter_(
                 RedisTask(
                     RedisOperationType::SYNC_SUMMARY_DATA,
@@ -366,7 +480,7 @@ namespace finance::infrastructure::storage
                 return err_promise.get_future();
             }
 
-            LOG_F(INFO, "RedisSummaryAdapter: Queuing async UPDATE task for stock_id %s", stock_id.c_str());
+            DLOG_F(INFO, "RedisSummaryAdapter: Queuing async UPDATE task for stock_id %s", stock_id.c_str());
             return task_submitter_(
                 RedisTask(
                     RedisOperationType::UPDATE_COMPANY_SUMMARY,
@@ -374,20 +488,439 @@ namespace finance::infrastructure::storage
                     nullptr));
         }
 
+        /**
+         * @brief 不需要結果的異步同步：任務以壓縮鍵送出，不配置 promise，Redis key 延後到 worker 寫入時才產生。
+         *        呼叫端 (handler) 修改完快取項目後呼叫，先在本執行緒更新總公司彙總並發佈，worker 只負責寫入 Redis。
+         *        未設定 task poster 時退回 sync_async()。
+         */
+        void sync_detached(const SummaryKey &key, const SummaryData &data_to_sync) override
+        {
+            commitEntry(key, data_to_sync);
+            if (!task_poster_)
+            {
+                (void)sync_async(key.redisKey(), data_to_sync);
+                return;
+            }
+            task_poster_(RedisTask(RedisOperationType::SYNC_SUMMARY_DATA, key, data_to_sync));
+        }
+
+        /**
+         * @brief 不需要結果的異步更新總公司資料 (key 只使用股票代號部分)。未設定 task poster 時退回 update_async()。
+         */
+        void update_detached(const SummaryKey &key) override
+        {
+            auto allKey = SummaryKey::fromPacked(key.stockBits() | ALL_AREA_BITS);
+            if (!task_poster_)
+            {
+                (void)update_async(allKey.stock());
+                return;
+            }
+            task_poster_(RedisTask(RedisOperationType::UPDATE_COMPANY_SUMMARY, allKey));
+        }
+
         void setTaskSubmitter(TaskSubmitter submitter)
         {
             task_submitter_ = std::move(submitter);
         }
 
+        void setTaskPoster(TaskPoster poster)
+        {
+            task_poster_ = std::move(poster);
+        }
+
+        /**
+         * @brief 以欄式批次核心重算快取中所有帶有原始輸入的 entry 的可用數量，並更新總公司彙總。
+         *        目前沒有正式的呼叫端：由 Redis 載入的 entry 沒有原始輸入 (hasRawInputs() 為 false)，啟動時重算必為空操作，
+         *        快取檔還原的 entry 已帶有可用數量。保留給之後區中心/分公司設定重新載入或 'F' 全量重送等需要整批重算的路徑。
+         *        AvailabilityColumns 只是重算時的 gather/scatter 暫存，不是快取項目的常駐存放，整批重算不會比逐筆計算快多少。
+         *        會直接寫入 handler 擁有的快取項目，只能在沒有封包處理中時呼叫 (例如開始收封包之前)。
+         * @return 重算的筆數
+         */
+        size_t recalculateAll()
+        {
+            auto locks = lockAllPartitions();
+            return recalculateAllLocked();
+        }
+
+        /**
+         * @brief 依股票清單預先建立所有 (區中心, 股票) 與總公司 (ALL) 的快取項目，並啟用清單外股票的過濾。
+         *        各分區的 slab 與索引一次配置到位，交易時段不再配置或重建索引。需在 loadAll() 之後、開始收封包之前呼叫
+         *        (已由 Redis 載入的項目保留原值)。
+         * @return 新建立的項目數
+         */
+        size_t preallocate(const config::StockUniverse &universe)
+        {
+            const auto &areas = config::AreaBranchProvider::getBackofficeIds();
+            std::vector<SummaryKey> keys;
+            keys.reserve(universe.size() * (areas.size() + 1));
+            for (const auto &stock : universe.stockIds())
+            {
+                for (const auto &area : areas)
+                    if (auto key = SummaryKey::make(area, stock))
+                        keys.push_back(*key);
+                keys.push_back(SummaryKey::fromPacked(*SummaryKey::stockBitsOf(stock) | ALL_AREA_BITS));
+            }
+
+            auto locks = lockAllPartitions();
+            std::vector<size_t> perPartition(partitions_.size(), 0);
+            for (const auto &key : keys)
+                ++perPartition[key.shard(partitions_.size())];
+            for (size_t p = 0; p < partitions_.size(); ++p)
+                partitions_[p]->table.reserve(partitions_[p]->table.size() + perPartition[p]);
+
+            size_t created = 0;
+            for (const auto &key : keys)
+            {
+                auto [data, inserted] = partitionFor(key).table.emplace(key);
+                if (!inserted)
+                    continue;
+                data->stock_id = key.stock();
+                data->area_center = key.area();
+                data->belong_branches = branchListFor(key);
+                publishEntry(partitionFor(key), key, *data);
+                ++created;
+            }
+            universe_ = std::make_unique<config::StockUniverse>(universe);
+            LOG_F(INFO, "RedisSummaryAdapter: preallocated %zu entries for %zu stocks x %zu areas (+ALL).",
+                  created, universe.size(), areas.size());
+            return created;
+        }
+
+        /**
+         * @brief 啟用快取檔：先以檔案內容還原快取 (取代 loadAll() 的逐筆 JSON.GET)，之後每次發佈快取資料都寫入檔案。
+         *        需在開始收封包之前呼叫。還原的項目帶有 H01/H05P 原始輸入與可用數量，不需要重算。
+         * @return 還原的項目數；為 0 時 (新檔或格式不符) 呼叫端應改以 loadAll() 從 Redis 載入
+         */
+        size_t attachPersistentCache(std::unique_ptr<MappedSummaryFile> file)
+        {
+            auto locks = lockAllPartitions();
+            restoredKeys_.clear();
+            file->forEach([this](SummaryKey key, const SummarySnapshot &record)
+                          {
+                              auto &partition = partitionFor(key);
+                              auto *data = partition.table.emplace(key).first;
+                              *data = record.toSummaryData();
+                              data->belong_branches = branchListFor(key);
+                              SummarySnapshot snapshot = record;
+                              snapshot.belong_branches = data->belong_branches;
+                              partition.table.publish(key, snapshot);
+                              partition.aggregate.apply(key, *data);
+                              restoredKeys_.push_back(key); });
+            LOG_F(INFO, "RedisSummaryAdapter: restored %zu entries from summary cache file (%zu torn records discarded, capacity %zu).",
+                  restoredKeys_.size(), file->discardedRecords(), file->capacity());
+            persistentCache_ = std::move(file);
+            return restoredKeys_.size();
+        }
+
+        /**
+         * @brief 快取檔還原後與 Redis 對帳，可在開始收封包後於背景執行：
+         *        1. 還原的項目重新送出同步任務，補上前次程序結束時尚未寫入 Redis 的資料 (快取檔一律比 Redis 新)；
+         *           總公司 (ALL) 項目由背景重算，檔案中的值可能落後於已還原的區中心資料，改以彙總結果重算；
+         *        2. Redis 中有而快取沒有的 key (例如寫入途中結束被捨棄的記錄) 逐筆載入，已被新封包建立的項目不覆蓋。
+         * @return 從 Redis 補載入的筆數
+         */
+        Result<size_t, ErrorResult> reconcile()
+        {
+            if (!redisClient_)
+                return Result<size_t, ErrorResult>::Err(ErrorResult{ErrorCode::RedisConnectionFailed, "Redis 未正確連線"});
+
+            size_t resynced = 0;
+            for (const auto &key : restoredKeys_)
+            {
+                if (key.areaBits() == ALL_AREA_BITS)
+                {
+                    update_detached(key);
+                    ++resynced;
+                    continue;
+                }
+                auto current = snapshot(key); // 與 handler 並行，只讀一致快照
+                if (!current)
+                    continue;
+                sync_detached(key, current->toSummaryData());
+                ++resynced;
+            }
+
+            auto keysRes = redisClient_->keys("summary:*");
+            if (keysRes.is_err())
+                return Result<size_t, ErrorResult>::Err(
+                    ErrorResult{keysRes.unwrap_err().code, "Reconcile 失敗: " + keysRes.unwrap_err().message});
+
+            size_t loaded = 0;
+            for (const auto &key : keysRes.unwrap())
+            {
+                auto &partition = partitionFor(key);
+                auto packed = SummaryKey::parse(key);
+                if (packed ? partition.table.find(*packed) != nullptr : cachedUnpacked(partition, key))
+                    continue;
+
+                auto parsed = redisClient_->getJson(key, "$").and_then([this](const std::string &json)
+                                                                       { return jsonToSummaryData(json); });
+                if (parsed.is_err())
+                {
+                    LOG_F(WARNING, "Reconcile '%s' 失敗: %s", key.c_str(), parsed.unwrap_err().message.c_str());
+                    continue;
+                }
+                std::unique_lock<std::shared_mutex> lock(partition.mutex);
+                if (packed ? partition.table.find(*packed) != nullptr : partition.table.find(key) != nullptr)
+                    continue; // 對帳期間已由新封包建立
+                storeLocked(partition, key, parsed.unwrap());
+                ++loaded;
+            }
+            LOG_F(INFO, "RedisSummaryAdapter: reconcile resynced %zu restored entries, loaded %zu missing keys from Redis.",
+                  resynced, loaded);
+            return Result<size_t, ErrorResult>::Ok(loaded);
+        }
+
+        /**
+         * @brief 記錄快取檔已涵蓋到封包日誌 appliedLsn 為止的封包 (見 MappedSummaryFile::checkpoint())。
+         * @return 未啟用快取檔或寫回失敗時回傳 false
+         */
+        bool checkpoint(uint64_t appliedLsn) noexcept
+        {
+            return persistentCache_ && persistentCache_->checkpoint(appliedLsn);
+        }
+
+        /// 快取檔最近一次 checkpoint 的封包日誌 LSN；未啟用快取檔時為 0
+        uint64_t checkpointedLsn() const noexcept
+        {
+            return persistentCache_ ? persistentCache_->appliedLsn() : 0;
+        }
+
+        size_t cachePartitionCount() const noexcept
+        {
+            return partitions_.size();
+        }
+
+        /// Redis 共用連線池的使用統計；尚未連線時回傳空統計
+        RedisPoolStats redisPoolStats() const
+        {
+            return redisClient_ ? redisClient_->poolStats() : RedisPoolStats{};
+        }
+
     private:
+        /**
+         * @brief 快取分區：同一檔股票的所有區中心與總公司 (ALL) 資料都在同一分區，總公司彙總因此不跨分區。
+         */
+        struct CachePartition
+        {
+            SummaryTable table;                    // 本地緩存 (以 SummaryKey 為索引；查詢與快照讀取不需要鎖)
+            mutable std::shared_mutex mutex;       // 保護 table 的插入/移除與 aggregate
+            CompanySummaryAggregator aggregate{[](const std::string &area)
+                                               { return config::AreaBranchProvider::IsValidAreaCenter(area); }};
+        };
+
         std::unique_ptr<RedisPlusPlusClient<SummaryData, ErrorResult>> redisClient_; // Redis 客戶端
-        std::unordered_map<std::string, SummaryData> summaryCacheData_;              // 本地緩存
-        mutable std::shared_mutex cacheMutex_;                                       // <--- 新增: 用於保護 summaryCacheData_ 的讀寫鎖, mutable 允許在 const 方法中鎖定 (如果有的話)
+        std::vector<std::unique_ptr<CachePartition>> partitions_;                    // 依 SummaryKey::shard() 分區，建構後數量不變
         bool initRedisSearchIndex_ = false;
+        std::unique_ptr<MappedSummaryFile> persistentCache_;                         // attachPersistentCache() 後由各項目的寫者於發佈時寫入，之後不再變更
+        std::vector<SummaryKey> restoredKeys_;                                       // 由快取檔還原的 key，reconcile() 重新同步到 Redis
+        std::unique_ptr<const config::StockUniverse> universe_;                      // preallocate() 後啟用清單外股票過濾，之後不再變更
         TaskSubmitter task_submitter_;
+        TaskPoster task_poster_;
+        inline static const uint64_t ALL_AREA_BITS = *SummaryKey::areaBitsOf("ALL"); // 總公司 (ALL) 的區中心部分
+        // 批次重算用的欄式暫存，只在持有所有分區獨佔鎖時使用；跨呼叫保留容量
+        finance::domain::AvailabilityColumns availabilityColumns_;
+        std::vector<std::tuple<SummaryKey, SummaryData *, CachePartition *>> recalcEntries_; // entry id -> (key；無法壓縮時為空, 快取資料, 所屬分區)
+
+        CachePartition &partitionFor(SummaryKey key) noexcept
+        {
+            return *partitions_[key.shard(partitions_.size())];
+        }
+
+        const CachePartition &partitionFor(SummaryKey key) const noexcept
+        {
+            return *partitions_[key.shard(partitions_.size())];
+        }
+
+        // 無法壓縮的 key 放在第一個分區
+        CachePartition &partitionFor(const std::string &key) noexcept
+        {
+            auto packed = SummaryKey::parse(key);
+            return packed ? partitionFor(*packed) : *partitions_.front();
+        }
+
+        // 依分區順序取得所有分區的獨佔鎖 (其他路徑一次只持有一把，不會死結)
+        std::vector<std::unique_lock<std::shared_mutex>> lockAllPartitions()
+        {
+            std::vector<std::unique_lock<std::shared_mutex>> locks;
+            locks.reserve(partitions_.size());
+            for (auto &partition : partitions_)
+                locks.emplace_back(partition->mutex);
+            return locks;
+        }
+
+        size_t cachedEntryCountLocked() const noexcept
+        {
+            size_t count = 0;
+            for (const auto &partition : partitions_)
+                count += partition->table.size();
+            return count;
+        }
+
+        /**
+         * @brief 寫入快取並更新總公司彙總 (此方法假設已持有該分區的獨佔鎖)
+         */
+        void storeLocked(CachePartition &partition, const std::string &key, const SummaryData &data)
+        {
+            if (auto packed = SummaryKey::parse(key))
+            {
+                *partition.table.emplace(*packed).first = data;
+                publishEntry(partition, *packed, data);
+                partition.aggregate.apply(*packed, data);
+            }
+            else
+            {
+                *partition.table.emplace(key).first = data;
+            }
+        }
+
+        static bool cachedUnpacked(CachePartition &partition, const std::string &key)
+        {
+            std::shared_lock<std::shared_mutex> lock(partition.mutex);
+            return partition.table.find(key) != nullptr;
+        }
+
+        /**
+         * @brief handler 修改完區中心項目後的提交 (handler 執行緒是該項目唯一的寫者)：
+         *        在分區鎖內套用總公司彙總的差額並發佈快照，與 remove() 互斥，已被移除的項目不會重新出現在彙總中。
+         */
+        void commitEntry(SummaryKey key, const SummaryData &data)
+        {
+            auto &partition = partitionFor(key);
+            std::unique_lock<std::shared_mutex> lock(partition.mutex);
+            if (partition.table.find(key) == nullptr)
+                return;
+            partition.aggregate.apply(key, data);
+            publishEntry(partition, key, data);
+        }
 
         /**
-         * @brief 將 SummaryData 序列化為 JSON 字串。 (此方法不存取 summaryCacheData_，是純函數)
+         * @brief 發佈 key 的快照給無鎖讀者，啟用快取檔時同時寫入 (此方法假設已持有該分區的獨佔鎖，與 remove() 互斥)。
+         *        只能由該項目的寫者呼叫：區中心項目為 handler (commitEntry())，總公司項目為該股票所屬 lane 的 worker；
+         *        快取檔因此只依序寫入寫者手上的最新資料，不會被其他執行緒的舊副本覆蓋。key 已被移除時不發佈也不寫入檔案。
+         */
+        void publishEntry(CachePartition &partition, SummaryKey key, const SummaryData &data) noexcept
+        {
+            const auto snapshot = SummarySnapshot::from(key, data);
+            if (partition.table.publish(key, snapshot) && persistentCache_)
+                persistentCache_->store(key, snapshot);
+        }
+
+        /// key 所屬區中心 (或總公司) 的分公司列表
+        static finance::domain::BranchListRef branchListFor(SummaryKey key) noexcept
+        {
+            return key.areaBits() == ALL_AREA_BITS ? config::AreaBranchProvider::getAllBranchList()
+                                                   : config::AreaBranchProvider::getBranchListFromArea(key);
+        }
+
+        /**
+         * @brief recalculateAll() 的實作 (此方法假設已持有所有分區的獨佔鎖)。
+         *        所有分區的 entry 以一次欄式批次重算；原始輸入全為 0 的 entry (例如只由 Redis 載入可用數量者) 不納入，以免覆蓋載入的值。
+         */
+        size_t recalculateAllLocked()
+        {
+            recalcEntries_.clear();
+            for (auto &partition : partitions_)
+            {
+                CachePartition *owner = partition.get();
+                owner->table.forEach([this, owner](const SummaryKey *key, SummaryData &data)
+                                     {
+                                         if (finance::domain::AvailabilityColumns::hasRawInputs(data))
+                                             recalcEntries_.emplace_back(key ? *key : SummaryKey{}, &data, owner); });
+            }
+
+            const size_t count = recalcEntries_.size();
+            availabilityColumns_.resize(count);
+            for (size_t id = 0; id < count; ++id)
+                availabilityColumns_.load(id, *std::get<1>(recalcEntries_[id]));
+
+            availabilityColumns_.recalculateAll();
+
+            for (size_t id = 0; id < count; ++id)
+            {
+                auto [key, data, owner] = recalcEntries_[id];
+                availabilityColumns_.store(id, *data);
+                if (key.packed() != 0) // 無法壓縮的 key 不計入總公司彙總
+                {
+                    publishEntry(*owner, key, *data);
+                    owner->aggregate.apply(key, *data);
+                }
+            }
+            return count;
+        }
+
+        /**
+         * @brief 取得總公司 (ALL) 的 SummaryData：合計由所屬分區的 CompanySummaryAggregator 增量維護，只需一次查表。
+         *        啟用 summary_aggregate_cross_check 時另以各區中心快取全量重算並比對。
+         */
+        SummaryData buildCompanySummary(const std::string &stock_id)
+        {
+            SummaryData company_summary;
+            company_summary.stock_id = stock_id;
+            company_summary.area_center = "ALL";
+            company_summary.belong_branches = config::AreaBranchProvider::getAllBranchList();
+
+            auto stockKey = SummaryKey::make("ALL", stock_id);
+            if (!stockKey)
+            {
+                LOG_F(WARNING, "RedisSummaryAdapter: stock_id '%s' cannot be packed into a SummaryKey", stock_id.c_str());
+                return company_summary;
+            }
+
+            auto &partition = partitionFor(*stockKey);
+            if (config::ConnectionConfigProvider::summaryAggregateCrossCheck())
+            {
+                std::unique_lock<std::shared_mutex> lock(partition.mutex);
+                crossCheckCompanyTotals(partition, *stockKey, stock_id).copyTo(company_summary);
+            }
+            else
+            {
+                std::shared_lock<std::shared_mutex> read_lock(partition.mutex);
+                partition.aggregate.totals(*stockKey).copyTo(company_summary);
+            }
+            return company_summary;
+        }
+
+        /**
+         * @brief 以各區中心快取全量重算總公司合計並與增量結果比對 (此方法假設已持有該股票所屬分區的獨佔鎖)。
+         *        不一致時記錄錯誤並以重算結果覆蓋增量狀態。
+         *        區中心資料以已發佈的快照計算 (與彙總在同一把鎖內更新)，不讀取 handler 正在修改的快取項目。
+         */
+        static AvailableTotals crossCheckCompanyTotals(CachePartition &partition, SummaryKey stockKey, const std::string &stock_id)
+        {
+            std::vector<std::pair<SummaryKey, SummaryData>> published;
+            AvailableTotals recomputed;
+            for (const std::string &officeId : config::AreaBranchProvider::getBackofficeIds())
+            {
+                auto key = SummaryKey::make(officeId, stock_id);
+                SummarySnapshot snapshot;
+                if (!key || !partition.table.readPublished(*key, snapshot))
+                    continue;
+                published.emplace_back(*key, snapshot.toSummaryData());
+                recomputed += AvailableTotals::from(published.back().second);
+            }
+            std::vector<std::pair<SummaryKey, const SummaryData *>> areas;
+            areas.reserve(published.size());
+            for (const auto &[key, data] : published)
+                areas.emplace_back(key, &data);
+
+            AvailableTotals incremental = partition.aggregate.totals(stockKey);
+            if (incremental != recomputed)
+            {
+                LOG_F(ERROR, "Company summary mismatch for stock_id=%s: incremental margin_amount=%lld qty=%lld short_amount=%lld qty=%lld, "
+                             "recomputed margin_amount=%lld qty=%lld short_amount=%lld qty=%lld",
+                      stock_id.c_str(),
+                      static_cast<long long>(incremental.margin_available_amount), static_cast<long long>(incremental.margin_available_qty),
+                      static_cast<long long>(incremental.short_available_amount), static_cast<long long>(incremental.short_available_qty),
+                      static_cast<long long>(recomputed.margin_available_amount), static_cast<long long>(recomputed.margin_available_qty),
+                      static_cast<long long>(recomputed.short_available_amount), static_cast<long long>(recomputed.short_available_qty));
+                partition.aggregate.reset(stockKey, areas);
+            }
+            return recomputed;
+        }
+
+        /**
+         * @brief 將 SummaryData 序列化為 JSON 字串。 (此方法不存取快取，是純函數)
          */
         Result<std::string, ErrorResult> summaryDataToJson(const SummaryData *data) const // 標記為 const
         {
@@ -400,6 +933,11 @@ namespace finance::infrastructure::storage
                         ErrorResult{ErrorCode::UnexpectedError, "RedisSummaryAdapter:summaryDataToJson summary_data = nullptr"});
                 }
 
+                // 一般情況直接寫入本執行緒的緩衝區；含非 ASCII 字串時改用 nlohmann (輸出相同，保留 UTF-8 驗證)
+                std::string &buffer = SummaryJsonWriter::threadBuffer();
+                if (SummaryJsonWriter::write(*data, buffer))
+                    return Result<std::string, ErrorResult>::Ok(std::string(buffer));
+
                 nlohmann::json j;
                 j["stock_id"] = data->stock_id;
                 j["area_center"] = data->area_center;
@@ -411,7 +949,7 @@ namespace finance::infrastructure::storage
                 j["after_margin_available_qty"] = data->after_margin_available_qty;
                 j["after_short_available_amount"] = data->after_short_available_amount;
                 j["after_short_available_qty"] = data->after_short_available_qty;
-                j["belong_branches"] = data->belong_branches;
+                j["belong_branches"] = data->belong_branches.get();
                 return Result<std::string, ErrorResult>::Ok(j.dump());
             }
             catch (const std::exception &ex)
@@ -422,7 +960,7 @@ namespace finance::infrastructure::storage
         }
 
         /**
-         * @brief 將 JSON 反序列化為 SummaryData。 (此方法不存取 summaryCacheData_，是純函數)
+         * @brief 將 JSON 反序列化為 SummaryData。 (此方法不存取快取，是純函數)
          */
         Result<SummaryData, ErrorResult> jsonToSummaryData(const std::string &jsonStr) const // 標記為 const
         {
@@ -443,7 +981,7 @@ namespace finance::infrastructure::storage
                 data.after_margin_available_qty = j.at("after_margin_available_qty").get<int64_t>();
                 data.after_short_available_amount = j.at("after_short_available_amount").get<int64_t>();
                 data.after_short_available_qty = j.at("after_short_available_qty").get<int64_t>();
-                data.belong_branches = j.at("belong_branches").get<std::vector<std::string>>();
+                data.belong_branches = config::AreaBranchProvider::internBranches(j.at("belong_branches").get<std::vector<std::string>>());
                 return Result<SummaryData, ErrorResult>::Ok(std::move(data));
             }
             catch (const std::exception &ex)
@@ -461,8 +999,14 @@ namespace finance::infrastructure::storage
          */
         Result<void, ErrorResult> loadAndCacheKeysData(const std::vector<std::string> &keys)
         {
-            std::unique_lock<std::shared_mutex> lock(cacheMutex_);
-            summaryCacheData_.clear(); // 寫操作
+            auto locks = lockAllPartitions();
+            for (auto &partition : partitions_)
+            {
+                partition->table.clear(); // 寫操作
+                partition->aggregate.clear();
+            }
+            if (persistentCache_)
+                persistentCache_->clear(); // 以 Redis 內容重建快取檔
             size_t loaded = 0;
             for (const auto &key : keys)
             {
@@ -482,11 +1026,12 @@ namespace finance::infrastructure::storage
                     continue;
                 }
                 // 寫入快取
-                summaryCacheData_[key] = parseRes.unwrap(); // 寫操作
+                storeLocked(partitionFor(key), key, parseRes.unwrap()); // 寫操作
                 loaded++;
             }
+            // Redis 只存可用數量，載入的 entry 沒有原始輸入，不需要 (也無法) 重算
             LOG_F(INFO, "已從 Redis 載入 %zu 筆 summary 資料。", loaded);
-            LOG_F(INFO, "Summary Cache Data 資料 : %zu 筆 。", summaryCacheData_.size());
+            LOG_F(INFO, "Summary Cache Data 資料 : %zu 筆 (%zu 個分區)。", cachedEntryCountLocked(), partitions_.size());
             return Result<void, ErrorResult>::Ok();
         }
     };
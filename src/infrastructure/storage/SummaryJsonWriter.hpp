@@ -0,0 +1,177 @@
+#pragma once
+
+#include "domain/FinanceDataStructure.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace finance::infrastructure::storage
+{
+
+    /**
+     * SummaryData 專用的 JSON 序列化：依固定 schema 直接寫入呼叫端的緩衝區，不建立 nlohmann::json DOM。
+     * 輸出與 nlohmann::json::dump() 逐字節相同：key 依字母排序 (nlohmann 預設以 std::map 保存物件)、
+     * 無空白、字串跳脫規則一致 (\" \\ \b \f \n \r \t，其他控制字元為 \u00xx)。
+     * 字串含非 ASCII 字節時 write() 回傳 false，由呼叫端改用 nlohmann (保留其 UTF-8 驗證與錯誤行為)。
+     */
+    class SummaryJsonWriter
+    {
+    public:
+        /**
+         * 將 data 序列化到 out (先清空，保留容量)。
+         * @return false 表示字串欄位含非 ASCII 字節，out 內容無效
+         */
+        static bool write(const domain::SummaryData &data, std::string &out)
+        {
+            out.clear();
+            out.push_back('{');
+            appendIntField(out, "\"after_margin_available_amount\":", data.after_margin_available_amount);
+            appendIntField(out, ",\"after_margin_available_qty\":", data.after_margin_available_qty);
+            appendIntField(out, ",\"after_short_available_amount\":", data.after_short_available_amount);
+            appendIntField(out, ",\"after_short_available_qty\":", data.after_short_available_qty);
+            appendLiteral(out, ",\"area_center\":");
+            if (!appendString(out, data.area_center))
+                return false;
+            appendLiteral(out, ",\"belong_branches\":[");
+            for (size_t i = 0; i < data.belong_branches.size(); ++i)
+            {
+                if (i > 0)
+                    out.push_back(',');
+                if (!appendString(out, data.belong_branches[i]))
+                    return false;
+            }
+            out.push_back(']');
+            appendIntField(out, ",\"margin_available_amount\":", data.margin_available_amount);
+            appendIntField(out, ",\"margin_available_qty\":", data.margin_available_qty);
+            appendIntField(out, ",\"short_available_amount\":", data.short_available_amount);
+            appendIntField(out, ",\"short_available_qty\":", data.short_available_qty);
+            appendLiteral(out, ",\"stock_id\":");
+            if (!appendString(out, data.stock_id))
+                return false;
+            out.push_back('}');
+            return true;
+        }
+
+        /// 每個執行緒重複使用的輸出緩衝區，容量成長後不再配置記憶體
+        static std::string &threadBuffer()
+        {
+            thread_local std::string buffer;
+            return buffer;
+        }
+
+        /**
+         * 將整數轉為十進位文字寫入 buf (至少 20 字節)，回傳長度。
+         * 每次處理兩位數 (查表)，INT64_MIN 以無號數計算避免溢位。
+         */
+        static size_t formatInt(int64_t value, char *buf) noexcept
+        {
+            uint64_t abs = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+            char tmp[20];
+            char *end = tmp + sizeof(tmp);
+            char *p = end;
+            while (abs >= 100)
+            {
+                unsigned idx = static_cast<unsigned>(abs % 100) * 2;
+                abs /= 100;
+                *--p = DIGIT_PAIRS[idx + 1];
+                *--p = DIGIT_PAIRS[idx];
+            }
+            if (abs >= 10)
+            {
+                unsigned idx = static_cast<unsigned>(abs) * 2;
+                *--p = DIGIT_PAIRS[idx + 1];
+                *--p = DIGIT_PAIRS[idx];
+            }
+            else
+            {
+                *--p = static_cast<char>('0' + abs);
+            }
+
+            size_t len = 0;
+            if (value < 0)
+                buf[len++] = '-';
+            std::memcpy(buf + len, p, static_cast<size_t>(end - p));
+            return len + static_cast<size_t>(end - p);
+        }
+
+    private:
+        static constexpr char DIGIT_PAIRS[] =
+            "00010203040506070809"
+            "10111213141516171819"
+            "20212223242526272829"
+            "30313233343536373839"
+            "40414243444546474849"
+            "50515253545556575859"
+            "60616263646566676869"
+            "70717273747576777879"
+            "80818283848586878889"
+            "90919293949596979899";
+
+        template <size_t N>
+        static void appendLiteral(std::string &out, const char (&literal)[N])
+        {
+            out.append(literal, N - 1);
+        }
+
+        template <size_t N>
+        static void appendIntField(std::string &out, const char (&key)[N], int64_t value)
+        {
+            char buf[24];
+            appendLiteral(out, key);
+            out.append(buf, formatInt(value, buf));
+        }
+
+        // 以 nlohmann 的規則跳脫；遇到非 ASCII 字節回傳 false
+        static bool appendString(std::string &out, const std::string &s)
+        {
+            static constexpr char HEX[] = "0123456789abcdef";
+            out.push_back('"');
+            size_t runStart = 0;
+            for (size_t i = 0; i < s.size(); ++i)
+            {
+                unsigned char c = static_cast<unsigned char>(s[i]);
+                if (c >= 0x20 && c != '"' && c != '\\' && c < 0x80)
+                    continue;
+                if (c >= 0x80)
+                    return false;
+
+                out.append(s, runStart, i - runStart);
+                runStart = i + 1;
+                switch (c)
+                {
+                case '"':
+                    out.append("\\\"", 2);
+                    break;
+                case '\\':
+                    out.append("\\\\", 2);
+                    break;
+                case '\b':
+                    out.append("\\b", 2);
+                    break;
+                case '\f':
+                    out.append("\\f", 2);
+                    break;
+                case '\n':
+                    out.append("\\n", 2);
+                    break;
+                case '\r':
+                    out.append("\\r", 2);
+                    break;
+                case '\t':
+                    out.append("\\t", 2);
+                    break;
+                default:
+                {
+                    char esc[6] = {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0x0F]};
+                    out.append(esc, sizeof(esc));
+                    break;
+                }
+                }
+            }
+            out.append(s, runStart, s.size() - runStart);
+            out.push_back('"');
+            return true;
+        }
+    };
+
+} // namespace finance::infrastructure::storage
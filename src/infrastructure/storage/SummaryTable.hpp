@@ -0,0 +1,405 @@
+#pragma once
+
+#include "domain/FinanceDataStructure.hpp"
+#include "domain/SummaryKey.hpp"
+#include "domain/SummarySnapshot.hpp"
+#include "utils/Seqlock.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace finance::infrastructure::storage
+{
+
+    /**
+     * SummaryData 快取：以 SummaryKey 的 64 位元整數為鍵的開放定址 (線性探測) 索引，
+     * 資料本身存放在分塊配置的 slab 中，索引擴容時不搬移資料，getData() 取得的指標在項目被移除前一直有效。
+     * 無法壓縮成 SummaryKey 的字串 key (非 summary:AREA:STOCK 格式) 改存於另一個以字串為鍵的小表，共用同一個 slab。
+     *
+     * 寫入 (emplace / erase / clear) 由呼叫端 (RedisSummaryAdapter 各快取分區的鎖) 保護，同一時間只有一個寫者；
+     * 以 SummaryKey 查詢 (find / publish / readPublished) 不需要鎖，可與寫者並行：
+     * - 索引以 RCU 方式發佈：擴容時建立新陣列再以原子指標切換，舊陣列保留到表格解構，讀者不會讀到已釋放的記憶體；
+     * - slab 的分塊目錄大小固定，分塊位址不變；
+     * - 每筆資料另有一份 seqlock 保護的 SummarySnapshot (publish() 寫入)，讀者以 readPublished() 取得一致快照；
+     *   每個 key 只由寫入該項目的執行緒發佈，快照不會被較舊的資料覆蓋；
+     * - 移除的 slab 位置與舊索引陣列相同，保留到表格解構 (或沒有讀者時的 clear()) 才重複使用，
+     *   讀者無鎖取得的指標在移除後仍指向原項目，不會變成別的 key。
+     */
+    class SummaryTable
+    {
+    public:
+        using Value = domain::SummaryData;
+        using Snapshot = domain::SummarySnapshot;
+
+        /// 可容納的項目上限 (分塊目錄大小固定，讓讀者不需要鎖)；移除的位置不重複使用，clear() 之間插入的總數不可超過此值
+        static constexpr size_t MAX_ENTRIES = size_t{1} << 22;
+
+        SummaryTable()
+            : directory_(std::make_unique<std::atomic<Slot *>[]>(MAX_CHUNKS))
+        {
+            for (size_t i = 0; i < MAX_CHUNKS; ++i)
+                directory_[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        SummaryTable(const SummaryTable &) = delete;
+        SummaryTable &operator=(const SummaryTable &) = delete;
+
+        /// 查詢；不存在時回傳 nullptr (不需要鎖)
+        Value *find(domain::SummaryKey key) noexcept
+        {
+            uint32_t s = findSlot(key.packed());
+            return s == NO_SLOT ? nullptr : &slot(s).value;
+        }
+
+        const Value *find(domain::SummaryKey key) const noexcept
+        {
+            return const_cast<SummaryTable *>(this)->find(key);
+        }
+
+        Value *find(const std::string &key)
+        {
+            if (auto packed = domain::SummaryKey::parse(key))
+                return find(*packed);
+            auto it = overflow_.find(key);
+            return it == overflow_.end() ? nullptr : &slot(it->second).value;
+        }
+
+        /// 查詢，不存在時插入預設值；second 為 true 表示新插入
+        std::pair<Value *, bool> emplace(domain::SummaryKey key)
+        {
+            const uint64_t packed = key.packed();
+            size_t idx = findIndex(packed);
+            if (idx != NPOS)
+                return {&slot(current()->entries[idx].slot.load(std::memory_order_relaxed)).value, false};
+
+            reserveForInsert();
+            uint32_t s = allocateSlot();
+            IndexArray &index = *current();
+            for (size_t i = homeOf(packed, index.mask);; i = (i + 1) & index.mask)
+            {
+                uint64_t k = index.entries[i].key.load(std::memory_order_relaxed);
+                if (k == EMPTY || k == TOMBSTONE)
+                {
+                    if (k == TOMBSTONE)
+                        --tombstones_;
+                    // 先寫 slot 再以 release 發佈 key，讀者看到 key 時 slot 一定已就緒
+                    index.entries[i].slot.store(s, std::memory_order_relaxed);
+                    index.entries[i].key.store(packed, std::memory_order_release);
+                    ++packedCount_;
+                    return {&slot(s).value, true};
+                }
+            }
+        }
+
+        std::pair<Value *, bool> emplace(const std::string &key)
+        {
+            if (auto packed = domain::SummaryKey::parse(key))
+                return emplace(*packed);
+            auto it = overflow_.find(key);
+            if (it != overflow_.end())
+                return {&slot(it->second).value, false};
+            uint32_t s = allocateSlot();
+            overflow_.emplace(key, s);
+            return {&slot(s).value, true};
+        }
+
+        /// 移除；slab 位置保留不再使用 (retireSlot())，仍持有指標的讀者不受影響
+        bool erase(domain::SummaryKey key)
+        {
+            size_t idx = findIndex(key.packed());
+            if (idx == NPOS)
+                return false;
+            auto &entry = current()->entries[idx];
+            entry.key.store(TOMBSTONE, std::memory_order_release);
+            retireSlot();
+            --packedCount_;
+            ++tombstones_;
+            return true;
+        }
+
+        bool erase(const std::string &key)
+        {
+            if (auto packed = domain::SummaryKey::parse(key))
+                return erase(*packed);
+            auto it = overflow_.find(key);
+            if (it == overflow_.end())
+                return false;
+            retireSlot();
+            overflow_.erase(it);
+            return true;
+        }
+
+        /**
+         * 預先配置 entries 筆的空間：slab 以一塊連續記憶體補足，索引擴充到插入 entries 筆都不需要重建的大小。
+         * 啟動時呼叫，交易時段插入已預留的項目不會配置記憶體或重建索引。
+         */
+        void reserve(size_t entries)
+        {
+            if (entries > MAX_ENTRIES)
+                throw std::length_error("SummaryTable: reserve() exceeds MAX_ENTRIES");
+            const size_t chunks = (entries + CHUNK_SIZE - 1) / CHUNK_SIZE;
+            if (chunks > chunkCount_)
+            {
+                auto block = std::make_unique<Slot[]>((chunks - chunkCount_) * CHUNK_SIZE);
+                for (size_t c = chunkCount_; c < chunks; ++c)
+                    directory_[c].store(block.get() + (c - chunkCount_) * CHUNK_SIZE, std::memory_order_release);
+                chunkCount_ = chunks;
+                chunks_.push_back(std::move(block));
+            }
+
+            const IndexArray *index = current();
+            size_t capacity = index ? index->mask + 1 : MIN_CAPACITY;
+            while (entries * 2 > capacity)
+                capacity <<= 1;
+            if (index == nullptr || capacity > index->mask + 1)
+                rehash(capacity);
+        }
+
+        /// 索引目前的容量 (位置數)
+        size_t indexCapacity() const noexcept
+        {
+            const IndexArray *index = current();
+            return index ? index->mask + 1 : 0;
+        }
+
+        /// 清空所有項目 (保留已配置的 slab 與索引容量)；slab 位置全部重複使用，呼叫時不可有讀者持有項目指標
+        void clear()
+        {
+            if (IndexArray *index = current())
+            {
+                for (size_t i = 0; i <= index->mask; ++i)
+                    index->entries[i].key.store(EMPTY, std::memory_order_release);
+            }
+            packedCount_ = 0;
+            tombstones_ = 0;
+            overflow_.clear();
+            usedSlots_ = 0;
+            retiredSlots_ = 0;
+        }
+
+        size_t size() const noexcept
+        {
+            return packedCount_ + overflow_.size();
+        }
+
+        /// 已移除、等待 clear() 才重複使用的位置數
+        size_t retiredSlots() const noexcept
+        {
+            return retiredSlots_;
+        }
+
+        /**
+         * 走訪所有項目，對每筆呼叫 fn(const SummaryKey *key, Value &data)；
+         * 無法壓縮的字串 key 項目 key 為 nullptr。走訪期間不可插入或移除。
+         */
+        template <typename Fn>
+        void forEach(Fn &&fn)
+        {
+            if (IndexArray *index = current())
+            {
+                for (size_t i = 0; i <= index->mask; ++i)
+                {
+                    uint64_t k = index->entries[i].key.load(std::memory_order_relaxed);
+                    if (k == EMPTY || k == TOMBSTONE)
+                        continue;
+                    const auto key = domain::SummaryKey::fromPacked(k);
+                    fn(&key, slot(index->entries[i].slot.load(std::memory_order_relaxed)).value);
+                }
+            }
+            for (const auto &[key, s] : overflow_)
+                fn(static_cast<const domain::SummaryKey *>(nullptr), slot(s).value);
+        }
+
+        /**
+         * 發佈 key 目前的資料給無鎖讀者 (資料修改完成後，由寫入該項目的執行緒呼叫)。不需要鎖。
+         * @return key 不存在時回傳 false
+         */
+        bool publish(domain::SummaryKey key, const Value &data) noexcept
+        {
+            return publish(key, Snapshot::from(key, data));
+        }
+
+        bool publish(domain::SummaryKey key, const Snapshot &snapshot) noexcept
+        {
+            uint32_t s = findSlot(key.packed());
+            if (s == NO_SLOT)
+                return false;
+            slot(s).published.store(snapshot);
+            return true;
+        }
+
+        /**
+         * 無鎖讀取 key 最近一次發佈的快照，不會阻擋寫者。
+         * @return key 不存在或尚未發佈時回傳 false
+         */
+        bool readPublished(domain::SummaryKey key, Snapshot &out) const noexcept
+        {
+            uint32_t s = findSlot(key.packed());
+            if (s == NO_SLOT)
+                return false;
+            out = slot(s).published.load();
+            return out.key == key.packed();
+        }
+
+    private:
+        struct Entry
+        {
+            std::atomic<uint64_t> key{0};  // SummaryKey::packed()；EMPTY / TOMBSTONE 為保留值
+            std::atomic<uint32_t> slot{0}; // slab 位置
+        };
+
+        struct IndexArray
+        {
+            explicit IndexArray(size_t capacity)
+                : mask(capacity - 1), entries(std::make_unique<Entry[]>(capacity)) {}
+
+            size_t mask;
+            std::unique_ptr<Entry[]> entries;
+        };
+
+        struct Slot
+        {
+            Value value;
+            utils::Seqlock<Snapshot> published;
+        };
+
+        static constexpr uint64_t EMPTY = 0;       // 合法的 SummaryKey 不為 0
+        static constexpr uint64_t TOMBSTONE = ~uint64_t{0}; // 合法的 SummaryKey bit 63 為 0
+        static constexpr size_t NPOS = static_cast<size_t>(-1);
+        static constexpr uint32_t NO_SLOT = ~uint32_t{0};
+        static constexpr size_t CHUNK_SHIFT = 8;  // 每塊 256 筆
+        static constexpr size_t CHUNK_SIZE = size_t{1} << CHUNK_SHIFT;
+        static constexpr size_t MAX_CHUNKS = MAX_ENTRIES / CHUNK_SIZE;
+        static constexpr size_t MIN_CAPACITY = 64;
+
+        static size_t homeOf(uint64_t packed, size_t mask) noexcept
+        {
+            // splitmix64 的混合步驟，讓相近的股票代號分散到不同位置
+            uint64_t h = packed;
+            h ^= h >> 30;
+            h *= 0xbf58476d1ce4e5b9ULL;
+            h ^= h >> 27;
+            h *= 0x94d049bb133111ebULL;
+            h ^= h >> 31;
+            return static_cast<size_t>(h) & mask;
+        }
+
+        IndexArray *current() const noexcept
+        {
+            return index_.load(std::memory_order_acquire);
+        }
+
+        // 讀者路徑：可與寫者並行
+        uint32_t findSlot(uint64_t packed) const noexcept
+        {
+            const IndexArray *index = current();
+            if (index == nullptr)
+                return NO_SLOT;
+            for (size_t i = homeOf(packed, index->mask);; i = (i + 1) & index->mask)
+            {
+                uint64_t k = index->entries[i].key.load(std::memory_order_acquire);
+                if (k == packed)
+                    return index->entries[i].slot.load(std::memory_order_relaxed);
+                if (k == EMPTY)
+                    return NO_SLOT;
+            }
+        }
+
+        // 寫者路徑：回傳目前索引陣列中的位置
+        size_t findIndex(uint64_t packed) const noexcept
+        {
+            const IndexArray *index = current();
+            if (index == nullptr)
+                return NPOS;
+            for (size_t i = homeOf(packed, index->mask);; i = (i + 1) & index->mask)
+            {
+                uint64_t k = index->entries[i].key.load(std::memory_order_relaxed);
+                if (k == packed)
+                    return i;
+                if (k == EMPTY)
+                    return NPOS;
+            }
+        }
+
+        // 插入前確保 (項目 + tombstone) 不超過容量的 3/4
+        void reserveForInsert()
+        {
+            const IndexArray *index = current();
+            size_t capacity = index ? index->mask + 1 : 0;
+            if (capacity != 0 && (packedCount_ + tombstones_ + 1) * 4 <= capacity * 3)
+                return;
+            size_t newCapacity = capacity == 0 ? MIN_CAPACITY : capacity;
+            while ((packedCount_ + 1) * 2 > newCapacity)
+                newCapacity <<= 1;
+            rehash(newCapacity);
+        }
+
+        // 建立新的索引陣列後才切換，舊陣列保留給仍在讀取的讀者
+        void rehash(size_t capacity)
+        {
+            auto fresh = std::make_unique<IndexArray>(capacity);
+            if (const IndexArray *old = current())
+            {
+                for (size_t i = 0; i <= old->mask; ++i)
+                {
+                    uint64_t k = old->entries[i].key.load(std::memory_order_relaxed);
+                    if (k == EMPTY || k == TOMBSTONE)
+                        continue;
+                    size_t j = homeOf(k, fresh->mask);
+                    while (fresh->entries[j].key.load(std::memory_order_relaxed) != EMPTY)
+                        j = (j + 1) & fresh->mask;
+                    fresh->entries[j].slot.store(old->entries[i].slot.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    fresh->entries[j].key.store(k, std::memory_order_relaxed);
+                }
+            }
+            tombstones_ = 0;
+            index_.store(fresh.get(), std::memory_order_release);
+            indexArrays_.push_back(std::move(fresh));
+        }
+
+        Slot &slot(uint32_t s) const noexcept
+        {
+            return directory_[s >> CHUNK_SHIFT].load(std::memory_order_acquire)[s & (CHUNK_SIZE - 1)];
+        }
+
+        uint32_t allocateSlot()
+        {
+            if (usedSlots_ >= MAX_ENTRIES)
+                throw std::length_error("SummaryTable: more than MAX_ENTRIES entries");
+            auto s = static_cast<uint32_t>(usedSlots_++);
+            if ((s >> CHUNK_SHIFT) >= chunkCount_)
+            {
+                chunks_.push_back(std::make_unique<Slot[]>(CHUNK_SIZE));
+                directory_[chunkCount_++].store(chunks_.back().get(), std::memory_order_release);
+            }
+            // clear() 之後重複使用的位置需回到預設值
+            slot(s).value = Value{};
+            slot(s).published.store(Snapshot{});
+            return s;
+        }
+
+        // 移除的位置不清除也不重複使用：讀者可能仍持有指標 (與舊索引陣列相同的寬限期，到解構或 clear() 為止)
+        void retireSlot() noexcept
+        {
+            ++retiredSlots_;
+        }
+
+        std::atomic<IndexArray *> index_{nullptr};               // 目前的索引陣列 (讀者以 acquire 讀取)
+        std::vector<std::unique_ptr<IndexArray>> indexArrays_;   // 擁有目前與所有舊的索引陣列，表格解構時才釋放
+        size_t packedCount_ = 0;
+        size_t tombstones_ = 0;
+        std::unordered_map<std::string, uint32_t> overflow_;     // 無法壓縮的 key
+        std::unique_ptr<std::atomic<Slot *>[]> directory_;       // 分塊目錄：大小固定，讀者不需要鎖
+        std::vector<std::unique_ptr<Slot[]>> chunks_;            // slab：位置固定，不隨擴容搬移；reserve() 配置的一塊可涵蓋多個分塊
+        size_t chunkCount_ = 0;                                  // 目錄中已配置的分塊數
+        size_t usedSlots_ = 0;     // 已分配的位置數 (含已移除者)
+        size_t retiredSlots_ = 0;
+    };
+
+} // namespace finance::infrastructure::storage
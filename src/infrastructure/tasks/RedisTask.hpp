@@ -3,13 +3,13 @@
 #include "domain/FinanceDataStructure.hpp"
 #include "domain/Result.hpp"
 #include "domain/IFinanceRepository.hpp"
+#include "domain/SummaryKey.hpp"
 #include <string>
 #include <optional>
 #include <functional>
 #include <future>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
+#include <memory>
+#include <vector>
 
 namespace finance::infrastructure::tasks
 {
@@ -31,6 +31,7 @@ namespace finance::infrastructure::tasks
     {
         RedisOperationType operation;
         std::string key;                                                  // Key for data location (e.g., "summary:AREA:STOCK" or stock_id)
+        domain::SummaryKey summary_key;                                   // 壓縮鍵 (SYNC 為該筆資料，UPDATE 為 ALL:STOCK)；packed() 為 0 表示只有字串 key
         std::optional<SummaryData> summary_data_payload;                  // Data for SYNC operations (copied by value to ensure lifetime)
         std::shared_ptr<std::promise<Result<void, ErrorResult>>> promise; // For async operation results
 
@@ -45,56 +46,69 @@ namespace finance::infrastructure::tasks
         RedisTask(RedisOperationType op, std::string k, SummaryData data,
                   std::shared_ptr<std::promise<Result<void, ErrorResult>>> p)
             : operation(op), key(std::move(k)), summary_data_payload(std::move(data)), promise(std::move(p)) {}
-    };
 
-    // Thread-safe task queue for Redis operations
-    class RedisTaskQueue
-    {
-    public:
-        void push(RedisTask task)
+        /// 以壓縮鍵建立 UPDATE 任務 (key 為總公司 ALL:STOCK)；字串 key 延後到 worker 執行時才產生
+        RedisTask(RedisOperationType op, domain::SummaryKey k)
+            : operation(op), summary_key(k), promise(nullptr) {}
+
+        /// 以壓縮鍵建立 SYNC 任務；字串 key 延後到 worker 執行時才產生
+        RedisTask(RedisOperationType op, domain::SummaryKey k, const SummaryData &data)
+            : operation(op), summary_key(k), summary_data_payload(data), promise(nullptr) {}
+
+        /// 此任務的壓縮鍵；只有字串 key 時由其推得 (SYNC 解析 "summary:AREA:STOCK"，UPDATE 視為 ALL:STOCK)，無法壓縮時為 std::nullopt
+        std::optional<domain::SummaryKey> packedKey() const noexcept
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            queue_.push(std::move(task));
-            cv_.notify_one();
+            if (summary_key.packed() != 0)
+                return summary_key;
+            return operation == RedisOperationType::UPDATE_COMPANY_SUMMARY
+                       ? domain::SummaryKey::make("ALL", key)
+                       : domain::SummaryKey::parse(key);
         }
 
-        bool try_pop(RedisTask &task)
+        /**
+         * 只有字串 key 時補上壓縮鍵，讓兩種建立方式的同一筆資料能合併與分派到同一通道。
+         * @return 是否有壓縮鍵
+         */
+        bool packKey() noexcept
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (queue_.empty())
-            {
-                return false;
-            }
-            task = std::move(queue_.front());
-            queue_.pop();
-            return true;
+            auto packed = packedKey();
+            if (packed)
+                summary_key = *packed;
+            return packed.has_value();
         }
 
-        void wait_and_pop(RedisTask &task)
+        /// 實際 I/O 用的字串 key (SYNC 為 "summary:AREA:STOCK"，UPDATE 為股票代號)；必要時由壓縮鍵產生
+        const std::string &resolveKey()
         {
-            std::unique_lock<std::mutex> lock(mutex_);
-            cv_.wait(lock, [this]
-                     { return !queue_.empty(); });
-            task = std::move(queue_.front());
-            queue_.pop();
+            if (key.empty() && summary_key.packed() != 0)
+                key = operation == RedisOperationType::UPDATE_COMPANY_SUMMARY ? summary_key.stock() : summary_key.redisKey();
+            return key;
         }
 
-        bool empty() const
+        /**
+         * 合併同 key 的較新任務 (write-behind)：改用較新的資料，並保留雙方的 promise，
+         * 執行一次後以同一個結果完成所有被合併的呼叫。
+         */
+        void mergeFrom(RedisTask &&newer)
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            return queue_.empty();
+            if (newer.summary_data_payload)
+                summary_data_payload = std::move(newer.summary_data_payload);
+            if (newer.promise)
+                merged_promises.push_back(std::move(newer.promise));
+            for (auto &p : newer.merged_promises)
+                merged_promises.push_back(std::move(p));
         }
 
-        size_t size() const
+        /// 以執行結果完成此任務及所有被合併任務的 promise
+        void set_result(const Result<void, ErrorResult> &result)
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            return queue_.size();
+            if (promise)
+                promise->set_value(result);
+            for (auto &p : merged_promises)
+                p->set_value(result);
         }
 
-    private:
-        std::queue<RedisTask> queue_;
-        mutable std::mutex mutex_;
-        std::condition_variable cv_;
+        std::vector<std::shared_ptr<std::promise<Result<void, ErrorResult>>>> merged_promises; // 被合併任務的 promise
     };
 
 } // namespace finance::infrastructure::tasks
\ No newline at end of file
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "infrastructure/tasks/RedisTask.hpp"
+#include "infrastructure/tasks/WriteBehindBuffer.hpp"
 #include "domain/IFinanceRepository.hpp"
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <vector>
 
 namespace finance::infrastructure::tasks
 {
@@ -17,8 +19,10 @@ namespace finance::infrastructure::tasks
     class RedisWorker
     {
     public:
-        explicit RedisWorker(std::shared_ptr<finance::domain::IFinanceRepository<finance::domain::SummaryData, finance::domain::ErrorResult>> repository)
-            : repository_(std::move(repository)), running_(false) {}
+        explicit RedisWorker(std::shared_ptr<finance::domain::IFinanceRepository<finance::domain::SummaryData, finance::domain::ErrorResult>> repository,
+                             WriteBehindBuffer::Options options = WriteBehindBuffer::Options{},
+                             size_t lane = 0)
+            : repository_(std::move(repository)), task_buffer_(options), lane_(lane), running_(false) {}
 
         ~RedisWorker()
         {
@@ -36,84 +40,116 @@ namespace finance::infrastructure::tasks
             worker_thread_ = std::thread(&RedisWorker::process_tasks, this);
         }
 
-        // Stop the worker thread
+        // Stop the worker thread (pending writes are flushed before it exits)
         void stop()
         {
             if (!running_.exchange(false))
             {
                 return;
             }
+            task_buffer_.close();
             if (worker_thread_.joinable())
             {
                 worker_thread_.join();
             }
         }
 
-        // Submit a task to the queue
+        // Submit a task; writes to the same key are coalesced until the next flush
         std::future<Result<void, ErrorResult>> submit_task(RedisTask task)
         {
             auto promise = std::make_shared<std::promise<Result<void, ErrorResult>>>();
             task.promise = promise;
-            task_queue_.push(std::move(task));
+            task_buffer_.push(std::move(task));
             return promise->get_future();
         }
 
+        // Submit a task without a result (fire-and-forget); avoids allocating a promise per packet
+        void post(RedisTask task)
+        {
+            task.promise = nullptr;
+            task_buffer_.push(std::move(task));
+        }
+
+        // 目前待寫的 (不重複) 筆數
+        size_t pending() const
+        {
+            return task_buffer_.size();
+        }
+
     private:
         void process_tasks()
         {
-            while (running_.load())
+            std::vector<RedisTask> batch;
+            while (task_buffer_.waitForBatch(batch))
             {
-                RedisTask task;
-                task_queue_.wait_and_pop(task);
-
-                if (!running_.load())
-                {
-                    break;
-                }
+                execute(batch);
+            }
+        }
 
-                try
+        // 整批交給 repository_->syncBatch() 一次送出，再依序完成每個任務的 promise
+        void execute(std::vector<RedisTask> &batch)
+        {
+            std::vector<std::pair<std::string, const SummaryData *>> syncs;
+            std::vector<std::string> updates;
+            std::vector<RedisTask *> syncTasks;
+            std::vector<RedisTask *> updateTasks;
+            for (auto &task : batch)
+            {
+                switch (task.operation)
                 {
-                    switch (task.operation)
+                case RedisOperationType::SYNC_SUMMARY_DATA:
+                    if (task.summary_data_payload)
                     {
-                    case RedisOperationType::SYNC_SUMMARY_DATA:
-                        if (task.summary_data_payload)
-                        {
-                            auto result = repository_->sync(task.key, &task.summary_data_payload.value());
-                            task.promise->set_value(result);
-                        }
-                        else
-                        {
-                            task.promise->set_value(Result<void, ErrorResult>::Err(ErrorResult{ErrorCode::UnexpectedError, "Missing summary data payload"}));
-                        }
-                        break;
-                    case RedisOperationType::UPDATE_COMPANY_SUMMARY:
-                        if (task.summary_data_payload)
-                        {
-                            auto result = repository_->update(task.key);
-                            task.promise->set_value(result);
-                        }
-                        else
-                        {
-                            task.promise->set_value(Result<void, ErrorResult>::Err(ErrorResult{ErrorCode::UnexpectedError, "Missing summary data payload"}));
-                        }
-                        break;
-
-                    default:
-                        task.promise->set_value(Result<void, ErrorResult>::Err(ErrorResult{ErrorCode::UnexpectedError, "Unknown operation type"}));
-                        break;
+                        syncs.emplace_back(task.resolveKey(), &task.summary_data_payload.value());
+                        syncTasks.push_back(&task);
                     }
+                    else
+                    {
+                        task.set_result(Result<void, ErrorResult>::Err(ErrorResult{ErrorCode::UnexpectedError, "Missing summary data payload"}));
+                    }
+                    break;
+                case RedisOperationType::UPDATE_COMPANY_SUMMARY:
+                    // 總公司資料由快取重新彙總，不需要 payload
+                    updates.push_back(task.resolveKey());
+                    updateTasks.push_back(&task);
+                    break;
+
+                default:
+                    task.set_result(Result<void, ErrorResult>::Err(ErrorResult{ErrorCode::UnexpectedError, "Unknown operation type"}));
+                    break;
                 }
-                catch (const std::exception &e)
-                {
-                    task.promise->set_value(Result<void, ErrorResult>::Err(ErrorResult{ErrorCode::UnexpectedError, std::string("Exception in Redis worker: ") + e.what()}));
-                }
             }
+            if (syncs.empty() && updates.empty())
+                return;
+
+            std::vector<Result<void, ErrorResult>> results;
+            try
+            {
+                results = repository_->syncBatch(syncs, updates, lane_);
+            }
+            catch (const std::exception &e)
+            {
+                results.assign(syncs.size() + updates.size(),
+                               Result<void, ErrorResult>::Err(ErrorResult{ErrorCode::UnexpectedError, std::string("Exception in Redis worker: ") + e.what()}));
+            }
+
+            size_t i = 0;
+            for (auto *task : syncTasks)
+                task->set_result(i < results.size() ? results[i++] : missingResult());
+            for (auto *task : updateTasks)
+                task->set_result(i < results.size() ? results[i++] : missingResult());
+        }
+
+        static Result<void, ErrorResult> missingResult()
+        {
+            return Result<void, ErrorResult>::Err(ErrorResult{ErrorCode::InternalError, "syncBatch returned fewer results than requested"});
         }
 
         std::shared_ptr<finance::domain::IFinanceRepository<finance::domain::SummaryData, finance::domain::ErrorResult>> repository_;
-        RedisTaskQueue task_queue_;
+        WriteBehindBuffer task_buffer_;
+        size_t lane_; // 寫入通道編號，repository 以此選用專屬連線
         std::thread worker_thread_;
         std::atomic<bool> running_;
     };
 
-} // namespace finance::infrastructure::tasks
\ No newline at end of file
+} // namespace finance::infrastructure::tasks
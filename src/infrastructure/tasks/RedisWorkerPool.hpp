@@ -0,0 +1,111 @@
+#pragma once
+
+#include "infrastructure/tasks/RedisWorker.hpp"
+#include "infrastructure/tasks/WriteBehindBuffer.hpp"
+#include "domain/IFinanceRepository.hpp"
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include <loguru.hpp>
+
+namespace finance::infrastructure::tasks
+{
+
+    /**
+     * 多個 RedisWorker 組成的寫入池，任務依股票代號雜湊分派到固定的 worker：
+     * 同一檔股票的 SYNC (summary:AREA:STOCK) 與 UPDATE_COMPANY_SUMMARY (STOCK) 永遠在同一條通道上依序執行，
+     * 總公司彙總因此一定看得到同通道先前寫入的區中心資料；不同股票則可平行寫入，
+     * 單一緩慢的回覆不會拖慢所有股票。
+     * 每個 worker 以自己的通道編號呼叫 repository 的 syncBatch()，使用專屬的 Redis 連線。
+     */
+    class RedisWorkerPool
+    {
+    public:
+        RedisWorkerPool(std::shared_ptr<finance::domain::IFinanceRepository<finance::domain::SummaryData, finance::domain::ErrorResult>> repository,
+                        size_t workerCount,
+                        WriteBehindBuffer::Options options = WriteBehindBuffer::Options{})
+        {
+            if (workerCount == 0)
+                workerCount = 1;
+            workers_.reserve(workerCount);
+            for (size_t lane = 0; lane < workerCount; ++lane)
+                workers_.push_back(std::make_unique<RedisWorker>(repository, options, lane));
+            LOG_F(INFO, "RedisWorkerPool created with %zu workers.", workerCount);
+        }
+
+        ~RedisWorkerPool()
+        {
+            stop();
+        }
+
+        void start()
+        {
+            for (auto &worker : workers_)
+                worker->start();
+        }
+
+        // 停止所有 worker (各自寫出剩餘資料後結束)
+        void stop()
+        {
+            for (auto &worker : workers_)
+                worker->stop();
+        }
+
+        std::future<Result<void, ErrorResult>> submit_task(RedisTask task)
+        {
+            size_t lane = laneFor(task);
+            return workers_[lane]->submit_task(std::move(task));
+        }
+
+        /// 不需要結果的任務 (handler 的熱路徑)，不配置 promise
+        void post(RedisTask task)
+        {
+            size_t lane = laneFor(task);
+            workers_[lane]->post(std::move(task));
+        }
+
+        /**
+         * 任務所屬的 worker 編號：可壓縮的 key 以 SummaryKey::shard() 分派 (與分片管線、快取分區一致)，不產生字串；
+         * 否則以 routingKey() 雜湊。
+         */
+        size_t laneFor(const RedisTask &task) const noexcept
+        {
+            if (auto packed = task.packedKey())
+                return packed->shard(workers_.size());
+            return std::hash<std::string_view>{}(routingKey(task)) % workers_.size();
+        }
+
+        /// 各 worker 目前待寫的 (不重複) 筆數
+        std::vector<size_t> queueDepths() const
+        {
+            std::vector<size_t> depths;
+            depths.reserve(workers_.size());
+            for (const auto &worker : workers_)
+                depths.push_back(worker->pending());
+            return depths;
+        }
+
+        size_t size() const noexcept
+        {
+            return workers_.size();
+        }
+
+        /**
+         * 分派用的鍵：UPDATE_COMPANY_SUMMARY 的 key 即為股票代號；
+         * SYNC 的 key 為 "summary:AREA:STOCK"，取最後一段的股票代號。
+         */
+        static std::string_view routingKey(const RedisTask &task) noexcept
+        {
+            std::string_view key = task.key;
+            if (task.operation == RedisOperationType::UPDATE_COMPANY_SUMMARY)
+                return key;
+            auto pos = key.rfind(':');
+            return pos == std::string_view::npos ? key : key.substr(pos + 1);
+        }
+
+    private:
+        std::vector<std::unique_ptr<RedisWorker>> workers_;
+    };
+
+} // namespace finance::infrastructure::tasks
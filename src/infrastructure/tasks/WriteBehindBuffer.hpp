@@ -0,0 +1,240 @@
+#pragma once
+
+#include "infrastructure/tasks/RedisTask.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace finance::infrastructure::tasks
+{
+
+    /**
+     * Redis 寫入的 write-behind 緩衝：同一個 (操作, key) 只保留最新的一筆待寫資料，
+     * 熱門股每秒數百次的更新在一個 flush 週期內只會寫入 Redis 一次。
+     * 可壓縮成 SummaryKey 的 key 以整數索引合併，穩定狀態下 push() 不配置記憶體。
+     *
+     * flush 條件 (任一成立即交出整批)：
+     * - 待寫筆數達到 maxBatchSize
+     * - 最舊的待寫資料已等待 flushInterval (資料延遲上限)
+     * - 已有 idleFlush 時間沒有新資料進來 (閒置時立即寫出)
+     * - 已呼叫 close()，交出剩餘資料後結束
+     */
+    class WriteBehindBuffer
+    {
+    public:
+        struct Options
+        {
+            std::chrono::milliseconds flushInterval{50};
+            size_t maxBatchSize = 512;
+            std::chrono::microseconds idleFlush{200};
+        };
+
+        WriteBehindBuffer() = default;
+        explicit WriteBehindBuffer(Options options) : options_(options) {}
+
+        /**
+         * 加入一筆待寫任務；同 (操作, key) 已有待寫任務時以新資料取代，並把 promise 併入該筆任務。
+         */
+        void push(RedisTask task)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (closed_)
+            {
+                lock.unlock();
+                task.set_result(Result<void, ErrorResult>::Err(
+                    ErrorResult{domain::ErrorCode::InternalError, "Write-behind buffer closed"}));
+                return;
+            }
+            auto now = std::chrono::steady_clock::now();
+            lastPush_ = now;
+
+            // 有壓縮鍵的任務以整數索引合併 (清空後保留容量，穩定狀態下不配置記憶體)
+            size_t existing = NOT_FOUND;
+            const bool packed = task.packKey();
+            if (packed)
+            {
+                existing = packedIndexFor(task.operation).find(task.summary_key.packed());
+            }
+            else
+            {
+                auto &index = indexFor(task.operation);
+                auto it = index.find(task.key);
+                if (it != index.end())
+                    existing = it->second;
+            }
+            if (existing != NOT_FOUND)
+            {
+                pending_[existing].mergeFrom(std::move(task));
+                ++coalesced_;
+                return;
+            }
+
+            if (pending_.empty())
+                oldestDirty_ = now;
+            if (packed)
+                packedIndexFor(task.operation).insert(task.summary_key.packed(), pending_.size());
+            else
+                indexFor(task.operation).emplace(task.key, pending_.size());
+            pending_.push_back(std::move(task));
+            if (pending_.size() == 1 || pending_.size() >= options_.maxBatchSize)
+                cv_.notify_one();
+        }
+
+        /**
+         * 等待直到符合 flush 條件，將整批待寫任務依首次加入的順序交給呼叫端。
+         * @return false 表示已 close() 且沒有剩餘資料
+         */
+        bool waitForBatch(std::vector<RedisTask> &batch)
+        {
+            batch.clear();
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true)
+            {
+                if (pending_.empty())
+                {
+                    if (closed_)
+                        return false;
+                    cv_.wait(lock, [this]
+                             { return !pending_.empty() || closed_; });
+                    continue;
+                }
+
+                auto now = std::chrono::steady_clock::now();
+                auto staleDeadline = oldestDirty_ + options_.flushInterval;
+                auto idleDeadline = lastPush_ + options_.idleFlush;
+                if (closed_ || pending_.size() >= options_.maxBatchSize ||
+                    now >= staleDeadline || now >= idleDeadline)
+                    break;
+
+                cv_.wait_until(lock, std::min(staleDeadline, idleDeadline));
+            }
+
+            batch.swap(pending_);
+            syncIndex_.clear();
+            updateIndex_.clear();
+            syncPackedIndex_.clear();
+            updatePackedIndex_.clear();
+            return true;
+        }
+
+        /// 停止接受等待：喚醒 waitForBatch()，剩餘資料會在最後一批交出
+        void close()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+            cv_.notify_all();
+        }
+
+        /// 目前待寫的 (不重複) 筆數
+        size_t size() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return pending_.size();
+        }
+
+        /// 累計被合併 (未產生 Redis 寫入) 的任務數
+        size_t coalescedCount() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return coalesced_;
+        }
+
+    private:
+        static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+
+        /// SummaryKey -> pending_ 索引的開放定址表；clear() 保留容量
+        class PackedIndex
+        {
+        public:
+            size_t find(uint64_t key) const noexcept
+            {
+                if (slots_.empty())
+                    return NOT_FOUND;
+                for (size_t i = home(key);; i = (i + 1) & mask_)
+                {
+                    if (slots_[i].key == key)
+                        return slots_[i].value;
+                    if (slots_[i].key == 0)
+                        return NOT_FOUND;
+                }
+            }
+
+            void insert(uint64_t key, size_t value)
+            {
+                if ((count_ + 1) * 2 > slots_.size())
+                    grow();
+                size_t i = home(key);
+                while (slots_[i].key != 0)
+                    i = (i + 1) & mask_;
+                slots_[i] = Slot{key, value};
+                ++count_;
+            }
+
+            void clear() noexcept
+            {
+                if (count_ == 0)
+                    return;
+                for (auto &slot : slots_)
+                    slot.key = 0;
+                count_ = 0;
+            }
+
+        private:
+            struct Slot
+            {
+                uint64_t key; // 0 表示空 (合法的 SummaryKey 不為 0)
+                size_t value;
+            };
+
+            size_t home(uint64_t key) const noexcept
+            {
+                return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask_;
+            }
+
+            void grow()
+            {
+                std::vector<Slot> old;
+                old.swap(slots_);
+                slots_.assign(old.empty() ? 64 : old.size() * 2, Slot{0, 0});
+                mask_ = slots_.size() - 1;
+                count_ = 0;
+                for (const auto &slot : old)
+                    if (slot.key != 0)
+                        insert(slot.key, slot.value);
+            }
+
+            std::vector<Slot> slots_;
+            size_t mask_ = 0;
+            size_t count_ = 0;
+        };
+
+        std::unordered_map<std::string, size_t> &indexFor(RedisOperationType op)
+        {
+            return op == RedisOperationType::UPDATE_COMPANY_SUMMARY ? updateIndex_ : syncIndex_;
+        }
+
+        PackedIndex &packedIndexFor(RedisOperationType op)
+        {
+            return op == RedisOperationType::UPDATE_COMPANY_SUMMARY ? updatePackedIndex_ : syncPackedIndex_;
+        }
+
+        Options options_;
+        std::vector<RedisTask> pending_;                      // 依首次加入順序排列
+        std::unordered_map<std::string, size_t> syncIndex_;   // key -> pending_ 索引
+        std::unordered_map<std::string, size_t> updateIndex_; // stock_id -> pending_ 索引
+        PackedIndex syncPackedIndex_;                         // SummaryKey -> pending_ 索引
+        PackedIndex updatePackedIndex_;                       // ALL:STOCK SummaryKey -> pending_ 索引
+        std::chrono::steady_clock::time_point oldestDirty_{};
+        std::chrono::steady_clock::time_point lastPush_{};
+        size_t coalesced_ = 0;
+        bool closed_ = false;
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+    };
+
+} // namespace finance::infrastructure::tasks
@@ -0,0 +1,314 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) && defined(__x86_64__)
+#include <emmintrin.h>
+#define FINANCE_BACKOFFICE_SIMD 1
+#endif
+
+// 由結構成員產生 BackOfficeDecoder::Field (名稱、位移、長度)
+#define BACKOFFICE_FIELD(STRUCT_TYPE, VAR_NAME)                              \
+    ::finance::utils::BackOfficeDecoder::Field                               \
+    {                                                                        \
+        #VAR_NAME, static_cast<uint16_t>(offsetof(STRUCT_TYPE, VAR_NAME)),   \
+            static_cast<uint8_t>(sizeof(STRUCT_TYPE::VAR_NAME))              \
+    }
+
+namespace finance::utils
+{
+#if defined(FINANCE_BACKOFFICE_SIMD)
+    namespace backoffice_detail
+    {
+        /// 5^k 在模 2^64 下的乘法反元素 (牛頓迭代，每次精確位數加倍)
+        constexpr uint64_t inversePow5(uint32_t k) noexcept
+        {
+            uint64_t pow5 = 1;
+            for (uint32_t i = 0; i < k; ++i)
+                pow5 *= 5;
+            uint64_t inv = pow5; // 奇數 x 滿足 x * x ≡ 1 (mod 8)
+            for (int i = 0; i < 5; ++i)
+                inv *= 2 - pow5 * inv;
+            return inv;
+        }
+
+        inline constexpr uint64_t INVERSE_POW5[17] = {
+            inversePow5(0), inversePow5(1), inversePow5(2), inversePow5(3), inversePow5(4), inversePow5(5),
+            inversePow5(6), inversePow5(7), inversePow5(8), inversePow5(9), inversePow5(10), inversePow5(11),
+            inversePow5(12), inversePow5(13), inversePow5(14), inversePow5(15), inversePow5(16)};
+        static_assert(inversePow5(16) * 152587890625ULL == 1, "5^16 的反元素錯誤");
+    } // namespace backoffice_detail
+#endif
+
+    /**
+     * 後台定長數字欄位 (zoned decimal / overpunch) 解碼器，規則與 FinanceUtils::backOfficeToInt() 相同：
+     * 忽略前導與尾部空白；最後一碼為 'J'~'R' / '}' 時代表負號與個位數 (1~9 / 0)，其後的字元不再檢查；
+     * 數字之後出現空白或其他非法字元為錯誤。
+     * 欄位長度不超過 16 時以 SSE2 一次分類整個欄位 (數字 / 空白 / 負號碼 三個 bitmask)，
+     * 用 bitmask 運算完成驗證 (全為數字、最多末碼為負號碼的常見欄位只需一次比較)，再以 madd 乘加鏈轉成整數，
+     * 不逐字元分支；超過 16 字節或沒有 SSE2 時退回逐字元版本。
+     * 不配置記憶體，錯誤以 Status 回報，由呼叫端決定是否組成 ErrorResult。
+     */
+    class BackOfficeDecoder
+    {
+    public:
+        static constexpr size_t MAX_SIMD_LENGTH = 16;
+
+        enum class Status : uint8_t
+        {
+            Ok,
+            Empty,       // nullptr 或長度 0
+            MiddleSpace, // 數字之後出現空白
+            InvalidChar, // 非數字、空白或負號碼的字元
+        };
+
+        /// 批次解碼用的欄位描述：在記錄中的位移與長度，name 用於錯誤訊息
+        struct Field
+        {
+            const char *name;
+            uint16_t offset;
+            uint8_t length;
+        };
+
+        /// 目前編譯使用的指令集，用於日誌
+        static constexpr const char *isaName() noexcept
+        {
+#if defined(FINANCE_BACKOFFICE_SIMD)
+            return "SSE2";
+#else
+            return "scalar";
+#endif
+        }
+
+        static constexpr const char *message(Status status) noexcept
+        {
+            switch (status)
+            {
+            case Status::Ok:
+                return "ok";
+            case Status::Empty:
+                return "empty input";
+            case Status::MiddleSpace:
+                return "space in the middle of the string";
+            case Status::InvalidChar:
+                return "invalid character";
+            }
+            return "unknown";
+        }
+
+        /// 解碼單一欄位；只讀取 [value, value + length)
+        static Status decode(const char *value, size_t length, int64_t &out) noexcept
+        {
+            if (value == nullptr || length == 0)
+                return Status::Empty;
+#if defined(FINANCE_BACKOFFICE_SIMD)
+            if (length <= MAX_SIMD_LENGTH)
+            {
+                return decodeVector(loadField(value, length), length, out);
+            }
+#endif
+            return decodeScalar(value, length, out);
+        }
+
+        /// 逐字元版本 (原 backOfficeToInt 的實作)；SIMD 無法使用或欄位超過 16 字節時使用
+        static Status decodeScalar(const char *value, size_t length, int64_t &out) noexcept
+        {
+            if (value == nullptr || length == 0)
+                return Status::Empty;
+
+            static constexpr char OFFSET = 'I'; // 'J' 對應 1
+            int64_t result = 0;
+            bool found_digit = false;
+
+            while (length > 0 && isSpace(value[length - 1]))
+                --length;
+
+            for (size_t i = 0; i < length; ++i)
+            {
+                char c = value[i];
+                if ('0' <= c && c <= '9')
+                {
+                    result = result * 10 + (c - '0');
+                    found_digit = true;
+                }
+                else if ('J' <= c && c <= 'R')
+                {
+                    out = -(result * 10 + (c - OFFSET));
+                    return Status::Ok;
+                }
+                else if (c == '}')
+                {
+                    out = -result * 10;
+                    return Status::Ok;
+                }
+                else if (isSpace(c))
+                {
+                    if (found_digit)
+                        return Status::MiddleSpace;
+                }
+                else
+                {
+                    return Status::InvalidChar;
+                }
+            }
+            out = result;
+            return Status::Ok;
+        }
+
+        /**
+         * 一次解碼一筆記錄中的多個欄位，結果依序寫入 out[0..count)。
+         * recordSize 為記錄可讀取的長度：欄位之後還有 16 字節可讀時直接從記錄載入，省去複製。
+         * @return 第一個解碼失敗的欄位索引 (status 為其錯誤)；全部成功時回傳 count
+         */
+        static size_t decodeBatch(const char *record, size_t recordSize, const Field *fields, size_t count,
+                                  int64_t *out, Status &status) noexcept
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Field &f = fields[i];
+#if defined(FINANCE_BACKOFFICE_SIMD)
+                if (f.length != 0 && f.length <= MAX_SIMD_LENGTH)
+                {
+                    // 欄位之後還有 16 字節可讀時直接載入 (之後的字節由 decodeVector 忽略)，否則只讀欄位本身
+                    const char *value = record + f.offset;
+                    __m128i v;
+                    if (f.offset + MAX_SIMD_LENGTH <= recordSize)
+                        v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(value));
+                    else
+                        v = loadField(value, f.length);
+                    status = decodeVector(v, f.length, out[i]);
+                }
+                else
+#endif
+                {
+                    (void)recordSize;
+                    status = decodeScalar(record + f.offset, f.length, out[i]);
+                }
+                if (status != Status::Ok)
+                    return i;
+            }
+            status = Status::Ok;
+            return count;
+        }
+
+    private:
+        static constexpr bool isSpace(char c) noexcept
+        {
+            // 與 std::isspace 在 "C" locale 下相同：' ', '\t', '\n', '\v', '\f', '\r'
+            return c == ' ' || ('\t' <= c && c <= '\r');
+        }
+
+#if defined(FINANCE_BACKOFFICE_SIMD)
+        /**
+         * 只讀取 [value, value + length) 組成向量 (length 為 1~16)：以頭尾兩次重疊的定長讀取取代變長 memcpy，
+         * 欄位之後的 lane 內容不定，由 decodeVector 忽略。
+         */
+        static __m128i loadField(const char *value, size_t length) noexcept
+        {
+            if (length >= 8)
+            {
+                uint64_t lo, hi;
+                std::memcpy(&lo, value, 8);
+                std::memcpy(&hi, value + length - 8, 8);
+                const size_t shift = (MAX_SIMD_LENGTH - length) * 8; // 把最後 length - 8 個字節移到 lane 8 起
+                hi = shift >= 64 ? 0 : hi >> shift;
+                return _mm_set_epi64x(static_cast<int64_t>(hi), static_cast<int64_t>(lo));
+            }
+            uint64_t lo;
+            if (length >= 4)
+            {
+                uint32_t head, tail;
+                std::memcpy(&head, value, 4);
+                std::memcpy(&tail, value + length - 4, 4);
+                lo = head | (static_cast<uint64_t>(tail) << ((length - 4) * 8));
+            }
+            else
+            {
+                // 1~3 字節：第 0、length / 2、length - 1 個字節涵蓋全部
+                lo = static_cast<uint64_t>(static_cast<unsigned char>(value[0])) |
+                     static_cast<uint64_t>(static_cast<unsigned char>(value[length / 2])) << (length / 2 * 8) |
+                     static_cast<uint64_t>(static_cast<unsigned char>(value[length - 1])) << ((length - 1) * 8);
+            }
+            return _mm_cvtsi64_si128(static_cast<int64_t>(lo));
+        }
+
+        static __m128i laneIndex() noexcept
+        {
+            return _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        }
+
+        static __m128i inRange(__m128i v, char lo, char hi) noexcept
+        {
+            // 有號比較：0x80 以上的字元為負數，不會落在任何 ASCII 範圍內
+            return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                                 _mm_cmplt_epi8(v, _mm_set1_epi8(static_cast<char>(hi + 1))));
+        }
+
+        /// 只看 v 的 lane [0, length)；強制內聯，讓批次迴圈中的常數向量只載入一次
+        __attribute__((always_inline)) static Status decodeVector(__m128i v, size_t length, int64_t &out) noexcept
+        {
+            const __m128i digit = inRange(v, '0', '9');
+            const __m128i punchDigit = inRange(v, 'J', 'R');
+            const __m128i punch = _mm_or_si128(punchDigit, _mm_cmpeq_epi8(v, _mm_set1_epi8('}')));
+            const __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), inRange(v, '\t', '\r'));
+
+            const uint32_t inField = (1u << length) - 1;
+            const uint32_t digits = static_cast<uint32_t>(_mm_movemask_epi8(digit)) & inField;
+            const uint32_t spaces = (static_cast<uint32_t>(_mm_movemask_epi8(space)) | ~inField) & 0xFFFF; // 欄位之外視為空白
+            const uint32_t punches = static_cast<uint32_t>(_mm_movemask_epi8(punch)) & inField;
+
+            // 常見情況：整個欄位都是數字，最多最後一碼是負號碼，不需要其他檢查
+            uint32_t end = static_cast<uint32_t>(length);
+            uint32_t hasPunch = punches != 0;
+            if ((digits | punches) != inField || (punches & (inField >> 1)) != 0)
+            {
+                // end：有負號碼時為第一個負號碼之後，否則為去除尾部空白後的長度 (全空白時為 0)；
+                // prefix 為 end 之前、負號碼以外的部分
+                const uint32_t punchAt = static_cast<uint32_t>(__builtin_ctz(punches | (1u << MAX_SIMD_LENGTH)));
+                const uint32_t nonSpace = ~spaces & inField;
+                const uint32_t trimmedEnd = 31 - static_cast<uint32_t>(__builtin_clz((nonSpace << 1) | 1));
+                end = hasPunch ? punchAt + 1 : trimmedEnd;
+                const uint32_t prefix = (1u << (hasPunch ? punchAt : trimmedEnd)) - 1;
+
+                // 與逐字元版本相同，回報最左邊的錯誤
+                const uint32_t invalid = prefix & ~(digits | spaces);
+                const uint32_t prefixDigits = digits & prefix;
+                const uint32_t middleSpace = prefixDigits != 0 ? (spaces & prefix & ~((prefixDigits & (0u - prefixDigits)) - 1)) : 0;
+                if ((invalid | middleSpace) != 0)
+                {
+                    const uint32_t first = static_cast<uint32_t>(__builtin_ctz(invalid | middleSpace));
+                    return ((invalid >> first) & 1) ? Status::InvalidChar : Status::MiddleSpace;
+                }
+            }
+
+            // 各 lane 的數值：數字 0~9，'J'~'R' 為 1~9，其餘 (空白、'}') 與 end 之後的 lane 為 0
+            const __m128i beforeEnd = _mm_cmplt_epi8(laneIndex(), _mm_set1_epi8(static_cast<char>(end)));
+            const __m128i values = _mm_and_si128(beforeEnd,
+                                                 _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(v, _mm_set1_epi8('0'))),
+                                                              _mm_and_si128(punchDigit, _mm_sub_epi8(v, _mm_set1_epi8('I')))));
+
+            // 乘加鏈：2 位 -> 4 位 -> 8 位，得到靠左對齊的 16 位數 (lane 0 為最高位)
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i tens = _mm_set1_epi32(0x0001000A);         // (10, 1)
+            const __m128i hundreds = _mm_set1_epi32(0x00010064);     // (100, 1)
+            const __m128i tenThousands = _mm_set1_epi32(0x00012710); // (10000, 1)
+            const __m128i pairs = _mm_packs_epi32(_mm_madd_epi16(_mm_unpacklo_epi8(values, zero), tens),
+                                                  _mm_madd_epi16(_mm_unpackhi_epi8(values, zero), tens));
+            const __m128i quads = _mm_madd_epi16(pairs, hundreds);
+            const __m128i octets = _mm_madd_epi16(_mm_packs_epi32(quads, quads), tenThousands);
+            const uint64_t high = static_cast<uint32_t>(_mm_cvtsi128_si32(octets));
+            const uint64_t low = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(octets, 4)));
+            const uint64_t leftAligned = high * 100000000 + low;
+
+            // 去掉 end 之後的 16 - end 個 0：整除 10^k 等於右移 k 位再乘以 5^k 的模 2^64 反元素，不需要除法
+            const uint32_t k = MAX_SIMD_LENGTH - end;
+            const int64_t result = static_cast<int64_t>((leftAligned >> k) * backoffice_detail::INVERSE_POW5[k]);
+            out = hasPunch ? -result : result;
+            return Status::Ok;
+        }
+#endif
+    };
+
+} // namespace finance::utils
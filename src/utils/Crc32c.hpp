@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <nmmintrin.h>
+#define FINANCE_CRC32C_HW 1
+#endif
+
+namespace finance::utils
+{
+    namespace crc32c_detail
+    {
+        struct Table
+        {
+            uint32_t entries[256];
+        };
+
+        // 反射多項式 0x82F63B78 的逐位元組查表
+        constexpr Table makeTable() noexcept
+        {
+            Table table{};
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t c = i;
+                for (int bit = 0; bit < 8; ++bit)
+                    c = (c & 1) ? (c >> 1) ^ 0x82F63B78u : c >> 1;
+                table.entries[i] = c;
+            }
+            return table;
+        }
+
+        inline constexpr Table TABLE = makeTable();
+    } // namespace crc32c_detail
+
+    /**
+     * CRC-32C (Castagnoli)：x86-64 執行期偵測到 SSE4.2 時以 crc32 指令計算 (不需要 -msse4.2 編譯)，否則查表。
+     * 用於日誌檔記錄的完整性檢查，可分段累加：crc = Crc32c::extend(crc, data, len)，初始值為 0。
+     */
+    class Crc32c
+    {
+    public:
+        static uint32_t compute(const void *data, size_t length) noexcept
+        {
+            return extend(0, data, length);
+        }
+
+        static uint32_t extend(uint32_t crc, const void *data, size_t length) noexcept
+        {
+#if defined(FINANCE_CRC32C_HW)
+            if (hardwareSupported())
+                return extendHardware(crc, data, length);
+#endif
+            const auto *p = static_cast<const unsigned char *>(data);
+            uint32_t c = ~crc;
+            for (; length > 0; --length, ++p)
+                c = crc32c_detail::TABLE.entries[(c ^ *p) & 0xFF] ^ (c >> 8);
+            return ~c;
+        }
+
+        /// 目前使用的實作，用於日誌
+        static const char *isaName() noexcept
+        {
+#if defined(FINANCE_CRC32C_HW)
+            if (hardwareSupported())
+                return "SSE4.2";
+#endif
+            return "table";
+        }
+
+    private:
+#if defined(FINANCE_CRC32C_HW)
+        static bool hardwareSupported() noexcept
+        {
+            static const bool supported = __builtin_cpu_supports("sse4.2");
+            return supported;
+        }
+
+        __attribute__((target("sse4.2"))) static uint32_t extendHardware(uint32_t crc, const void *data, size_t length) noexcept
+        {
+            const auto *p = static_cast<const unsigned char *>(data);
+            uint64_t c64 = static_cast<uint32_t>(~crc);
+            for (; length >= 8; length -= 8, p += 8)
+            {
+                uint64_t word;
+                std::memcpy(&word, p, sizeof(word));
+                c64 = _mm_crc32_u64(c64, word);
+            }
+            auto c = static_cast<uint32_t>(c64);
+            for (; length > 0; --length, ++p)
+                c = _mm_crc32_u8(c, *p);
+            return ~c;
+        }
+#endif
+    };
+
+} // namespace finance::utils
@@ -4,16 +4,7 @@
 #include "domain/FinanceDataStructure.hpp"
 #include <cstring>
 #include "domain/Result.hpp"
-
-// 把後端資料(交易數字碼 交易量)轉成 -INT64
-#define CONVERT_BACKOFFICE_INT64(STRUCT_NAME, VAR_NAME)                                                                                             \
-    auto RESULT_##VAR_NAME = FinanceUtils::backOfficeToInt(STRUCT_NAME.VAR_NAME, sizeof(STRUCT_NAME.VAR_NAME));                                     \
-    if (RESULT_##VAR_NAME.is_err())                                                                                                                 \
-    {                                                                                                                                               \
-        return Result<void, ErrorResult>::Err(                                                                                                      \
-            ErrorResult{ErrorCode::BackOfficeIntParseError, "CONVERT_BACKOFFICE_INT64:backOfficeToInt parse error : " #STRUCT_NAME "." #VAR_NAME}); \
-    }                                                                                                                                               \
-    int64_t VAR_NAME = RESULT_##VAR_NAME.unwrap();
+#include "utils/BackOfficeDecoder.hpp"
 
 namespace finance::utils
 {
@@ -34,57 +25,13 @@ namespace finance::utils
          */
         static inline domain::Result<int64_t, domain::ErrorResult> backOfficeToInt(const char *value, size_t length) noexcept
         {
-            // Mapping special characters ('J' to 'R' -> 1 to 9, and '}' -> 0) for the last digit and sign
-            static constexpr char OFFSET = 'I'; // The character offset for 'J' to map to 1
-
-            if (value == nullptr || length == 0) // Check for null pointer or zero length
-            {
-                return domain::Result<int64_t, domain::ErrorResult>::Err(
-                    domain::ErrorResult{domain::ErrorCode::BackOfficeIntParseError, "backOfficeToInt: empty input"}); // 空輸入視為成功，結果為 0
-            }
-
+            // 解碼 (含 SIMD 快速路徑) 由 BackOfficeDecoder 處理，這裡只轉成 Result
             int64_t result = 0;
-            bool found_digit = false; // 標記是否已經遇到數字字符
-
-            while (length > 0 && std::isspace(value[length - 1]))
-            {
-                --length;
-            }
-
-            // 遍歷字串
-            for (size_t i = 0; i < length; ++i)
-            {
-                char current_char = value[i];
-
-                if ('0' <= current_char && current_char <= '9')
-                {
-                    // 是數字字符
-                    result = result * 10 + (current_char - '0');
-                    found_digit = true; // 標記已找到數字
-                }
-
-                else if ('J' <= current_char && current_char <= 'R')
-                {
-                    return domain::Result<int64_t, domain::ErrorResult>::Ok(-1 * (result * 10 + (current_char - OFFSET)));
-                }
-                else if (current_char == '}')
-                {
-                    return domain::Result<int64_t, domain::ErrorResult>::Ok(-result * 10);
-                }
-                else if (std::isspace(static_cast<unsigned char>(current_char)))
-                {
-                    if (found_digit)
-                        return domain::Result<int64_t, domain::ErrorResult>::Err(
-                            domain::ErrorResult{domain::ErrorCode::BackOfficeIntParseError, "backOfficeToInt: space in the middle of the string"});
-                }
-                else
-                {
-                    return domain::Result<int64_t, domain::ErrorResult>::Err(
-                        domain::ErrorResult{domain::ErrorCode::BackOfficeIntParseError, "backOfficeToInt: invalid character"});
-                }
-            }
-
-            return domain::Result<int64_t, domain::ErrorResult>::Ok(result);
+            auto status = BackOfficeDecoder::decode(value, length, result);
+            if (status == BackOfficeDecoder::Status::Ok)
+                return domain::Result<int64_t, domain::ErrorResult>::Ok(result);
+            return domain::Result<int64_t, domain::ErrorResult>::Err(
+                domain::ErrorResult{domain::ErrorCode::BackOfficeIntParseError, std::string("backOfficeToInt: ") + BackOfficeDecoder::message(status)});
         }
 
         // 提取指定長度的字符串，並移除尾部空格 (std::string 版本)
@@ -114,6 +61,18 @@ namespace finance::utils
             return std::string_view(str, len);
         }
 
+        // 提取定長欄位並移除尾部空格 (不複製，熱路徑使用)
+        static inline std::string_view trim_right_view(const char *str, size_t length) noexcept
+        {
+            if (str == nullptr)
+                return std::string_view();
+            while (length > 0 && std::isspace(static_cast<unsigned char>(str[length - 1])))
+            {
+                --length;
+            }
+            return std::string_view(str, length);
+        }
+
         // trim_right 函式，返回 std::string，這裡不修改
         static inline std::string trim_right(const char *str, size_t length)
         {
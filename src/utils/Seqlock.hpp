@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace finance::utils
+{
+
+    /**
+     * 單一值的 seqlock：讀者不加鎖、不寫入任何共享狀態，只在讀到寫入中途的資料時重試；寫者永遠不等待讀者。
+     * 序號為奇數表示寫入中。多個寫者以 CAS 取得奇數序號互斥 (通常只有一個寫者，不會競爭)。
+     * 資料以 64 位元字組的 relaxed atomic 存取，讀寫重疊時不構成 data race。
+     * T 必須可平凡複製，且大小為 8 的倍數。
+     */
+    template <typename T>
+    class Seqlock
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Seqlock<T> 需要可平凡複製的 T");
+        static_assert(sizeof(T) % sizeof(uint64_t) == 0, "Seqlock<T> 的 T 大小需為 8 的倍數");
+
+    public:
+        Seqlock() noexcept { store(T{}); }
+
+        Seqlock(const Seqlock &) = delete;
+        Seqlock &operator=(const Seqlock &) = delete;
+
+        void store(const T &value) noexcept
+        {
+            uint64_t words[WORDS];
+            std::memcpy(words, &value, sizeof(T));
+
+            uint64_t seq = seq_.load(std::memory_order_relaxed);
+            while ((seq & 1) != 0 || !seq_.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                seq = seq_.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release); // 資料寫入不可早於奇數序號被看見
+
+            for (size_t i = 0; i < WORDS; ++i)
+                words_[i].store(words[i], std::memory_order_relaxed);
+            seq_.store(seq + 2, std::memory_order_release);
+        }
+
+        /// 單次嘗試讀取；與寫入重疊時回傳 false，out 內容未定義
+        bool tryLoad(T &out) const noexcept
+        {
+            uint64_t before = seq_.load(std::memory_order_acquire);
+            if ((before & 1) != 0)
+                return false;
+            uint64_t words[WORDS];
+            for (size_t i = 0; i < WORDS; ++i)
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire); // 資料讀取不可晚於序號的再次讀取
+            if (seq_.load(std::memory_order_relaxed) != before)
+                return false;
+            std::memcpy(&out, words, sizeof(T));
+            return true;
+        }
+
+        /// 讀取一致的快照，與寫入重疊時重試
+        T load() const noexcept
+        {
+            T out;
+            while (!tryLoad(out))
+            {
+#if defined(__x86_64__) || defined(_M_X64)
+                __builtin_ia32_pause();
+#endif
+            }
+            return out;
+        }
+
+        /// 已完成的寫入次數
+        uint64_t version() const noexcept
+        {
+            return seq_.load(std::memory_order_acquire) >> 1;
+        }
+
+    private:
+        static constexpr size_t WORDS = sizeof(T) / sizeof(uint64_t);
+
+        std::atomic<uint64_t> seq_{0};
+        std::atomic<uint64_t> words_[WORDS];
+    };
+
+} // namespace finance::utils
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "domain/AvailabilityColumns.hpp"
+#include "infrastructure/storage/SummaryTable.hpp"
+#include <random>
+#include <vector>
+
+using finance::domain::AvailabilityColumns;
+using finance::domain::SummaryData;
+using finance::domain::SummaryKey;
+using finance::infrastructure::storage::SummaryTable;
+
+namespace
+{
+    SummaryData randomInputs(std::mt19937_64 &rng)
+    {
+        auto v = [&rng]()
+        { return static_cast<int64_t>(rng() % 2000000000) - 1000000000; };
+        SummaryData d;
+        d.h01_margin_amount = v();
+        d.h01_margin_buy_order_amount = v();
+        d.h01_margin_sell_match_amount = v();
+        d.h01_margin_qty = v();
+        d.h01_margin_buy_order_qty = v();
+        d.h01_margin_sell_match_qty = v();
+        d.h01_short_amount = v();
+        d.h01_short_sell_order_amount = v();
+        d.h01_short_qty = v();
+        d.h01_short_sell_order_qty = v();
+        d.h01_short_after_hour_sell_order_amount = v();
+        d.h01_short_after_hour_sell_order_qty = v();
+        d.h01_short_sell_match_amount = v();
+        d.h01_short_sell_match_qty = v();
+        d.h01_margin_after_hour_buy_order_amount = v();
+        d.h01_margin_after_hour_buy_order_qty = v();
+        d.h01_margin_buy_match_amount = v();
+        d.h01_margin_buy_match_qty = v();
+        d.h05p_margin_buy_offset_qty = v();
+        d.h05p_short_sell_offset_qty = v();
+        return d;
+    }
+
+    void expectSameAvailables(const SummaryData &actual, const SummaryData &expected, size_t id)
+    {
+        EXPECT_EQ(actual.margin_available_amount, expected.margin_available_amount) << "id " << id;
+        EXPECT_EQ(actual.margin_available_qty, expected.margin_available_qty) << "id " << id;
+        EXPECT_EQ(actual.short_available_amount, expected.short_available_amount) << "id " << id;
+        EXPECT_EQ(actual.short_available_qty, expected.short_available_qty) << "id " << id;
+        EXPECT_EQ(actual.after_margin_available_amount, expected.after_margin_available_amount) << "id " << id;
+        EXPECT_EQ(actual.after_margin_available_qty, expected.after_margin_available_qty) << "id " << id;
+        EXPECT_EQ(actual.after_short_available_amount, expected.after_short_available_amount) << "id " << id;
+        EXPECT_EQ(actual.after_short_available_qty, expected.after_short_available_qty) << "id " << id;
+    }
+} // namespace
+
+TEST(AvailabilityColumnsTest, MatchesCalculateAvailablesForEveryEntry)
+{
+    std::mt19937_64 rng(14);
+    // 非 LANES 倍數的筆數，涵蓋補齊的尾段
+    for (size_t count : {size_t{0}, size_t{1}, size_t{3}, size_t{4}, size_t{5}, size_t{1027}})
+    {
+        std::vector<SummaryData> records;
+        for (size_t i = 0; i < count; ++i)
+            records.push_back(randomInputs(rng));
+
+        AvailabilityColumns columns;
+        columns.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            columns.load(i, records[i]);
+        columns.recalculateAll();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            SummaryData actual = records[i];
+            columns.store(i, actual);
+            records[i].calculate_availables();
+            expectSameAvailables(actual, records[i], i);
+        }
+    }
+}
+
+TEST(AvailabilityColumnsTest, ReusesCapacityAcrossResizes)
+{
+    std::mt19937_64 rng(15);
+    AvailabilityColumns columns;
+    for (size_t count : {size_t{9}, size_t{2}, size_t{6}})
+    {
+        std::vector<SummaryData> records;
+        columns.resize(count);
+        EXPECT_EQ(columns.size(), count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            records.push_back(randomInputs(rng));
+            columns.load(i, records[i]);
+        }
+        columns.recalculateAll();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            SummaryData actual;
+            columns.store(i, actual);
+            records[i].calculate_availables();
+            expectSameAvailables(actual, records[i], i);
+        }
+    }
+}
+
+TEST(AvailabilityColumnsTest, DetectsRawInputs)
+{
+    SummaryData loaded;
+    loaded.margin_available_qty = 100; // 只有可用數量 (由 Redis 載入)
+    EXPECT_FALSE(AvailabilityColumns::hasRawInputs(loaded));
+
+    loaded.h05p_short_sell_offset_qty = -1;
+    EXPECT_TRUE(AvailabilityColumns::hasRawInputs(loaded));
+}
+
+TEST(AvailabilityColumnsTest, VisitsTableEntriesForBulkRecompute)
+{
+    std::mt19937_64 rng(16);
+    SummaryTable table;
+    for (int i = 0; i < 300; ++i)
+        *table.emplace(*SummaryKey::make("01", std::to_string(i))).first = randomInputs(rng);
+    *table.emplace(std::string("legacy-key")).first = randomInputs(rng);
+    table.erase(*SummaryKey::make("01", "7"));
+
+    std::vector<std::pair<const SummaryKey *, SummaryData *>> entries;
+    std::vector<SummaryKey> keys;
+    table.forEach([&](const SummaryKey *key, SummaryData &data)
+                  {
+                      if (key)
+                          keys.push_back(*key);
+                      entries.emplace_back(key, &data); });
+    ASSERT_EQ(entries.size(), table.size());
+    EXPECT_EQ(keys.size(), 299u);
+    for (const auto &key : keys)
+        EXPECT_NE(table.find(key), nullptr);
+
+    AvailabilityColumns columns;
+    columns.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+        columns.load(i, *entries[i].second);
+    columns.recalculateAll();
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        SummaryData expected = *entries[i].second;
+        expected.calculate_availables();
+        columns.store(i, *entries[i].second);
+        expectSameAvailables(*entries[i].second, expected, i);
+    }
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "utils/BackOfficeDecoder.hpp"
+#include "domain/FinanceDataStructure.hpp"
+#include <cstring>
+#include <random>
+#include <string>
+
+using finance::utils::BackOfficeDecoder;
+using Status = BackOfficeDecoder::Status;
+
+namespace
+{
+    // 逐字元版本為參考實作：狀態相同，成功時數值相同
+    void expectSameAsScalar(const std::string &s)
+    {
+        int64_t fast = 0, reference = 0;
+        Status fastStatus = BackOfficeDecoder::decode(s.data(), s.size(), fast);
+        Status referenceStatus = BackOfficeDecoder::decodeScalar(s.data(), s.size(), reference);
+        ASSERT_EQ(fastStatus, referenceStatus) << "'" << s << "'";
+        if (referenceStatus == Status::Ok)
+        {
+            ASSERT_EQ(fast, reference) << "'" << s << "'";
+        }
+
+        // 批次版本直接從記錄載入 16 字節，欄位之後的內容不可影響結果
+        const std::string record = s + "9J 9}x9999999999";
+        const BackOfficeDecoder::Field field{"f", 0, static_cast<uint8_t>(s.size())};
+        int64_t batch = 0;
+        Status batchStatus;
+        ASSERT_EQ(BackOfficeDecoder::decodeBatch(record.data(), record.size(), &field, 1, &batch, batchStatus),
+                  referenceStatus == Status::Ok ? 1u : 0u);
+        ASSERT_EQ(batchStatus, referenceStatus) << "'" << s << "'";
+        if (referenceStatus == Status::Ok)
+        {
+            ASSERT_EQ(batch, reference) << "'" << s << "'";
+        }
+    }
+} // namespace
+
+TEST(BackOfficeDecoderTest, MatchesScalarOnTypicalFields)
+{
+    for (const char *s : {"00000012345", "0000001234}", "0000001234R", "     12345", "   1234J   ", "           ",
+                          "123456", "00000J", "}", "J", "1J23", "1J@@", "12 J", "1 2", " 1 ", "12a", "-123", "\t12\r",
+                          "99999999999", "9999999999R", "1234567890123456", "123456789012345}", " 2  ", "\x80" "12"})
+        expectSameAsScalar(s);
+}
+
+TEST(BackOfficeDecoderTest, MatchesScalarOnRandomFields)
+{
+    const std::string alphabet = "0123456789JKLMNOPQR}  \t\rA-*\x80";
+    std::mt19937 rng(20240611);
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+    std::uniform_int_distribution<size_t> len(1, 20);
+    for (int i = 0; i < 200000; ++i)
+    {
+        std::string s(len(rng), ' ');
+        for (auto &c : s)
+            c = alphabet[pick(rng)];
+        expectSameAsScalar(s);
+    }
+    // 較常見的形態：前導空白 + 數字 + 可能的負號碼 + 尾部空白
+    for (int i = 0; i < 50000; ++i)
+    {
+        std::string s;
+        s.append(len(rng) % 5, ' ');
+        size_t digits = len(rng) % 12;
+        for (size_t d = 0; d < digits; ++d)
+            s.push_back(static_cast<char>('0' + rng() % 10));
+        if (rng() % 2)
+            s.push_back("JKLMNOPQR}"[rng() % 10]);
+        s.append(len(rng) % 4, ' ');
+        if (s.empty() || s.size() > 16)
+            continue;
+        expectSameAsScalar(s);
+    }
+}
+
+TEST(BackOfficeDecoderTest, EmptyInput)
+{
+    int64_t out = 0;
+    EXPECT_EQ(BackOfficeDecoder::decode(nullptr, 6, out), Status::Empty);
+    EXPECT_EQ(BackOfficeDecoder::decode("123", 0, out), Status::Empty);
+}
+
+TEST(BackOfficeDecoderTest, BatchDecodesRecordAndReportsFailingField)
+{
+    finance::domain::MessageDataHCRTM01 record;
+    std::memset(&record, ' ', sizeof(record));
+    std::memcpy(record.margin_amount, "0000012345}", 11);
+    std::memcpy(record.margin_qty, "  123J", 6);
+    std::memcpy(record.short_qty, "000042", 6);
+    // 記錄的最後一個欄位：之後不足 16 字節，走複製的路徑
+    std::memcpy(record.day_trade_short_sell_match_amount, "0000000007R", 11);
+
+    const BackOfficeDecoder::Field fields[] = {
+        BACKOFFICE_FIELD(finance::domain::MessageDataHCRTM01, margin_amount),
+        BACKOFFICE_FIELD(finance::domain::MessageDataHCRTM01, margin_qty),
+        BACKOFFICE_FIELD(finance::domain::MessageDataHCRTM01, short_qty),
+        BACKOFFICE_FIELD(finance::domain::MessageDataHCRTM01, day_trade_short_sell_match_amount),
+        BACKOFFICE_FIELD(finance::domain::MessageDataHCRTM01, margin_buy_order_amount),
+    };
+    int64_t out[5] = {};
+    Status status;
+    const char *base = reinterpret_cast<const char *>(&record);
+
+    EXPECT_EQ(BackOfficeDecoder::decodeBatch(base, sizeof(record), fields, 5, out, status), 5u);
+    EXPECT_EQ(status, Status::Ok);
+    EXPECT_EQ(out[0], -123450);
+    EXPECT_EQ(out[1], -1231);
+    EXPECT_EQ(out[2], 42);
+    EXPECT_EQ(out[3], -79);
+    EXPECT_EQ(out[4], 0);
+
+    std::memcpy(record.short_qty, "00 042", 6);
+    EXPECT_EQ(BackOfficeDecoder::decodeBatch(base, sizeof(record), fields, 5, out, status), 2u);
+    EXPECT_EQ(status, Status::MiddleSpace);
+    EXPECT_STREQ(fields[2].name, "short_qty");
+}
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include "domain/FinanceDataStructure.hpp"
+#include "infrastructure/config/AreaBranchProvider.hpp"
+#include <string>
+#include <vector>
+
+using finance::domain::BranchListRef;
+using finance::domain::SummaryData;
+using finance::infrastructure::config::AreaBranchProvider;
+
+TEST(BranchListRefTest, DefaultIsEmptyList)
+{
+    BranchListRef ref;
+    EXPECT_TRUE(ref.empty());
+    EXPECT_EQ(ref.size(), 0u);
+    EXPECT_TRUE(ref.get().empty());
+    EXPECT_EQ(ref.begin(), ref.end());
+    EXPECT_EQ(ref, AreaBranchProvider::internBranches({}));
+}
+
+TEST(BranchListRefTest, InternSharesOneCopyPerContent)
+{
+    auto a = AreaBranchProvider::internBranches({"9A00", "9A91"});
+    auto b = AreaBranchProvider::internBranches(std::vector<std::string>{"9A00", "9A91"});
+    auto c = AreaBranchProvider::internBranches({"9A00"});
+
+    EXPECT_EQ(&a.get(), &b.get());
+    EXPECT_NE(&a.get(), &c.get());
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    ASSERT_EQ(a.size(), 2u);
+    EXPECT_EQ(a[1], "9A91");
+}
+
+TEST(BranchListRefTest, SummaryCopiesShareTheList)
+{
+    SummaryData data;
+    data.belong_branches = AreaBranchProvider::internBranches({"9B00", "9B01", "9B02"});
+    SummaryData copy = data;
+    EXPECT_EQ(&copy.belong_branches.get(), &data.belong_branches.get());
+    EXPECT_EQ(sizeof(data.belong_branches), sizeof(void *));
+}
+
+TEST(BranchListRefTest, UnknownAreaHasNoBranches)
+{
+    EXPECT_TRUE(AreaBranchProvider::getBranchListFromArea("no-such-area").empty());
+}
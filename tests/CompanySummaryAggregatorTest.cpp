@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "infrastructure/storage/CompanySummaryAggregator.hpp"
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using finance::domain::SummaryData;
+using finance::domain::SummaryKey;
+using finance::infrastructure::storage::AvailableTotals;
+using finance::infrastructure::storage::CompanySummaryAggregator;
+
+namespace
+{
+    const std::vector<std::string> AREAS = {"9A", "9B", "9C", "9D"};
+
+    SummaryKey key(const std::string &area, const std::string &stock)
+    {
+        return *SummaryKey::make(area, stock);
+    }
+
+    CompanySummaryAggregator makeAggregator()
+    {
+        return CompanySummaryAggregator([](const std::string &area)
+                                        { return area.rfind("9", 0) == 0; });
+    }
+
+    SummaryData areaData(int64_t base)
+    {
+        SummaryData d;
+        d.margin_available_amount = base;
+        d.margin_available_qty = base + 1;
+        d.short_available_amount = base + 2;
+        d.short_available_qty = base + 3;
+        d.after_margin_available_amount = base + 4;
+        d.after_margin_available_qty = base + 5;
+        d.after_short_available_amount = base + 6;
+        d.after_short_available_qty = base + 7;
+        return d;
+    }
+
+    // 與原本 buildCompanySummary 相同的全量重算
+    AvailableTotals recompute(const std::map<uint64_t, SummaryData> &cache, const std::string &stock)
+    {
+        AvailableTotals total;
+        for (const auto &area : AREAS)
+        {
+            auto it = cache.find(key(area, stock).packed());
+            if (it != cache.end())
+                total += AvailableTotals::from(it->second);
+        }
+        return total;
+    }
+} // namespace
+
+TEST(CompanySummaryAggregatorTest, AppliesDeltaWhenAreaChanges)
+{
+    auto agg = makeAggregator();
+    agg.apply(key("9A", "2330"), areaData(100));
+    agg.apply(key("9B", "2330"), areaData(10));
+    EXPECT_EQ(agg.totals(key("ALL", "2330")).margin_available_amount, 110);
+
+    agg.apply(key("9A", "2330"), areaData(40));
+    EXPECT_EQ(agg.totals(key("ALL", "2330")).margin_available_amount, 50);
+    EXPECT_EQ(agg.totals(key("ALL", "2330")).after_short_available_qty, 47 + 17);
+    EXPECT_EQ(agg.totals(key("ALL", "2317")), AvailableTotals{});
+}
+
+TEST(CompanySummaryAggregatorTest, IgnoresKeysOutsideCompanyScope)
+{
+    auto agg = makeAggregator();
+    agg.apply(key("ALL", "2330"), areaData(1000));
+    agg.apply(key("XX", "2330"), areaData(1000));
+    EXPECT_EQ(agg.totals(key("ALL", "2330")), AvailableTotals{});
+}
+
+TEST(CompanySummaryAggregatorTest, RemoveSubtractsContribution)
+{
+    auto agg = makeAggregator();
+    agg.apply(key("9A", "2330"), areaData(100));
+    agg.apply(key("9B", "2330"), areaData(10));
+    agg.remove(key("9A", "2330"));
+    EXPECT_EQ(agg.totals(key("ALL", "2330")), AvailableTotals::from(areaData(10)));
+    agg.remove(key("9A", "2330"));
+    EXPECT_EQ(agg.totals(key("ALL", "2330")), AvailableTotals::from(areaData(10)));
+}
+
+TEST(CompanySummaryAggregatorTest, ResetReplacesIncrementalState)
+{
+    auto agg = makeAggregator();
+    agg.apply(key("9A", "2330"), areaData(100));
+
+    SummaryData actual = areaData(7);
+    std::vector<std::pair<SummaryKey, const SummaryData *>> areas{{key("9A", "2330"), &actual}};
+    agg.reset(key("9A", "2330"), areas);
+    EXPECT_EQ(agg.totals(key("ALL", "2330")), AvailableTotals::from(actual));
+
+    // 之後的增量以覆蓋後的值為基準
+    agg.apply(key("9A", "2330"), areaData(8));
+    EXPECT_EQ(agg.totals(key("ALL", "2330")), AvailableTotals::from(areaData(8)));
+}
+
+TEST(CompanySummaryAggregatorTest, MatchesFullRecomputeUnderRandomUpdates)
+{
+    auto agg = makeAggregator();
+    std::map<uint64_t, SummaryData> cache;
+    const std::vector<std::string> stocks = {"2330", "2317", "0050"};
+    std::mt19937_64 rng(7);
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        const auto &area = AREAS[rng() % AREAS.size()];
+        const auto &stock = stocks[rng() % stocks.size()];
+        auto k = key(area, stock);
+        if (rng() % 10 == 0)
+        {
+            cache.erase(k.packed());
+            agg.remove(k);
+        }
+        else
+        {
+            cache[k.packed()] = areaData(static_cast<int64_t>(rng() % 2000000) - 1000000);
+            agg.apply(k, cache[k.packed()]);
+        }
+
+        for (const auto &s : stocks)
+            ASSERT_EQ(agg.totals(key("ALL", s)), recompute(cache, s)) << "step " << i << " stock " << s;
+    }
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "infrastructure/network/DelimiterScanner.hpp"
+#include <string>
+#include <vector>
+#include <random>
+
+using finance::infrastructure::network::DelimiterScanner;
+
+// 逐字節的參考實作
+static std::vector<size_t> referencePositions(const std::string &data, char delim)
+{
+    std::vector<size_t> positions;
+    for (size_t i = 0; i < data.size(); ++i)
+        if (data[i] == delim)
+            positions.push_back(i);
+    return positions;
+}
+
+static std::vector<size_t> scanPositions(const char *data, size_t len, char delim)
+{
+    std::vector<size_t> positions;
+    size_t stop = DelimiterScanner::scan(data, len, delim, [&](size_t off)
+                                         {
+                                             positions.push_back(off);
+                                             return true; });
+    EXPECT_EQ(stop, len);
+    return positions;
+}
+
+TEST(DelimiterScannerTest, BlockMaskMarksEveryDelimiter)
+{
+    std::string block(DelimiterScanner::BLOCK_SIZE, 'x');
+    block[0] = '\n';
+    block[15] = '\n';
+    block[16] = '\n';
+    block[31] = '\n';
+    block[32] = '\n';
+    block[63] = '\n';
+
+    uint64_t expected = (1ULL << 0) | (1ULL << 15) | (1ULL << 16) | (1ULL << 31) | (1ULL << 32) | (1ULL << 63);
+    EXPECT_EQ(DelimiterScanner::blockMask(block.data(), '\n'), expected);
+    EXPECT_EQ(DelimiterScanner::blockMask(block.data(), '|'), 0u);
+}
+
+TEST(DelimiterScannerTest, BlockMaskDoesNotMatchHighBitBytes)
+{
+    // 0x8A 與 '\n' (0x0A) 只差最高位，不可被誤判
+    std::string block(DelimiterScanner::BLOCK_SIZE, static_cast<char>(0x8A));
+    block[7] = '\n';
+    EXPECT_EQ(DelimiterScanner::blockMask(block.data(), '\n'), 1ULL << 7);
+}
+
+TEST(DelimiterScannerTest, ScanMatchesReferenceForAllLengthsAndOffsets)
+{
+    std::mt19937 rng(20240501);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::string data(3 * DelimiterScanner::BLOCK_SIZE + 17, '\0');
+    for (auto &c : data)
+        c = (byte(rng) % 7 == 0) ? '\n' : static_cast<char>(byte(rng));
+
+    // 各種起點 (非對齊) 與長度 (含不足一個區塊的尾段)
+    for (size_t start = 0; start < 9; ++start)
+    {
+        for (size_t len = 0; start + len <= data.size(); len += 13)
+        {
+            std::string slice = data.substr(start, len);
+            EXPECT_EQ(scanPositions(data.data() + start, len, '\n'), referencePositions(slice, '\n'))
+                << "start=" << start << " len=" << len;
+        }
+    }
+}
+
+TEST(DelimiterScannerTest, ScanStopsWhenCallbackReturnsFalse)
+{
+    std::string data(200, 'a');
+    data[10] = '\n';
+    data[70] = '\n';
+    data[150] = '\n';
+
+    std::vector<size_t> seen;
+    size_t stop = DelimiterScanner::scan(data.data(), data.size(), '\n', [&](size_t off)
+                                         {
+                                             seen.push_back(off);
+                                             return seen.size() < 2; });
+    EXPECT_EQ(seen, (std::vector<size_t>{10, 70}));
+    EXPECT_EQ(stop, 71u);
+}
+
+TEST(DelimiterScannerTest, ScanWithoutDelimiterReturnsLength)
+{
+    std::string data(1000, 'z');
+    size_t calls = 0;
+    size_t stop = DelimiterScanner::scan(data.data(), data.size(), '\n', [&](size_t)
+                                         {
+                                             ++calls;
+                                             return true; });
+    EXPECT_EQ(calls, 0u);
+    EXPECT_EQ(stop, data.size());
+}
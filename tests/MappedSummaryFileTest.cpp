@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include "infrastructure/storage/MappedSummaryFile.hpp"
+#include "infrastructure/storage/RedisSummaryAdapter.hpp"
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+
+using namespace finance::domain;
+using finance::infrastructure::config::AreaBranchProvider;
+using finance::infrastructure::storage::MappedSummaryFile;
+using finance::infrastructure::storage::RedisSummaryAdapter;
+
+namespace
+{
+    // 與同一測試執行檔中其他測試相同的區中心設定 (AreaBranchProvider 只載入一次，內容需一致)
+    void loadAreaConfig()
+    {
+        auto path = std::filesystem::temp_directory_path() / "mapped_summary_area_branch.json";
+        std::ofstream(path) << R"({"91": ["9100", "9101"], "92": ["9200"]})";
+        AreaBranchProvider::loadFromFile(path.string());
+    }
+
+    std::string tempPath(const char *name)
+    {
+        auto path = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove(path);
+        return path.string();
+    }
+
+    SummarySnapshot makeSnapshot(SummaryKey key, int64_t value)
+    {
+        SummaryData data;
+        data.h01_margin_amount = value;
+        data.h01_short_qty = value * 2;
+        data.h05p_short_sell_offset_qty = value * 3;
+        data.margin_available_qty = value * 4;
+        return SummarySnapshot::from(key, data);
+    }
+
+    std::map<uint64_t, int64_t> readAll(const MappedSummaryFile &file)
+    {
+        std::map<uint64_t, int64_t> records;
+        file.forEach([&](SummaryKey key, const SummarySnapshot &snapshot)
+                     {
+                         EXPECT_EQ(snapshot.key, key.packed());
+                         EXPECT_EQ(snapshot.h01_short_qty, snapshot.h01_margin_amount * 2);
+                         EXPECT_EQ(snapshot.h05p_short_sell_offset_qty, snapshot.h01_margin_amount * 3);
+                         EXPECT_EQ(snapshot.margin_available_qty, snapshot.h01_margin_amount * 4);
+                         EXPECT_TRUE(snapshot.belong_branches.empty());
+                         records[key.packed()] = snapshot.h01_margin_amount; });
+        return records;
+    }
+} // namespace
+
+TEST(MappedSummaryFileTest, RecordsSurviveReopen)
+{
+    const auto path = tempPath("mapped_summary_reopen.bin");
+    const auto a = *SummaryKey::make("91", "2330");
+    const auto b = *SummaryKey::make("ALL", "2330");
+    const auto c = *SummaryKey::make("92", "00632R");
+    {
+        auto file = MappedSummaryFile::open(path, 100);
+        ASSERT_NE(file, nullptr);
+        EXPECT_EQ(file->capacity(), 1024u); // 進位到最小容量
+        ASSERT_TRUE(file->store(a, makeSnapshot(a, 1)));
+        ASSERT_TRUE(file->store(b, makeSnapshot(b, 2)));
+        ASSERT_TRUE(file->store(c, makeSnapshot(c, 3)));
+        ASSERT_TRUE(file->store(a, makeSnapshot(a, 10))); // 覆寫同一筆
+        file->erase(c);
+    }
+
+    auto file = MappedSummaryFile::open(path, 4096);
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(file->capacity(), 1024u); // 既有檔案沿用原容量
+    EXPECT_EQ(file->discardedRecords(), 0u);
+    EXPECT_EQ(readAll(*file), (std::map<uint64_t, int64_t>{{a.packed(), 10}, {b.packed(), 2}}));
+
+    // 移除後可再次寫入
+    ASSERT_TRUE(file->store(c, makeSnapshot(c, 5)));
+    EXPECT_EQ(readAll(*file).at(c.packed()), 5);
+    file->clear();
+    EXPECT_TRUE(readAll(*file).empty());
+}
+
+TEST(MappedSummaryFileTest, DiscardsRecordInterruptedMidWrite)
+{
+    const auto path = tempPath("mapped_summary_torn.bin");
+    const auto a = *SummaryKey::make("91", "2330");
+    const auto b = *SummaryKey::make("91", "2317");
+    {
+        auto file = MappedSummaryFile::open(path, 1024);
+        ASSERT_TRUE(file->store(a, makeSnapshot(a, 1)));
+        ASSERT_TRUE(file->store(b, makeSnapshot(b, 2)));
+    }
+    // 模擬程序在寫入 b 的途中結束：序號停在奇數
+    {
+        std::fstream raw(path, std::ios::in | std::ios::out | std::ios::binary);
+        for (size_t i = 0; i < 1024; ++i)
+        {
+            const auto offset = static_cast<std::streamoff>(MappedSummaryFile::HEADER_SIZE + i * MappedSummaryFile::RECORD_SIZE);
+            uint64_t words[2];
+            raw.seekg(offset);
+            raw.read(reinterpret_cast<char *>(words), sizeof(words));
+            if (words[1] == b.packed())
+            {
+                words[0] |= 1;
+                raw.seekp(offset);
+                raw.write(reinterpret_cast<const char *>(words), sizeof(words));
+            }
+        }
+    }
+
+    auto file = MappedSummaryFile::open(path, 1024);
+    EXPECT_EQ(file->discardedRecords(), 1u);
+    EXPECT_EQ(readAll(*file), (std::map<uint64_t, int64_t>{{a.packed(), 1}}));
+    ASSERT_TRUE(file->store(b, makeSnapshot(b, 7))); // 捨棄後不會卡住之後的寫入
+    EXPECT_EQ(readAll(*file).at(b.packed()), 7);
+}
+
+TEST(MappedSummaryFileTest, ReinitializesIncompatibleFileAndReportsFull)
+{
+    const auto path = tempPath("mapped_summary_layout.bin");
+    std::ofstream(path) << "not a summary cache file";
+    auto file = MappedSummaryFile::open(path, 1);
+    ASSERT_NE(file, nullptr);
+    EXPECT_TRUE(readAll(*file).empty());
+
+    size_t stored = 0;
+    for (int id = 0; id < 1100; ++id)
+    {
+        auto key = *SummaryKey::make("91", std::to_string(id));
+        stored += file->store(key, makeSnapshot(key, id));
+    }
+    EXPECT_EQ(stored, file->capacity());
+}
+
+TEST(MappedSummaryFileTest, AdapterRestoresCacheFromFile)
+{
+    loadAreaConfig();
+    const auto path = tempPath("mapped_summary_adapter.bin");
+    const auto area = *SummaryKey::make("91", "2330");
+    const auto all = *SummaryKey::make("ALL", "2330");
+    {
+        RedisSummaryAdapter repo(nullptr, 2);
+        EXPECT_EQ(repo.attachPersistentCache(MappedSummaryFile::open(path, 1024)), 0u);
+        SummaryData data;
+        data.stock_id = "2330";
+        data.area_center = "91";
+        data.h01_margin_amount = 1000;
+        data.h01_margin_qty = 5;
+        data.calculate_availables();
+        ASSERT_TRUE(repo.setData(area.redisKey(), data).is_ok());
+        // handler 路徑：直接修改快取資料後以 sync_detached 發佈 (沒有 task poster 時退回 sync_async，送出失敗不影響發佈)
+        auto *cached = repo.getData(area).unwrap();
+        cached->h01_margin_amount = 2000;
+        repo.sync_detached(area, *cached);
+    }
+
+    RedisSummaryAdapter repo(nullptr, 2);
+    ASSERT_EQ(repo.attachPersistentCache(MappedSummaryFile::open(path, 1024)), 1u);
+    auto *restored = repo.getData(area).unwrap();
+    EXPECT_EQ(restored->stock_id, "2330");
+    EXPECT_EQ(restored->area_center, "91");
+    EXPECT_EQ(restored->h01_margin_amount, 2000);
+    EXPECT_EQ(restored->h01_margin_qty, 5);
+    EXPECT_EQ(restored->belong_branches, AreaBranchProvider::getBranchListFromArea(area));
+    auto snapshot = repo.snapshot(area);
+    ASSERT_TRUE(snapshot.has_value());
+    EXPECT_EQ(snapshot->h01_margin_amount, 2000);
+    EXPECT_EQ(snapshot->belong_branches, restored->belong_branches);
+    EXPECT_FALSE(repo.snapshot(all).has_value()); // 總公司資料未曾寫入，不會憑空出現
+    EXPECT_TRUE(repo.reconcile().is_err()); // 未連線 Redis
+}
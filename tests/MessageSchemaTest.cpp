@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "infrastructure/network/MessageSchema.hpp"
+#include <cstring>
+#include <string>
+
+using namespace finance::domain;
+using finance::infrastructure::network::MessageSchema;
+using finance::infrastructure::network::SchemaDecoder;
+
+// 以欄位表驅動，對每種訊息格式跑同一組測試
+template <typename Message>
+class MessageSchemaTest : public ::testing::Test
+{
+protected:
+    using Decoder = SchemaDecoder<Message>;
+    using Schema = MessageSchema<Message>;
+
+    // 第 i 個欄位的測試值：互不相同，奇數欄位為負數 (以負號碼表示)
+    static int64_t expectedValue(size_t i) { return (i % 2 ? -1 : 1) * static_cast<int64_t>((i + 1) * 1000 + 7); }
+
+    static void writeField(char *field, size_t width, int64_t value)
+    {
+        std::string digits = std::to_string(value < 0 ? -value : value);
+        if (value < 0)
+            digits.back() = "}JKLMNOPQR"[digits.back() - '0'];
+        ASSERT_LE(digits.size(), width);
+        std::memset(field, '0', width);
+        std::memcpy(field + width - digits.size(), digits.data(), digits.size());
+    }
+
+    static void fill(Message &message)
+    {
+        std::memset(&message, ' ', sizeof(message));
+        for (size_t i = 0; i < Decoder::FIELD_COUNT; ++i)
+        {
+            const auto &spec = Schema::NUMERIC_FIELDS[i];
+            writeField(reinterpret_cast<char *>(&message) + spec.offset, spec.width, expectedValue(i));
+        }
+    }
+};
+
+using MessageTypes = ::testing::Types<MessageDataHCRTM01, MessageDataHCRTM05P>;
+TYPED_TEST_SUITE(MessageSchemaTest, MessageTypes);
+
+TYPED_TEST(MessageSchemaTest, DecoderFieldsMirrorSchema)
+{
+    using Decoder = typename TestFixture::Decoder;
+    using Schema = typename TestFixture::Schema;
+    static_assert(finance::infrastructure::network::isValidSchema<TypeParam>());
+    for (size_t i = 0; i < Decoder::FIELD_COUNT; ++i)
+    {
+        EXPECT_STREQ(Decoder::DECODER_FIELDS[i].name, Schema::NUMERIC_FIELDS[i].name);
+        EXPECT_EQ(Decoder::DECODER_FIELDS[i].offset, Schema::NUMERIC_FIELDS[i].offset);
+        EXPECT_EQ(Decoder::DECODER_FIELDS[i].length, Schema::NUMERIC_FIELDS[i].width);
+        // 後台數值欄位寬度為 6 (張數) 或 11 (金額)
+        EXPECT_TRUE(Schema::NUMERIC_FIELDS[i].width == 6 || Schema::NUMERIC_FIELDS[i].width == 11) << Schema::NUMERIC_FIELDS[i].name;
+    }
+}
+
+TYPED_TEST(MessageSchemaTest, DecodesEveryFieldIntoItsTarget)
+{
+    using Decoder = typename TestFixture::Decoder;
+    using Schema = typename TestFixture::Schema;
+    TypeParam message;
+    TestFixture::fill(message);
+
+    SummaryData data;
+    ASSERT_TRUE(Decoder::decode(message, sizeof(message), data).is_ok());
+    for (size_t i = 0; i < Decoder::FIELD_COUNT; ++i)
+        EXPECT_EQ(data.*(Schema::NUMERIC_FIELDS[i].target), TestFixture::expectedValue(i)) << Schema::NUMERIC_FIELDS[i].name;
+}
+
+TYPED_TEST(MessageSchemaTest, PacketOverloadReadsOwnUnionMember)
+{
+    using Decoder = typename TestFixture::Decoder;
+    using Schema = typename TestFixture::Schema;
+    FinancePackageMessage pkg;
+    std::memset(&pkg, ' ', sizeof(pkg));
+    TestFixture::fill(const_cast<TypeParam &>(Schema::from(pkg)));
+
+    SummaryData data;
+    ASSERT_TRUE(Decoder::decode(pkg, data).is_ok());
+    for (size_t i = 0; i < Decoder::FIELD_COUNT; ++i)
+        EXPECT_EQ(data.*(Schema::NUMERIC_FIELDS[i].target), TestFixture::expectedValue(i)) << Schema::NUMERIC_FIELDS[i].name;
+}
+
+TYPED_TEST(MessageSchemaTest, InvalidFieldIsNamedAndNothingIsWritten)
+{
+    using Decoder = typename TestFixture::Decoder;
+    using Schema = typename TestFixture::Schema;
+    const size_t bad = Decoder::FIELD_COUNT - 1;
+    TypeParam message;
+    TestFixture::fill(message);
+    reinterpret_cast<char *>(&message)[Schema::NUMERIC_FIELDS[bad].offset] = 'x';
+
+    SummaryData data;
+    auto result = Decoder::decode(message, sizeof(message), data);
+    ASSERT_TRUE(result.is_err());
+    EXPECT_EQ(result.unwrap_err().code, ErrorCode::BackOfficeIntParseError);
+    const std::string expectedName = std::string(Schema::NAME) + "." + Schema::NUMERIC_FIELDS[bad].name;
+    EXPECT_NE(result.unwrap_err().message.find(expectedName), std::string::npos) << result.unwrap_err().message;
+    for (size_t i = 0; i < Decoder::FIELD_COUNT; ++i)
+        EXPECT_EQ(data.*(Schema::NUMERIC_FIELDS[i].target), 0) << Schema::NUMERIC_FIELDS[i].name;
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include "infrastructure/network/PacketConflator.hpp"
+#include "infrastructure/config/AreaBranchProvider.hpp"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstring>
+
+using finance::domain::FinancePackageMessage;
+using finance::infrastructure::config::AreaBranchProvider;
+using finance::infrastructure::network::PacketConflator;
+
+namespace
+{
+    struct TestSeg
+    {
+        const char *ptr;
+        size_t len;
+    };
+
+    // 與同一測試執行檔中其他測試相同的區中心設定 (AreaBranchProvider 只載入一次，內容需一致)
+    void loadAreaConfig()
+    {
+        auto path = std::filesystem::temp_directory_path() / "packet_conflator_area_branch.json";
+        std::ofstream(path) << R"({"91": ["9100", "9101"], "92": ["9200"]})";
+        AreaBranchProvider::loadFromFile(path.string());
+    }
+
+    // 建立 ELD001 / ELD002 封包 (空白填充、數值欄位填合法的 '1'、'\n' 結尾)
+    std::string makePacket(const char *tcode, char entryType, const char *system, const char *area, const char *stock)
+    {
+        loadAreaConfig();
+        FinancePackageMessage pkg;
+        std::memset(&pkg, ' ', sizeof(pkg));
+        std::memcpy(pkg.t_code, tcode, sizeof(pkg.t_code));
+        pkg.ap_data.entry_type[0] = entryType;
+        std::memcpy(pkg.ap_data.system, system, std::strlen(system));
+        std::memset(&pkg.ap_data.data, '1', sizeof(pkg.ap_data.data));
+        if (std::strcmp(tcode, "ELD001") == 0)
+        {
+            auto &d = pkg.ap_data.data.hcrtm01;
+            std::memset(d.area_center, ' ', sizeof(d.area_center));
+            std::memcpy(d.area_center, area, std::strlen(area));
+            std::memset(d.stock_id, ' ', sizeof(d.stock_id));
+            std::memcpy(d.stock_id, stock, std::strlen(stock));
+        }
+        else
+        {
+            auto &d = pkg.ap_data.data.hcrtm05p;
+            std::memset(d.broker_id, ' ', sizeof(d.broker_id));
+            std::memcpy(d.broker_id, area, std::strlen(area));
+            std::memset(d.stock_id, ' ', sizeof(d.stock_id));
+            std::memcpy(d.stock_id, stock, std::strlen(stock));
+        }
+        std::string packet(reinterpret_cast<const char *>(&pkg), sizeof(pkg));
+        packet.back() = '\n';
+        return packet;
+    }
+
+    std::vector<uint8_t> conflate(const std::vector<std::string> &packets)
+    {
+        std::vector<TestSeg> segs;
+        for (const auto &p : packets)
+            segs.push_back(TestSeg{p.data(), p.size()});
+        PacketConflator conflator;
+        std::vector<uint8_t> skip;
+        size_t skipped = conflator.markSuperseded(segs.data(), segs.size(), skip);
+        size_t marked = 0;
+        for (auto s : skip)
+            marked += s;
+        EXPECT_EQ(skipped, marked);
+        return skip;
+    }
+}
+
+TEST(PacketConflatorTest, KeepsOnlyLatestHcrtm01PerKey)
+{
+    std::vector<std::string> packets = {
+        makePacket("ELD001", 'A', "91", "91", "2330"),
+        makePacket("ELD001", 'A', "91", "91", "2317"),
+        makePacket("ELD001", 'C', "91", "91", "2330"),
+        makePacket("ELD001", 'A', "91", "91", "2330"),
+    };
+    EXPECT_EQ(conflate(packets), (std::vector<uint8_t>{1, 0, 1, 0}));
+}
+
+TEST(PacketConflatorTest, DifferentAreasAreNotConflated)
+{
+    std::vector<std::string> packets = {
+        makePacket("ELD001", 'A', "91", "91", "2330"),
+        makePacket("ELD001", 'A', "92", "92", "2330"),
+    };
+    EXPECT_EQ(conflate(packets), (std::vector<uint8_t>{0, 0}));
+}
+
+TEST(PacketConflatorTest, Hcrtm05pIsNeverSkipped)
+{
+    std::vector<std::string> packets = {
+        makePacket("ELD002", 'A', "91", "91", "2330"),
+        makePacket("ELD001", 'A', "91", "91", "2330"),
+        makePacket("ELD002", 'A', "91", "91", "2330"),
+        makePacket("ELD001", 'A', "91", "91", "2330"),
+        makePacket("ELD002", 'A', "91", "91", "2330"),
+    };
+    EXPECT_EQ(conflate(packets), (std::vector<uint8_t>{0, 1, 0, 0, 0}));
+}
+
+TEST(PacketConflatorTest, InvalidLaterRecordDoesNotSupersede)
+{
+    std::vector<std::string> packets = {
+        makePacket("ELD001", 'A', "91", "91", "2330"),
+        makePacket("ELD001", 'D', "91", "91", "2330"), // entry_type 會被拒絕
+        makePacket("ELD001", 'A', "92", "91", "2330"), // 表頭與資料區中心不符
+        makePacket("ELD001", 'A', "93", "93", "2330"), // 區中心不在設定中
+    };
+    EXPECT_EQ(conflate(packets), (std::vector<uint8_t>{0, 0, 0, 0}));
+}
+
+TEST(PacketConflatorTest, RecordWithInvalidNumericFieldDoesNotSupersede)
+{
+    // 最新一筆的數值欄位無法解碼，handler 會拒絕；較舊的有效封包必須保留，最後狀態才不會退回更舊的值
+    std::string invalid = makePacket("ELD001", 'A', "91", "91", "2330");
+    auto *pkg = reinterpret_cast<FinancePackageMessage *>(invalid.data());
+    std::memcpy(pkg->ap_data.data.hcrtm01.margin_amount, "1 1", 3); // 中間有空白
+    std::vector<std::string> packets = {
+        makePacket("ELD001", 'A', "91", "91", "2330"),
+        makePacket("ELD001", 'A', "91", "91", "2330"),
+        invalid,
+    };
+    EXPECT_EQ(conflate(packets), (std::vector<uint8_t>{1, 0, 0}));
+
+    // 封包不含完整資料區時數值欄位無法驗證，同樣不取代
+    packets[2] = packets[1].substr(0, 200) + "\n";
+    EXPECT_EQ(conflate(packets), (std::vector<uint8_t>{1, 0, 0}));
+}
+
+TEST(PacketConflatorTest, ShortPacketsAreIgnored)
+{
+    std::string full = makePacket("ELD001", 'A', "91", "91", "2330");
+    std::vector<std::string> packets = {full.substr(0, 20) + "\n", full, "\r\n"};
+    EXPECT_EQ(conflate(packets), (std::vector<uint8_t>{0, 0, 0}));
+}
+
+TEST(PacketConflatorTest, ReusedAcrossBatches)
+{
+    PacketConflator conflator;
+    std::vector<uint8_t> skip;
+    std::vector<std::string> first = {
+        makePacket("ELD001", 'A', "91", "91", "2330"),
+        makePacket("ELD001", 'A', "91", "91", "2330"),
+    };
+    std::vector<TestSeg> segs;
+    for (const auto &p : first)
+        segs.push_back(TestSeg{p.data(), p.size()});
+    EXPECT_EQ(conflator.markSuperseded(segs.data(), segs.size(), skip), 1u);
+
+    // 前一批的 key 不可影響下一批
+    std::vector<std::string> second = {makePacket("ELD001", 'A', "91", "91", "2330")};
+    TestSeg seg{second[0].data(), second[0].size()};
+    EXPECT_EQ(conflator.markSuperseded(&seg, 1, skip), 0u);
+    EXPECT_EQ(skip, (std::vector<uint8_t>{0}));
+}
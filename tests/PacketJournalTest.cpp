@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+#include "infrastructure/storage/PacketJournal.hpp"
+#include "infrastructure/storage/MappedSummaryFile.hpp"
+#include "utils/Crc32c.hpp"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <sys/resource.h>
+#include <vector>
+
+using finance::domain::FinancePackageMessage;
+using finance::infrastructure::storage::MappedSummaryFile;
+using finance::infrastructure::storage::PacketJournal;
+using finance::utils::Crc32c;
+
+namespace
+{
+    std::string tempDir(const char *name)
+    {
+        auto path = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(path);
+        return path.string();
+    }
+
+    // 以空白填滿的封包，jrnseqn 右靠左補空白
+    std::string makePacket(uint64_t jrnseqn, const std::string &body)
+    {
+        FinancePackageMessage pkg;
+        std::memset(&pkg, ' ', sizeof(pkg));
+        std::string seq = std::to_string(jrnseqn);
+        std::memcpy(pkg.ap_data.jrnseqn + sizeof(pkg.ap_data.jrnseqn) - seq.size(), seq.data(), seq.size());
+        std::memcpy(pkg.ap_data.data.buffer, body.data(), body.size());
+        return std::string(reinterpret_cast<const char *>(&pkg), sizeof(pkg)) + "\n";
+    }
+
+    struct Replayed
+    {
+        uint64_t lsn;
+        uint64_t jrnseqn;
+        std::string data;
+    };
+
+    std::vector<Replayed> replayAll(const std::string &dir, uint64_t fromLsn = 1)
+    {
+        std::vector<Replayed> records;
+        PacketJournal::replay(dir, fromLsn, [&](const PacketJournal::RecordHeader &record, const char *data)
+                              { records.push_back({record.lsn, record.jrnseqn, std::string(data, record.length)}); });
+        return records;
+    }
+
+    std::vector<std::filesystem::path> segmentFiles(const std::string &dir)
+    {
+        std::vector<std::filesystem::path> files;
+        for (const auto &entry : std::filesystem::directory_iterator(dir))
+            files.push_back(entry.path());
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+} // namespace
+
+TEST(PacketJournalTest, Crc32cMatchesKnownVector)
+{
+    EXPECT_EQ(Crc32c::compute("123456789", 9), 0xE3069283u);
+    // 分段累加與一次計算相同
+    EXPECT_EQ(Crc32c::extend(Crc32c::compute("1234", 4), "56789", 5), 0xE3069283u);
+}
+
+TEST(PacketJournalTest, ReplaysCommittedPacketsInOrder)
+{
+    const auto dir = tempDir("packet_journal_roundtrip");
+    const auto before = std::chrono::system_clock::now();
+    {
+        auto journal = PacketJournal::open(dir, PacketJournal::Options{});
+        ASSERT_NE(journal, nullptr);
+        std::atomic<uint64_t> inFlight{0};
+        EXPECT_EQ(journal->append(makePacket(42, "first").data(), sizeof(FinancePackageMessage) + 1, &inFlight), 1u);
+        EXPECT_EQ(inFlight.load(), 1u);
+        EXPECT_EQ(journal->append("\r\n", 2), 2u); // 非完整封包：jrnseqn 為 0
+        const auto third = makePacket(43, "third");
+        EXPECT_EQ(journal->append(third.data(), third.size()), 3u);
+        journal->commit();
+        EXPECT_EQ(journal->durableLsn(), 3u);
+    }
+
+    auto records = replayAll(dir);
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records[0].lsn, 1u);
+    EXPECT_EQ(records[0].jrnseqn, 42u);
+    EXPECT_EQ(records[0].data, makePacket(42, "first"));
+    EXPECT_EQ(records[1].jrnseqn, 0u);
+    EXPECT_EQ(records[1].data, "\r\n");
+    EXPECT_EQ(records[2].lsn, 3u);
+    EXPECT_EQ(records[2].jrnseqn, 43u);
+
+    int64_t receivedNs = 0;
+    PacketJournal::replay(dir, 3, [&](const PacketJournal::RecordHeader &record, const char *)
+                          { receivedNs = record.receivedNs; });
+    EXPECT_GE(receivedNs, std::chrono::duration_cast<std::chrono::nanoseconds>(before.time_since_epoch()).count());
+
+    // 只重播指定 LSN 之後的記錄；重新開啟後 LSN 接續
+    EXPECT_EQ(replayAll(dir, 2).size(), 2u);
+    auto journal = PacketJournal::open(dir, PacketJournal::Options{});
+    EXPECT_EQ(journal->append("x\n", 2), 4u);
+    EXPECT_EQ(PacketJournal::open(dir + "_fresh", PacketJournal::Options{}, 100)->lastLsn(), 99u);
+}
+
+TEST(PacketJournalTest, RotatesSegmentsAndTruncatesCheckpointedOnes)
+{
+    const auto dir = tempDir("packet_journal_rotate");
+    PacketJournal::Options options;
+    options.segmentBytes = 4096;
+    options.fsync = false;
+    auto journal = PacketJournal::open(dir, options);
+    const auto packet = makePacket(1, "rotate");
+    for (int batch = 0; batch < 6; ++batch)
+    {
+        journal->append(packet.data(), packet.size());
+        journal->commit(); // 每批約 4 KB，每次提交後換段
+    }
+    EXPECT_EQ(segmentFiles(dir).size(), 6u);
+    EXPECT_EQ(replayAll(dir).size(), 6u);
+
+    // LSN 1..3 已 checkpoint：刪除第 1~3 段，目前寫入中的段保留
+    EXPECT_EQ(journal->truncateBefore(3), 3u);
+    auto records = replayAll(dir);
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records.front().lsn, 4u);
+    EXPECT_EQ(journal->truncateBefore(100), 2u);
+    EXPECT_EQ(segmentFiles(dir).size(), 1u);
+}
+
+TEST(PacketJournalTest, StopsAtTornTailAndContinuesAfterIt)
+{
+    const auto dir = tempDir("packet_journal_torn");
+    {
+        auto journal = PacketJournal::open(dir, PacketJournal::Options{});
+        for (uint64_t seq = 1; seq <= 4; ++seq)
+        {
+            const auto packet = makePacket(seq, "torn");
+            journal->append(packet.data(), packet.size());
+        }
+    }
+    auto files = segmentFiles(dir);
+    ASSERT_EQ(files.size(), 1u);
+    // 模擬最後一筆寫到一半：截掉結尾數個位元組；第 3 筆內容損毀
+    const auto recordSize = sizeof(PacketJournal::RecordHeader) + sizeof(FinancePackageMessage) + 1;
+    std::filesystem::resize_file(files[0], recordSize * 4 - 7);
+    {
+        std::fstream raw(files[0], std::ios::in | std::ios::out | std::ios::binary);
+        raw.seekp(static_cast<std::streamoff>(recordSize * 2 + sizeof(PacketJournal::RecordHeader) + 100));
+        raw.put('#');
+    }
+
+    auto records = replayAll(dir);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records.back().jrnseqn, 2u);
+
+    // 重新開啟後從最後一筆完整記錄之後接續，新段中的記錄可以重播
+    {
+        auto journal = PacketJournal::open(dir, PacketJournal::Options{});
+        EXPECT_EQ(journal->lastLsn(), 2u);
+        const auto packet = makePacket(5, "after");
+        EXPECT_EQ(journal->append(packet.data(), packet.size()), 3u);
+    }
+    records = replayAll(dir);
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records.back().lsn, 3u);
+    EXPECT_EQ(records.back().jrnseqn, 5u);
+}
+
+TEST(PacketJournalTest, FailedWriteIsNotDurableAndIsRewrittenInANewSegment)
+{
+    const auto dir = tempDir("packet_journal_write_failure");
+    PacketJournal::Options options;
+    options.commitInterval = std::chrono::seconds(10);
+    options.fsync = false;
+    auto journal = PacketJournal::open(dir, options);
+    const auto first = makePacket(1, "first");
+    journal->append(first.data(), first.size());
+    ASSERT_TRUE(journal->commit());
+    const auto recordSize = sizeof(PacketJournal::RecordHeader) + first.size();
+
+    // 以 RLIMIT_FSIZE 讓下一批只寫入一半：write 先回傳部分長度，之後以 EFBIG 失敗
+    rlimit original{};
+    ASSERT_EQ(::getrlimit(RLIMIT_FSIZE, &original), 0);
+    auto previousHandler = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit limited = original;
+    limited.rlim_cur = recordSize + 100;
+    ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &limited), 0);
+    const auto second = makePacket(2, "second");
+    journal->append(second.data(), second.size());
+    const bool committed = journal->commit();
+    ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &original), 0);
+    std::signal(SIGXFSZ, previousHandler);
+
+    EXPECT_FALSE(committed);
+    EXPECT_EQ(journal->durableLsn(), 1u);
+    // 殘缺的部分記錄已截掉，第一段只剩完整的第 1 筆
+    auto files = segmentFiles(dir);
+    ASSERT_EQ(files.size(), 1u);
+    EXPECT_EQ(std::filesystem::file_size(files[0]), recordSize);
+
+    // 限制解除後失敗的那批連同新記錄寫入新段，全部可依序重播
+    const auto third = makePacket(3, "third");
+    journal->append(third.data(), third.size());
+    ASSERT_TRUE(journal->commit());
+    EXPECT_EQ(journal->durableLsn(), 3u);
+    EXPECT_EQ(segmentFiles(dir).size(), 2u);
+    auto records = replayAll(dir);
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records[1].lsn, 2u);
+    EXPECT_EQ(records[1].data, second);
+    EXPECT_EQ(records[2].jrnseqn, 3u);
+}
+
+TEST(PacketJournalTest, SummaryFileRecordsCheckpointedLsn)
+{
+    auto path = std::filesystem::temp_directory_path() / "packet_journal_checkpoint.bin";
+    std::filesystem::remove(path);
+    {
+        auto file = MappedSummaryFile::open(path.string(), 1024);
+        EXPECT_EQ(file->appliedLsn(), 0u);
+        EXPECT_TRUE(file->checkpoint(1234));
+    }
+    EXPECT_EQ(MappedSummaryFile::open(path.string(), 1024)->appliedLsn(), 1234u);
+}
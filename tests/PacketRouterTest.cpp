@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "infrastructure/network/PacketRouter.hpp"
+#include "infrastructure/storage/RedisSummaryAdapter.hpp"
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace finance::domain;
+using finance::infrastructure::network::PacketRouter;
+using finance::infrastructure::storage::RedisSummaryAdapter;
+
+namespace
+{
+    FinancePackageMessage makeHcrtm01(const char *area, const char *stock)
+    {
+        FinancePackageMessage pkg;
+        std::memset(&pkg, ' ', sizeof(pkg));
+        std::memcpy(pkg.t_code, "ELD001", sizeof(pkg.t_code));
+        std::memcpy(pkg.ap_data.data.hcrtm01.area_center, area, std::strlen(area));
+        std::memcpy(pkg.ap_data.data.hcrtm01.stock_id, stock, std::strlen(stock));
+        return pkg;
+    }
+
+    FinancePackageMessage makeHcrtm05p(const char *broker, const char *stock)
+    {
+        FinancePackageMessage pkg;
+        std::memset(&pkg, ' ', sizeof(pkg));
+        std::memcpy(pkg.t_code, "ELD002", sizeof(pkg.t_code));
+        std::memcpy(pkg.ap_data.data.hcrtm05p.broker_id, broker, std::strlen(broker));
+        std::memcpy(pkg.ap_data.data.hcrtm05p.stock_id, stock, std::strlen(stock));
+        return pkg;
+    }
+
+    size_t shardOf(const FinancePackageMessage &pkg, size_t shards)
+    {
+        return PacketRouter::shardOf(reinterpret_cast<const char *>(&pkg), sizeof(pkg), shards);
+    }
+} // namespace
+
+TEST(PacketRouterTest, SameStockLandsOnSameShardAsCacheAndWriter)
+{
+    constexpr size_t SHARDS = 4;
+    for (const char *stock : {"2330", "2317", "0050", "00878", "6505"})
+    {
+        // 快取分區與 Redis 寫入通道都以 SummaryKey::shard() 分派
+        const size_t expected = SummaryKey::make("ALL", stock)->shard(SHARDS);
+        EXPECT_EQ(shardOf(makeHcrtm01("910", stock), SHARDS), expected) << stock;
+        EXPECT_EQ(shardOf(makeHcrtm01("920", stock), SHARDS), expected) << stock;
+        EXPECT_EQ(shardOf(makeHcrtm05p("91", stock), SHARDS), expected) << stock;
+    }
+}
+
+TEST(PacketRouterTest, UnroutablePacketsGoToFirstShard)
+{
+    auto unknown = makeHcrtm01("910", "2330");
+    std::memcpy(unknown.t_code, "ELD003", sizeof(unknown.t_code));
+    EXPECT_EQ(shardOf(unknown, 8), 0u);
+
+    auto blankStock = makeHcrtm01("910", "");
+    EXPECT_EQ(shardOf(blankStock, 8), 0u);
+
+    auto pkg = makeHcrtm01("910", "2330");
+    EXPECT_FALSE(PacketRouter::stockBitsOf(reinterpret_cast<const char *>(&pkg), 20).has_value()); // 過短 (截斷)
+    EXPECT_EQ(PacketRouter::shardOf("\r\n", 2, 8), 0u);                                             // keep alive
+    EXPECT_EQ(shardOf(pkg, 1), 0u);
+}
+
+TEST(PacketRouterTest, SpreadsStocksAcrossShards)
+{
+    constexpr size_t SHARDS = 4;
+    std::vector<size_t> perShard(SHARDS, 0);
+    for (int id = 1000; id < 3000; ++id)
+        ++perShard[shardOf(makeHcrtm01("910", std::to_string(id).c_str()), SHARDS)];
+    for (size_t count : perShard)
+    {
+        EXPECT_GT(count, 2000u / SHARDS / 2);
+        EXPECT_LT(count, 2000u / SHARDS * 2);
+    }
+}
+
+TEST(PacketRouterTest, PartitionedCacheKeepsEntriesApart)
+{
+    RedisSummaryAdapter repo(nullptr, 4);
+    ASSERT_EQ(repo.cachePartitionCount(), 4u);
+
+    std::set<SummaryData *> pointers;
+    for (const char *stock : {"2330", "2317", "0050", "00878", "6505", "1101"})
+    {
+        for (const char *area : {"910", "920"})
+        {
+            auto key = SummaryKey::make(area, stock);
+            SummaryData data;
+            data.stock_id = stock;
+            data.area_center = area;
+            data.h01_margin_amount = 1000;
+            ASSERT_TRUE(repo.setData(key->redisKey(), data).is_ok());
+
+            auto cached = repo.getData(*key);
+            ASSERT_TRUE(cached.is_ok());
+            EXPECT_EQ(cached.unwrap()->stock_id, stock);
+            EXPECT_EQ(cached.unwrap()->area_center, area);
+            EXPECT_EQ(repo.getData(key->redisKey()).unwrap(), cached.unwrap());
+            pointers.insert(cached.unwrap());
+        }
+    }
+    EXPECT_EQ(pointers.size(), 12u);
+    // 批次重算走訪所有分區
+    EXPECT_EQ(repo.recalculateAll(), 12u);
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include "infrastructure/storage/RedisPoolGate.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace finance::infrastructure::storage;
+using namespace std::chrono_literals;
+
+TEST(RedisPoolGateTest, LeasesUpToPoolSizeWithoutWaiting)
+{
+    RedisPoolGate gate;
+    gate.configure(2, 10ms);
+    {
+        auto a = gate.acquire();
+        auto b = gate.acquire();
+        EXPECT_TRUE(a.ok());
+        EXPECT_TRUE(b.ok());
+        EXPECT_EQ(gate.stats().inUse, 2u);
+    }
+    auto stats = gate.stats();
+    EXPECT_EQ(stats.inUse, 0u);
+    EXPECT_EQ(stats.acquired, 2u);
+    EXPECT_EQ(stats.waited, 0u);
+    EXPECT_EQ(stats.exhausted, 0u);
+}
+
+TEST(RedisPoolGateTest, CountsExhaustionAfterWaitTimeout)
+{
+    RedisPoolGate gate;
+    gate.configure(1, 5ms);
+    auto held = gate.acquire();
+    ASSERT_TRUE(held.ok());
+
+    auto denied = gate.acquire();
+    EXPECT_FALSE(denied.ok());
+
+    auto stats = gate.stats();
+    EXPECT_EQ(stats.inUse, 1u);
+    EXPECT_EQ(stats.waited, 1u);
+    EXPECT_EQ(stats.exhausted, 1u);
+    EXPECT_GE(stats.maxWaitUs, 5000u);
+}
+
+TEST(RedisPoolGateTest, WaiterGetsReleasedConnection)
+{
+    RedisPoolGate gate;
+    gate.configure(1, 0ms); // 無限等待
+    std::atomic<bool> acquired{false};
+    std::thread waiter;
+    {
+        auto held = gate.acquire();
+        waiter = std::thread([&]
+                             {
+            auto lease = gate.acquire();
+            acquired = lease.ok(); });
+        while (gate.stats().waited == 0)
+            std::this_thread::sleep_for(1ms);
+        EXPECT_FALSE(acquired.load());
+    }
+    waiter.join();
+    EXPECT_TRUE(acquired.load());
+
+    auto stats = gate.stats();
+    EXPECT_EQ(stats.inUse, 0u);
+    EXPECT_EQ(stats.exhausted, 0u);
+    EXPECT_GT(stats.totalWaitUs, 0u);
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include "infrastructure/storage/PacketJournal.hpp"
+#include "infrastructure/storage/RedisSummaryAdapter.hpp"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace finance::domain;
+using finance::infrastructure::config::AreaBranchProvider;
+using finance::infrastructure::storage::MappedSummaryFile;
+using finance::infrastructure::storage::PacketJournal;
+using finance::infrastructure::storage::RedisSummaryAdapter;
+using finance::infrastructure::tasks::RedisOperationType;
+using finance::infrastructure::tasks::RedisTask;
+
+namespace
+{
+    // 與同一測試執行檔中其他測試相同的區中心設定 (AreaBranchProvider 只載入一次，內容需一致)
+    void loadAreaConfig()
+    {
+        auto path = std::filesystem::temp_directory_path() / "redis_summary_adapter_area_branch.json";
+        std::ofstream(path) << R"({"91": ["9100", "9101"], "92": ["9200"]})";
+        AreaBranchProvider::loadFromFile(path.string());
+    }
+
+    // 與 RedisWorker::execute() 相同的方式把排隊中的任務交給 syncBatch()
+    void drainLikeWorker(RedisSummaryAdapter &repo, std::vector<RedisTask> &queued)
+    {
+        std::vector<std::pair<std::string, const SummaryData *>> syncs;
+        std::vector<std::string> updates;
+        for (auto &task : queued)
+        {
+            if (task.operation == RedisOperationType::SYNC_SUMMARY_DATA)
+                syncs.emplace_back(task.resolveKey(), &task.summary_data_payload.value());
+            else
+                updates.push_back(task.resolveKey());
+        }
+        repo.syncBatch(syncs, updates, 0);
+        queued.clear();
+    }
+
+    // 模擬 handler 處理一個封包：修改快取項目後送出同步任務
+    void handlerWrite(RedisSummaryAdapter &repo, SummaryKey key, int64_t marginAmount)
+    {
+        auto *entry = repo.getData(key).unwrap();
+        entry->stock_id = key.stock();
+        entry->area_center = key.area();
+        entry->belong_branches = AreaBranchProvider::getBranchListFromArea(key);
+        entry->h01_margin_amount = marginAmount;
+        entry->calculate_availables();
+        repo.sync_detached(key, *entry);
+    }
+
+    int64_t persistedMarginAmount(const std::string &path, SummaryKey key)
+    {
+        int64_t amount = -1;
+        MappedSummaryFile::open(path, 1024)->forEach([&](SummaryKey stored, const SummarySnapshot &record)
+                                                     {
+                                                         if (stored == key)
+                                                             amount = record.h01_margin_amount; });
+        return amount;
+    }
+} // namespace
+
+TEST(RedisSummaryAdapterTest, QueuedSyncTasksDoNotOverwriteNewerHandlerWrites)
+{
+    loadAreaConfig();
+    RedisSummaryAdapter repo(nullptr, 2);
+    std::vector<RedisTask> queued;
+    repo.setTaskPoster([&](RedisTask task)
+                       { queued.push_back(std::move(task)); });
+
+    // handler 路徑：同一 key 連續兩個封包，第一個的任務仍在佇列中
+    const auto key = *SummaryKey::make("91", "2330");
+    auto *entry = repo.getData(key).unwrap();
+    entry->stock_id = "2330";
+    entry->area_center = "91";
+    entry->belong_branches = AreaBranchProvider::getBranchListFromArea(key);
+    entry->h01_margin_amount = 1000;
+    entry->calculate_availables();
+    repo.sync_detached(key, *entry);
+    repo.update_detached(key);
+
+    entry->h01_margin_amount = 2000;
+    entry->calculate_availables();
+    repo.sync_detached(key, *entry);
+    ASSERT_EQ(queued.size(), 3u);
+    EXPECT_EQ(queued.front().summary_data_payload->h01_margin_amount, 1000);
+
+    // handler 發佈時已可讀到最新值，worker 處理較舊的副本後也不會倒退
+    ASSERT_TRUE(repo.snapshot(key).has_value());
+    EXPECT_EQ(repo.snapshot(key)->h01_margin_amount, 2000);
+    drainLikeWorker(repo, queued);
+    EXPECT_EQ(repo.getData(key).unwrap(), entry);
+    EXPECT_EQ(entry->h01_margin_amount, 2000);
+    EXPECT_EQ(repo.snapshot(key)->h01_margin_amount, 2000);
+    EXPECT_EQ(repo.snapshot(key)->margin_available_qty, entry->margin_available_qty);
+}
+
+TEST(RedisSummaryAdapterTest, CacheFileKeepsTheOwnersLatestCopy)
+{
+    loadAreaConfig();
+    const auto path = (std::filesystem::temp_directory_path() / "redis_summary_adapter_owner.bin").string();
+    std::filesystem::remove(path);
+    const auto key = *SummaryKey::make("91", "2330");
+    {
+        RedisSummaryAdapter repo(nullptr, 2);
+        ASSERT_EQ(repo.attachPersistentCache(MappedSummaryFile::open(path, 1024)), 0u);
+        std::vector<RedisTask> queued;
+        repo.setTaskPoster([&](RedisTask task)
+                           { queued.push_back(std::move(task)); });
+
+        handlerWrite(repo, key, 1000);
+        handlerWrite(repo, key, 2000);
+        // worker 處理排隊中的舊副本時不寫入快取檔
+        drainLikeWorker(repo, queued);
+    }
+    EXPECT_EQ(persistedMarginAmount(path, key), 2000);
+}
+
+TEST(RedisSummaryAdapterTest, CheckpointWithQueuedSyncTasksCoversHandlerWrites)
+{
+    loadAreaConfig();
+    const auto path = (std::filesystem::temp_directory_path() / "redis_summary_adapter_checkpoint.bin").string();
+    const auto dir = (std::filesystem::temp_directory_path() / "redis_summary_adapter_journal").string();
+    std::filesystem::remove(path);
+    std::filesystem::remove_all(dir);
+    const auto key = *SummaryKey::make("91", "2330");
+    {
+        RedisSummaryAdapter repo(nullptr, 2);
+        repo.attachPersistentCache(MappedSummaryFile::open(path, 1024));
+        std::vector<RedisTask> queued;
+        repo.setTaskPoster([&](RedisTask task)
+                           { queued.push_back(std::move(task)); });
+        auto journal = PacketJournal::open(dir, PacketJournal::Options{});
+
+        // 與 TcpServiceAdapter::handlePacket() 相同：先寫日誌，handler 套用後清除進行中 LSN
+        std::atomic<uint64_t> inFlight{0};
+        for (int64_t amount : {1000, 2000})
+        {
+            journal->append("packet\n", 7, &inFlight);
+            handlerWrite(repo, key, amount);
+            inFlight.store(0, std::memory_order_release);
+        }
+        ASSERT_EQ(queued.size(), 2u);
+
+        // 同步任務仍在佇列中就 checkpoint：水位內的封包已由 handler 寫入快取檔，不依賴 worker
+        const uint64_t watermark = journal->lastLsn();
+        ASSERT_EQ(watermark, 2u);
+        ASSERT_TRUE(repo.checkpoint(watermark));
+        EXPECT_EQ(journal->truncateBefore(watermark), 0u); // 目前寫入中的段保留
+        drainLikeWorker(repo, queued);
+    }
+
+    // 重啟：快取檔已含水位內的所有結果，水位之後沒有需要重播的封包
+    EXPECT_EQ(MappedSummaryFile::open(path, 1024)->appliedLsn(), 2u);
+    EXPECT_EQ(persistedMarginAmount(path, key), 2000);
+    size_t replayed = 0;
+    PacketJournal::replay(dir, 3, [&](const PacketJournal::RecordHeader &, const char *)
+                          { ++replayed; });
+    EXPECT_EQ(replayed, 0u);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "infrastructure/tasks/RedisWorkerPool.hpp"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace finance::domain;
+using namespace finance::infrastructure::tasks;
+using namespace std::chrono_literals;
+
+namespace
+{
+    // 記錄每個通道寫入順序的假 repository
+    class LaneRecordingRepository : public IFinanceRepository<SummaryData, ErrorResult>
+    {
+    public:
+        Result<void, ErrorResult> init() override { return Result<void, ErrorResult>::Ok(); }
+        Result<void, ErrorResult> loadAll() override { return Result<void, ErrorResult>::Ok(); }
+        Result<SummaryData *, ErrorResult> getData(const std::string &) override
+        {
+            return Result<SummaryData *, ErrorResult>::Err(ErrorResult{ErrorCode::InternalError, "unused"});
+        }
+        Result<void, ErrorResult> setData(const std::string &, const SummaryData &) override { return Result<void, ErrorResult>::Ok(); }
+        Result<void, ErrorResult> sync(const std::string &, const SummaryData *) override { return Result<void, ErrorResult>::Ok(); }
+        Result<void, ErrorResult> update(const std::string &) override { return Result<void, ErrorResult>::Ok(); }
+        bool remove(const std::string &) override { return true; }
+        std::future<Result<void, ErrorResult>> sync_async(const std::string &, const SummaryData &) override { return {}; }
+        std::future<Result<void, ErrorResult>> update_async(const std::string &) override { return {}; }
+
+        std::vector<Result<void, ErrorResult>> syncBatch(const std::vector<std::pair<std::string, const SummaryData *>> &items,
+                                                         const std::vector<std::string> &updateKeys,
+                                                         size_t lane) override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto &[key, data] : items)
+            {
+                laneOfKey[key].insert(lane);
+                writes[key].push_back(data->margin_available_amount);
+            }
+            for (const auto &stock : updateKeys)
+                laneOfKey["update:" + stock].insert(lane);
+            return std::vector<Result<void, ErrorResult>>(items.size() + updateKeys.size(), Result<void, ErrorResult>::Ok());
+        }
+
+        std::mutex mutex_;
+        std::map<std::string, std::set<size_t>> laneOfKey;
+        std::map<std::string, std::vector<int64_t>> writes;
+    };
+
+    RedisTask syncTask(const std::string &key, int64_t value)
+    {
+        SummaryData data;
+        data.margin_available_amount = value;
+        return RedisTask(RedisOperationType::SYNC_SUMMARY_DATA, key, data, nullptr);
+    }
+}
+
+TEST(RedisWorkerPoolTest, RoutesSyncAndUpdateOfSameStockToSameLane)
+{
+    auto repo = std::make_shared<LaneRecordingRepository>();
+    RedisWorkerPool pool(repo, 8);
+
+    RedisTask update(RedisOperationType::UPDATE_COMPANY_SUMMARY, "2330", nullptr);
+    size_t lane = pool.laneFor(update);
+    EXPECT_EQ(pool.laneFor(syncTask("summary:A01:2330", 0)), lane);
+    EXPECT_EQ(pool.laneFor(syncTask("summary:A02:2330", 0)), lane);
+    EXPECT_EQ(RedisWorkerPool::routingKey(syncTask("summary:A01:2330", 0)), "2330");
+
+    // 不同股票應分散到多個通道
+    std::set<size_t> lanes;
+    for (int stock = 1000; stock < 1100; ++stock)
+        lanes.insert(pool.laneFor(syncTask("summary:A01:" + std::to_string(stock), 0)));
+    EXPECT_GT(lanes.size(), 1u);
+}
+
+TEST(RedisWorkerPoolTest, PreservesPerKeyOrderAcrossWorkers)
+{
+    auto repo = std::make_shared<LaneRecordingRepository>();
+    // 小批次、無閒置等待，讓同一 key 被寫入多次
+    RedisWorkerPool pool(repo, 4, WriteBehindBuffer::Options{1ms, 2, 0us});
+    pool.start();
+
+    std::vector<std::future<Result<void, ErrorResult>>> futures;
+    for (int i = 1; i <= 300; ++i)
+    {
+        for (int stock = 0; stock < 10; ++stock)
+            futures.push_back(pool.submit_task(syncTask("summary:A01:" + std::to_string(2300 + stock), i)));
+    }
+    for (auto &f : futures)
+        EXPECT_TRUE(f.get().is_ok());
+    pool.stop();
+
+    for (const auto &[key, lanes] : repo->laneOfKey)
+        EXPECT_EQ(lanes.size(), 1u) << key;
+    for (const auto &[key, values] : repo->writes)
+    {
+        ASSERT_FALSE(values.empty());
+        EXPECT_TRUE(std::is_sorted(values.begin(), values.end())) << key;
+        EXPECT_EQ(values.back(), 300) << key;
+    }
+}
+
+TEST(RedisWorkerPoolTest, ExposesPerWorkerQueueDepth)
+{
+    auto repo = std::make_shared<LaneRecordingRepository>();
+    RedisWorkerPool pool(repo, 3, WriteBehindBuffer::Options{10000ms, 512, 10000000us});
+    EXPECT_EQ(pool.size(), 3u);
+
+    auto task = syncTask("summary:A01:2330", 1);
+    size_t lane = pool.laneFor(task);
+    pool.submit_task(std::move(task));
+    pool.submit_task(syncTask("summary:A02:2330", 1));
+
+    auto depths = pool.queueDepths();
+    ASSERT_EQ(depths.size(), 3u);
+    EXPECT_EQ(depths[lane], 2u);
+    pool.start();
+    pool.stop(); // 停止時寫出剩餘資料
+    EXPECT_EQ(pool.queueDepths()[lane], 0u);
+}
+
+TEST(RedisWorkerPoolTest, ZeroWorkersFallsBackToOne)
+{
+    auto repo = std::make_shared<LaneRecordingRepository>();
+    RedisWorkerPool pool(repo, 0);
+    EXPECT_EQ(pool.size(), 1u);
+}
@@ -7,6 +7,7 @@
 #include <cstring>   // For memcpy, memcmp, memset
 #include <numeric>   // For std::iota
 #include <algorithm> // For std::min
+#include <chrono>
 #include <loguru.hpp>
 
 // Make the namespace accessible
@@ -45,8 +46,8 @@ public:
 
 // Helper to simulate producer writing data.
 // It handles potential segmentation from writablePtr.
-template <size_t CAP> // Templatize the helper function
-void producer_write_data(RingBuffer<CAP> &rb, const char *data, size_t len)
+template <size_t CAP, typename Storage> // Templatize the helper function
+void producer_write_data(RingBuffer<CAP, Storage> &rb, const char *data, size_t len)
 {
     size_t current_written = 0;
     while (current_written < len)
@@ -74,8 +75,8 @@ void producer_write_data(RingBuffer<CAP> &rb, const char *data, size_t len)
     }
 }
 
-template <size_t CAP>
-std::string consumer_read_data(RingBuffer<CAP> &rb, size_t len_to_read)
+template <size_t CAP, typename Storage>
+std::string consumer_read_data(RingBuffer<CAP, Storage> &rb, size_t len_to_read)
 {
     if (len_to_read == 0)
     { // Handle reading 0 bytes explicitly
@@ -493,6 +494,168 @@ TEST_F(RingBufferTest16, WaitForSpace_ImmediateReturnIfSpace)
     EXPECT_EQ(rb_.free_space(), 15);
 }
 
+TEST_F(RingBufferTest16, GetNextPackets_ReturnsAllCompletePackets)
+{
+    const std::string data = "ab\ncde\nf\ngh";
+    producer_write_data(rb_, data.data(), data.length());
+
+    RingBuffer<16>::PacketSeg segs[8];
+    size_t batchBytes = 0;
+    size_t count = rb_.getNextPackets(segs, 8, batchBytes);
+
+    ASSERT_EQ(count, 3u);
+    EXPECT_EQ(std::string(segs[0].ptr1, segs[0].len1), "ab\n");
+    EXPECT_EQ(std::string(segs[1].ptr1, segs[1].len1), "cde\n");
+    EXPECT_EQ(std::string(segs[2].ptr1, segs[2].len1), "f\n");
+    EXPECT_EQ(batchBytes, 9u);
+
+    rb_.dequeueBatch(batchBytes);
+    EXPECT_EQ(rb_.size(), 2u); // "gh" 尚未成包
+    EXPECT_EQ(rb_.getNextPackets(segs, 8, batchBytes), 0u);
+    EXPECT_EQ(batchBytes, 0u);
+}
+
+TEST_F(RingBufferTest16, GetNextPackets_RespectsMaxCount)
+{
+    const std::string data = "a\nb\nc\nd\n";
+    producer_write_data(rb_, data.data(), data.length());
+
+    RingBuffer<16>::PacketSeg segs[2];
+    size_t batchBytes = 0;
+    ASSERT_EQ(rb_.getNextPackets(segs, 2, batchBytes), 2u);
+    EXPECT_EQ(batchBytes, 4u);
+    rb_.dequeueBatch(batchBytes);
+
+    ASSERT_EQ(rb_.getNextPackets(segs, 2, batchBytes), 2u);
+    EXPECT_EQ(std::string(segs[0].ptr1, segs[0].len1), "c\n");
+    EXPECT_EQ(std::string(segs[1].ptr1, segs[1].len1), "d\n");
+    rb_.dequeueBatch(batchBytes);
+    EXPECT_TRUE(rb_.empty());
+}
+
+TEST_F(RingBufferTest16, GetNextPackets_PacketAcrossBoundary)
+{
+    producer_write_data(rb_, "JUNKJUNKJUNK", 12);
+    consumer_read_data(rb_, 12);
+    ASSERT_EQ(rb_.getHead(), 12);
+
+    // "xy\n" 位於 [12..14]，"abcd\n" 從 [15] 跨界到 [0..3]
+    const std::string data = "xy\nabcd\n";
+    producer_write_data(rb_, data.data(), data.length());
+
+    RingBuffer<16>::PacketSeg segs[4];
+    size_t batchBytes = 0;
+    ASSERT_EQ(rb_.getNextPackets(segs, 4, batchBytes), 2u);
+    EXPECT_EQ(std::string(segs[0].ptr1, segs[0].len1), "xy\n");
+    EXPECT_EQ(segs[0].len2, 0u);
+    EXPECT_EQ(segs[1].totalLen(), 5u);
+    EXPECT_EQ(std::string(segs[1].ptr1, segs[1].len1) + std::string(segs[1].ptr2, segs[1].len2), "abcd\n");
+    EXPECT_EQ(batchBytes, data.length());
+
+    rb_.dequeueBatch(batchBytes);
+    EXPECT_TRUE(rb_.empty());
+}
+
+TEST_F(RingBufferTest16, GetNextPackets_PartialPacketCompletedAcrossBoundary)
+{
+    producer_write_data(rb_, "JUNKJUNKJUNK", 12);
+    consumer_read_data(rb_, 12);
+
+    // 不完整封包先到，完成後跨越環界
+    RingBuffer<16>::PacketSeg segs[4];
+    size_t batchBytes = 0;
+    producer_write_data(rb_, "abc", 3);
+    EXPECT_EQ(rb_.getNextPackets(segs, 4, batchBytes), 0u);
+    producer_write_data(rb_, "defg\n", 5);
+
+    ASSERT_EQ(rb_.getNextPackets(segs, 4, batchBytes), 1u);
+    EXPECT_EQ(segs[0].len1, 4u);
+    EXPECT_EQ(std::string(segs[0].ptr1, segs[0].len1) + std::string(segs[0].ptr2, segs[0].len2), "abcdefg\n");
+    rb_.dequeueBatch(batchBytes);
+    EXPECT_TRUE(rb_.empty());
+}
+
+TEST_F(RingBufferTest16, DequeueBatchTooLargeThrowsUnderflowError)
+{
+    producer_write_data(rb_, "a\nb", 3);
+    RingBuffer<16>::PacketSeg segs[4];
+    size_t batchBytes = 0;
+    ASSERT_EQ(rb_.getNextPackets(segs, 4, batchBytes), 1u);
+    EXPECT_THROW(rb_.dequeueBatch(4), std::underflow_error);
+    rb_.dequeueBatch(0);
+    EXPECT_EQ(rb_.size(), 3u);
+}
+
+TEST_F(RingBufferTest16, WaitForNewData_TimesOutWithoutData)
+{
+    for (WaitMode mode : {WaitMode::BusySpin, WaitMode::SpinYield, WaitMode::SpinPark})
+    {
+        rb_.setWaitPolicy(WaitPolicy{mode, 10, 2, 5});
+        EXPECT_FALSE(rb_.waitForNewData()) << waitModeName(mode);
+    }
+}
+
+TEST_F(RingBufferTest16, WaitForNewData_IgnoresPartialPacketAlreadySeen)
+{
+    rb_.setWaitPolicy(WaitPolicy{WaitMode::SpinPark, 10, 2, 5});
+    producer_write_data(rb_, "part", 4);
+
+    RingBuffer<16>::PacketSeg segs[2];
+    size_t batchBytes = 0;
+    ASSERT_EQ(rb_.getNextPackets(segs, 2, batchBytes), 0u);
+    // 不完整封包已看過，沒有新資料時應逾時而非立即返回
+    EXPECT_FALSE(rb_.waitForNewData());
+    producer_write_data(rb_, "\n", 1);
+    EXPECT_TRUE(rb_.waitForNewData());
+}
+
+TEST_F(RingBufferTest16, SpinPark_ProducerWakesParkedConsumer)
+{
+    // 休眠上限設得很長，只有 producer 的喚醒能讓 consumer 及時返回
+    rb_.setWaitPolicy(WaitPolicy{WaitMode::SpinPark, 0, 0, 10000});
+
+    std::thread producer([this]
+                         {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        producer_write_data(rb_, "x\n", 2); });
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(rb_.waitForNewData());
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    producer.join();
+    EXPECT_LT(elapsed, std::chrono::seconds(5));
+    EXPECT_EQ(rb_.size(), 2u);
+}
+
+TEST_F(RingBufferTest16, SpinPark_WakeConsumerReleasesParkedConsumer)
+{
+    rb_.setWaitPolicy(WaitPolicy{WaitMode::SpinPark, 0, 0, 10000});
+
+    std::atomic<bool> returned{false};
+    std::thread consumer([&]
+                         {
+        rb_.waitForNewData();
+        returned = true; });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto start = std::chrono::steady_clock::now();
+    while (!returned && std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+    {
+        rb_.wakeConsumer();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    consumer.join();
+    EXPECT_TRUE(returned);
+}
+
+TEST(WaitStrategyTest, WaitModeFromString)
+{
+    EXPECT_EQ(waitModeFromString("busy_spin"), WaitMode::BusySpin);
+    EXPECT_EQ(waitModeFromString("spin_yield"), WaitMode::SpinYield);
+    EXPECT_EQ(waitModeFromString("spin_park"), WaitMode::SpinPark);
+    EXPECT_FALSE(waitModeFromString("sleep").has_value());
+}
+
 template <size_t CAP_SPSC_PARAM> // Renamed template parameter
 class RingBufferSPSCTest : public ::testing::Test
 {
@@ -578,6 +741,171 @@ TEST_F(RingBufferSPSCTest64, ProducerConsumerFullCycle)
     EXPECT_EQ(rb_spsc_.size(), 0);
 }
 
+// ============================================================================
+// MirroredRingBuffer: 同一 memfd 映射兩次，跨環界的封包仍是單段連續記憶體
+// ============================================================================
+
+// 64KB 為 4K/16K/64K 頁大小的整數倍
+static constexpr size_t MIRRORED_CAP = 64 * 1024;
+
+class MirroredRingBufferTest : public ::testing::Test
+{
+protected:
+    MirroredRingBuffer<MIRRORED_CAP> rb_;
+
+    // 將 head/tail 推進到指定位置 (緩衝區保持為空)
+    void advanceTo(size_t position)
+    {
+        std::string junk(position, 'J');
+        producer_write_data(rb_, junk.data(), junk.size());
+        rb_.dequeue(position);
+        ASSERT_TRUE(rb_.empty());
+    }
+};
+
+TEST_F(MirroredRingBufferTest, IsMirrored)
+{
+    EXPECT_TRUE(MirroredRingBuffer<MIRRORED_CAP>::isMirrored());
+    EXPECT_FALSE(RingBuffer<16>::isMirrored());
+    // 鏡像儲存的封包型別只有單段，兩段式 SplitPacketSeg 只留給一般儲存
+    static_assert(std::is_same_v<MirroredRingBuffer<MIRRORED_CAP>::PacketSeg, PacketSpan>);
+    static_assert(std::is_same_v<RingBuffer<16>::PacketSeg, SplitPacketSeg>);
+    EXPECT_EQ(rb_.capacity(), MIRRORED_CAP);
+    EXPECT_EQ(rb_.free_space(), MIRRORED_CAP - 1);
+}
+
+TEST_F(MirroredRingBufferTest, WritablePtrSpansBoundary)
+{
+    advanceTo(MIRRORED_CAP - 10);
+
+    size_t maxLen = 0;
+    char *ptr = rb_.writablePtr(maxLen);
+    // 一般 RingBuffer 只能寫到環界 (10 bytes)，鏡像儲存可一次寫入全部剩餘空間
+    EXPECT_EQ(maxLen, MIRRORED_CAP - 1);
+
+    const std::string data = "0123456789ABCDEFGHIJ";
+    memcpy(ptr, data.data(), data.size());
+    rb_.enqueue(data.size());
+
+    size_t len1 = 0;
+    auto first = rb_.peekFirst(len1);
+    EXPECT_EQ(len1, data.size());
+    EXPECT_EQ(std::string(first.first, len1), data);
+    EXPECT_EQ(rb_.peekSecond(len1).second, 0u);
+}
+
+TEST_F(MirroredRingBufferTest, GetNextPacketAcrossBoundaryIsSingleSegment)
+{
+    advanceTo(MIRRORED_CAP - 4);
+
+    const std::string packet = "WRAPPED_PACKET\n";
+    producer_write_data(rb_, packet.data(), packet.size());
+
+    auto seg = rb_.getNextPacket();
+    ASSERT_TRUE(seg.has_value());
+    EXPECT_EQ(seg->len, packet.size());
+    EXPECT_EQ(std::string(seg->ptr, seg->len), packet);
+
+    MirroredRingBuffer<MIRRORED_CAP>::PacketRef ref;
+    bool isCross = true;
+    ASSERT_TRUE(rb_.findPacket(ref, isCross));
+    EXPECT_FALSE(isCross);
+    EXPECT_EQ(ref.length, packet.size());
+
+    rb_.dequeue(seg->len);
+    EXPECT_TRUE(rb_.empty());
+}
+
+TEST_F(MirroredRingBufferTest, GetNextPacketsFramesLargeRecvInOneCall)
+{
+    // 模擬一次 64KB recv：大量封包加上最後一個尚未收齊的封包
+    std::string data;
+    size_t packets = 0;
+    while (data.size() + 64 < MIRRORED_CAP - 1024)
+    {
+        data += "PKT" + std::to_string(packets) + std::string(packets % 50, 'x') + "\n";
+        ++packets;
+    }
+    data += "PARTIAL";
+    producer_write_data(rb_, data.data(), data.size());
+
+    std::vector<MirroredRingBuffer<MIRRORED_CAP>::PacketSeg> segs(packets + 1);
+    size_t batchBytes = 0;
+    ASSERT_EQ(rb_.getNextPackets(segs.data(), segs.size(), batchBytes), packets);
+    EXPECT_EQ(batchBytes, data.size() - 7);
+    EXPECT_EQ(std::string(segs[0].ptr, segs[0].len), "PKT0\n");
+    rb_.dequeueBatch(batchBytes);
+    EXPECT_EQ(rb_.size(), 7u);
+}
+
+TEST_F(MirroredRingBufferTest, GetNextPacketsResumesPartialPacketAcrossCalls)
+{
+    advanceTo(MIRRORED_CAP - 100);
+
+    // 大封包分三次到達，且跨越環界
+    std::string big(300, 'B');
+    big.back() = '\n';
+    MirroredRingBuffer<MIRRORED_CAP>::PacketSeg segs[4];
+    size_t batchBytes = 0;
+
+    producer_write_data(rb_, big.data(), 120);
+    EXPECT_EQ(rb_.getNextPackets(segs, 4, batchBytes), 0u);
+    producer_write_data(rb_, big.data() + 120, 120);
+    EXPECT_EQ(rb_.getNextPackets(segs, 4, batchBytes), 0u);
+    producer_write_data(rb_, big.data() + 240, 60);
+    producer_write_data(rb_, "n\n", 2);
+
+    ASSERT_EQ(rb_.getNextPackets(segs, 4, batchBytes), 2u);
+    EXPECT_EQ(std::string(segs[0].ptr, segs[0].len), big);
+    EXPECT_EQ(std::string(segs[1].ptr, segs[1].len), "n\n");
+
+    // 尚未 dequeueBatch 時再次呼叫，必須重新取得同一批封包
+    ASSERT_EQ(rb_.getNextPackets(segs, 1, batchBytes), 1u);
+    EXPECT_EQ(segs[0].len, big.size());
+    rb_.dequeueBatch(batchBytes);
+    ASSERT_EQ(rb_.getNextPackets(segs, 4, batchBytes), 1u);
+    EXPECT_EQ(std::string(segs[0].ptr, segs[0].len), "n\n");
+    rb_.dequeueBatch(batchBytes);
+    EXPECT_TRUE(rb_.empty());
+}
+
+TEST_F(MirroredRingBufferTest, ProducerConsumerFullCycle)
+{
+    std::vector<std::string> messages;
+    const int numMsgs = 5000;
+    for (int i = 0; i < numMsgs; ++i)
+    {
+        messages.push_back("Msg:" + std::to_string(i) + std::string(i % 97 + 5, (char)('A' + i % 26)) + "\n");
+    }
+
+    std::thread producer([&]
+                         {
+        for (const auto &msg : messages)
+            producer_write_data(rb_, msg.data(), msg.size()); });
+
+    std::vector<std::string> received;
+    received.reserve(numMsgs);
+    while (received.size() < messages.size())
+    {
+        auto seg = rb_.getNextPacket();
+        if (!seg)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        received.emplace_back(seg->ptr, seg->len);
+        rb_.dequeue(seg->len);
+    }
+    producer.join();
+
+    ASSERT_EQ(received.size(), messages.size());
+    for (size_t i = 0; i < messages.size(); ++i)
+    {
+        EXPECT_EQ(received[i], messages[i]) << "Mismatch at message index " << i;
+    }
+    EXPECT_TRUE(rb_.empty());
+}
+
 // Example main function to run tests
 int main(int argc, char **argv)
 {
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "infrastructure/config/StockUniverse.hpp"
+#include "infrastructure/storage/RedisSummaryAdapter.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace finance::domain;
+using finance::infrastructure::config::AreaBranchProvider;
+using finance::infrastructure::config::StockUniverse;
+using finance::infrastructure::storage::RedisSummaryAdapter;
+
+namespace
+{
+    // 與同一測試執行檔中其他測試相同的區中心設定 (AreaBranchProvider 只載入一次，內容需一致)
+    void loadAreaConfig()
+    {
+        auto path = std::filesystem::temp_directory_path() / "stock_universe_area_branch.json";
+        std::ofstream(path) << R"({"91": ["9100", "9101"], "92": ["9200"]})";
+        AreaBranchProvider::loadFromFile(path.string());
+    }
+
+    uint64_t stockBits(const std::string &stock)
+    {
+        return *SummaryKey::stockBitsOf(stock);
+    }
+} // namespace
+
+TEST(StockUniverseTest, ParsesOneStockPerLine)
+{
+    std::istringstream in("# 上市股票\n2330\n  2317  \r\n\n00632R\t# ETF\n2330\n1234567\n");
+    auto universe = StockUniverse::parse(in);
+    EXPECT_EQ(universe.stockIds(), (std::vector<std::string>{"2330", "2317", "00632R"})); // 重複與過長的代號略過
+    EXPECT_TRUE(universe.mayContain(stockBits("00632R")));
+    EXPECT_FALSE(StockUniverse::loadFromFile("/nonexistent/stock_universe.txt").has_value());
+}
+
+TEST(StockUniverseTest, BloomFilterHasNoFalseNegativesAndFewFalsePositives)
+{
+    std::vector<std::string> listed;
+    for (int id = 1000; id < 3000; ++id)
+        listed.push_back(std::to_string(id));
+    StockUniverse universe(listed);
+
+    for (const auto &stock : listed)
+        ASSERT_TRUE(universe.mayContain(stockBits(stock))) << stock;
+
+    size_t falsePositives = 0;
+    for (int id = 100000; id < 120000; ++id)
+        falsePositives += universe.mayContain(stockBits(std::to_string(id)));
+    EXPECT_LT(falsePositives, 20000u * 3 / 100);
+}
+
+TEST(StockUniverseTest, PreallocatesEveryAreaAndRejectsUnknownStocks)
+{
+    loadAreaConfig();
+    RedisSummaryAdapter repo(nullptr, 2);
+
+    // 已載入的項目保留原值
+    SummaryData loaded;
+    loaded.stock_id = "2330";
+    loaded.area_center = "91";
+    loaded.belong_branches = AreaBranchProvider::getBranchListFromArea("91");
+    loaded.h01_margin_amount = 500;
+    ASSERT_TRUE(repo.setData("summary:91:2330", loaded).is_ok());
+
+    StockUniverse universe(std::vector<std::string>{"2330", "2317", "00632R"});
+    const auto &areas = AreaBranchProvider::getBackofficeIds();
+    EXPECT_EQ(repo.preallocate(universe), universe.size() * (areas.size() + 1) - 1);
+
+    for (const auto &stock : universe.stockIds())
+    {
+        for (const std::string area : {"91", "92", "ALL"})
+        {
+            auto key = *SummaryKey::make(area, stock);
+            auto snapshot = repo.snapshot(key);
+            ASSERT_TRUE(snapshot.has_value()) << area << ":" << stock;
+            auto data = repo.getData(key);
+            ASSERT_TRUE(data.is_ok());
+            EXPECT_EQ(data.unwrap()->stock_id, stock);
+            EXPECT_EQ(data.unwrap()->area_center, area);
+            EXPECT_FALSE(data.unwrap()->belong_branches.empty());
+        }
+    }
+    EXPECT_EQ(repo.getData(*SummaryKey::make("91", "2330")).unwrap()->h01_margin_amount, 500);
+
+    auto unknown = repo.getData(*SummaryKey::make("91", "9999"));
+    ASSERT_TRUE(unknown.is_err());
+    EXPECT_EQ(unknown.unwrap_err().code, ErrorCode::UnknownStock);
+    EXPECT_FALSE(repo.snapshot(*SummaryKey::make("91", "9999")).has_value());
+}
@@ -221,8 +221,8 @@ TEST_F(SummaryDataTest, StringAndVectorMembers)
 {
     summary.stock_id = "0050";
     summary.area_center = "01";
-    summary.belong_branches.push_back("BranchX");
-    summary.belong_branches.push_back("BranchY");
+    static const std::vector<std::string> branches = {"BranchX", "BranchY"};
+    summary.belong_branches = BranchListRef(&branches);
 
     EXPECT_EQ(summary.stock_id, "0050");
     EXPECT_EQ(summary.area_center, "01");
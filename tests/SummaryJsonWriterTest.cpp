@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "infrastructure/storage/SummaryJsonWriter.hpp"
+#include "infrastructure/config/AreaBranchProvider.hpp"
+#include <nlohmann/json.hpp>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using finance::domain::SummaryData;
+using finance::infrastructure::config::AreaBranchProvider;
+using finance::infrastructure::storage::SummaryJsonWriter;
+
+namespace
+{
+    // 與 RedisSummaryAdapter 原本的 nlohmann 序列化相同
+    std::string domJson(const SummaryData &data)
+    {
+        nlohmann::json j;
+        j["stock_id"] = data.stock_id;
+        j["area_center"] = data.area_center;
+        j["margin_available_amount"] = data.margin_available_amount;
+        j["margin_available_qty"] = data.margin_available_qty;
+        j["short_available_amount"] = data.short_available_amount;
+        j["short_available_qty"] = data.short_available_qty;
+        j["after_margin_available_amount"] = data.after_margin_available_amount;
+        j["after_margin_available_qty"] = data.after_margin_available_qty;
+        j["after_short_available_amount"] = data.after_short_available_amount;
+        j["after_short_available_qty"] = data.after_short_available_qty;
+        j["belong_branches"] = data.belong_branches.get();
+        return j.dump();
+    }
+
+    std::string writerJson(const SummaryData &data)
+    {
+        std::string out;
+        EXPECT_TRUE(SummaryJsonWriter::write(data, out));
+        return out;
+    }
+
+    SummaryData sample()
+    {
+        SummaryData data;
+        data.stock_id = "2330";
+        data.area_center = "ALL";
+        data.margin_available_amount = 123456789;
+        data.margin_available_qty = 1000;
+        data.short_available_amount = -42;
+        data.short_available_qty = 0;
+        data.after_margin_available_amount = 9;
+        data.after_margin_available_qty = 10;
+        data.after_short_available_amount = 99;
+        data.after_short_available_qty = 100;
+        data.belong_branches = AreaBranchProvider::internBranches({"9A00", "9A91", "9B00"});
+        return data;
+    }
+} // namespace
+
+TEST(SummaryJsonWriterTest, MatchesNlohmannForTypicalSummary)
+{
+    auto data = sample();
+    EXPECT_EQ(writerJson(data), domJson(data));
+}
+
+TEST(SummaryJsonWriterTest, MatchesNlohmannForEmptyFieldsAndBranches)
+{
+    SummaryData data;
+    EXPECT_EQ(writerJson(data), domJson(data));
+}
+
+TEST(SummaryJsonWriterTest, MatchesNlohmannForIntegerLimits)
+{
+    auto data = sample();
+    data.margin_available_amount = std::numeric_limits<int64_t>::min();
+    data.margin_available_qty = std::numeric_limits<int64_t>::max();
+    data.short_available_amount = -1;
+    data.short_available_qty = -10;
+    data.after_margin_available_amount = -99;
+    data.after_margin_available_qty = -100;
+    EXPECT_EQ(writerJson(data), domJson(data));
+}
+
+TEST(SummaryJsonWriterTest, MatchesNlohmannForEscapedCharacters)
+{
+    auto data = sample();
+    data.stock_id = "a\"b\\c/d";
+    data.area_center = std::string("\b\f\n\r\t\x01\x1f\x7f", 8);
+    data.belong_branches = AreaBranchProvider::internBranches({"", " ", std::string("\0", 1)});
+    EXPECT_EQ(writerJson(data), domJson(data));
+}
+
+TEST(SummaryJsonWriterTest, RejectsNonAsciiStrings)
+{
+    auto data = sample();
+    auto branches = data.belong_branches.get();
+    branches.push_back("\xe5\x8f\xb0");
+    data.belong_branches = AreaBranchProvider::internBranches(branches);
+    std::string out;
+    EXPECT_FALSE(SummaryJsonWriter::write(data, out));
+}
+
+TEST(SummaryJsonWriterTest, MatchesNlohmannForRandomSummaries)
+{
+    std::mt19937_64 rng(20240601);
+    std::uniform_int_distribution<int> ch(0, 0x7f);
+    std::uniform_int_distribution<int> len(0, 8);
+    auto randomString = [&]
+    {
+        std::string s(static_cast<size_t>(len(rng)), ' ');
+        for (auto &c : s)
+            c = static_cast<char>(ch(rng));
+        return s;
+    };
+
+    std::string out;
+    for (int i = 0; i < 2000; ++i)
+    {
+        SummaryData data;
+        data.stock_id = randomString();
+        data.area_center = randomString();
+        data.margin_available_amount = static_cast<int64_t>(rng());
+        data.margin_available_qty = static_cast<int64_t>(rng() >> (rng() % 64));
+        data.short_available_amount = -static_cast<int64_t>(rng() >> (rng() % 64 + 1));
+        data.short_available_qty = static_cast<int64_t>(rng() % 1000);
+        data.after_margin_available_amount = static_cast<int64_t>(rng());
+        data.after_margin_available_qty = static_cast<int64_t>(rng() % 100) - 50;
+        data.after_short_available_amount = static_cast<int64_t>(rng());
+        data.after_short_available_qty = static_cast<int64_t>(rng() % 10);
+        std::vector<std::string> branches;
+        for (int b = len(rng); b > 0; --b)
+            branches.push_back(randomString());
+        data.belong_branches = AreaBranchProvider::internBranches(branches);
+
+        ASSERT_TRUE(SummaryJsonWriter::write(data, out));
+        ASSERT_EQ(out, domJson(data));
+    }
+}
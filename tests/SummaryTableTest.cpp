@@ -0,0 +1,270 @@
+#include <gtest/gtest.h>
+#include "domain/SummaryKey.hpp"
+#include "infrastructure/storage/SummaryTable.hpp"
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using finance::domain::SummaryData;
+using finance::domain::SummaryKey;
+using finance::domain::SummarySnapshot;
+using finance::infrastructure::storage::SummaryTable;
+
+TEST(SummaryKeyTest, RoundTripsAreaAndStock)
+{
+    auto key = SummaryKey::make("01", "2330");
+    ASSERT_TRUE(key.has_value());
+    EXPECT_EQ(key->area(), "01");
+    EXPECT_EQ(key->stock(), "2330");
+    EXPECT_EQ(key->redisKey(), "summary:01:2330");
+    EXPECT_NE(key->packed(), 0u);
+    EXPECT_EQ(key->packed() >> 63, 0u);
+}
+
+TEST(SummaryKeyTest, TrimsFixedWidthPacketFields)
+{
+    const char area[3] = {'0', '1', ' '};
+    const char stock[6] = {'2', '3', '3', '0', ' ', ' '};
+    auto key = SummaryKey::make(std::string_view(area, sizeof(area)), std::string_view(stock, sizeof(stock)));
+    ASSERT_TRUE(key.has_value());
+    EXPECT_EQ(*key, *SummaryKey::make("01", "2330"));
+}
+
+TEST(SummaryKeyTest, ParsesRedisKeys)
+{
+    auto key = SummaryKey::parse("summary:ALL:00632R");
+    ASSERT_TRUE(key.has_value());
+    EXPECT_EQ(key->area(), "ALL");
+    EXPECT_EQ(key->stock(), "00632R");
+    EXPECT_EQ(key->stockBits(), SummaryKey::make("01", "00632R")->stockBits());
+
+    EXPECT_FALSE(SummaryKey::parse("2330").has_value());
+    EXPECT_FALSE(SummaryKey::parse("summary:01").has_value());
+    EXPECT_FALSE(SummaryKey::parse("summary:0001:2330").has_value());
+    EXPECT_FALSE(SummaryKey::parse("summary:01:1234567").has_value());
+    EXPECT_FALSE(SummaryKey::parse("summary:01:2330 ").has_value());
+    EXPECT_FALSE(SummaryKey::parse("summary::2330").has_value());
+    EXPECT_FALSE(SummaryKey::parse("summary:01:\xe5\x8f\xb0").has_value());
+}
+
+TEST(SummaryKeyTest, DistinguishesPrefixes)
+{
+    EXPECT_NE(*SummaryKey::make("0", "12"), *SummaryKey::make("01", "2"));
+    EXPECT_NE(*SummaryKey::make("01", "233"), *SummaryKey::make("01", "2330"));
+    EXPECT_NE(*SummaryKey::make("1", "2330"), *SummaryKey::make("01", "2330"));
+}
+
+TEST(SummaryTableTest, EmplaceFindAndErase)
+{
+    SummaryTable table;
+    auto key = *SummaryKey::make("01", "2330");
+    EXPECT_EQ(table.find(key), nullptr);
+
+    auto [data, inserted] = table.emplace(key);
+    ASSERT_NE(data, nullptr);
+    EXPECT_TRUE(inserted);
+    data->margin_available_qty = 42;
+
+    auto [again, insertedAgain] = table.emplace(key);
+    EXPECT_EQ(again, data);
+    EXPECT_FALSE(insertedAgain);
+    EXPECT_EQ(table.find(std::string("summary:01:2330")), data);
+    EXPECT_EQ(table.size(), 1u);
+
+    EXPECT_TRUE(table.erase(key));
+    EXPECT_FALSE(table.erase(key));
+    EXPECT_EQ(table.find(key), nullptr);
+    EXPECT_EQ(table.size(), 0u);
+    EXPECT_EQ(table.retiredSlots(), 1u);
+
+    // 移除的位置不重複使用：仍持有舊指標的讀者不會看到別的 key
+    auto [fresh, freshInserted] = table.emplace(*SummaryKey::make("02", "2317"));
+    EXPECT_TRUE(freshInserted);
+    EXPECT_NE(fresh, data);
+    EXPECT_EQ(fresh->margin_available_qty, 0);
+    EXPECT_EQ(data->margin_available_qty, 42);
+
+    // clear() 之後位置全部回收，重新插入的項目為預設值
+    table.clear();
+    EXPECT_EQ(table.retiredSlots(), 0u);
+    auto [recycled, recycledInserted] = table.emplace(key);
+    EXPECT_TRUE(recycledInserted);
+    EXPECT_EQ(recycled, data);
+    EXPECT_EQ(recycled->margin_available_qty, 0);
+}
+
+TEST(SummaryTableTest, KeepsAddressesStableAcrossGrowth)
+{
+    SummaryTable table;
+    auto first = table.emplace(*SummaryKey::make("01", "0001")).first;
+    first->stock_id = "0001";
+    for (int i = 2; i < 20000; ++i)
+        table.emplace(*SummaryKey::make("01", std::to_string(i)));
+
+    EXPECT_EQ(table.find(*SummaryKey::make("01", "0001")), first);
+    EXPECT_EQ(first->stock_id, "0001");
+    EXPECT_EQ(table.size(), 19999u);
+}
+
+TEST(SummaryTableTest, StoresUnpackableKeysSeparately)
+{
+    SummaryTable table;
+    auto [data, inserted] = table.emplace(std::string("legacy-key"));
+    EXPECT_TRUE(inserted);
+    data->stock_id = "legacy";
+    EXPECT_EQ(table.find(std::string("legacy-key")), data);
+    EXPECT_EQ(table.size(), 1u);
+
+    EXPECT_TRUE(table.erase(std::string("legacy-key")));
+    EXPECT_EQ(table.find(std::string("legacy-key")), nullptr);
+}
+
+TEST(SummaryTableTest, MatchesUnorderedMapUnderRandomOperations)
+{
+    SummaryTable table;
+    std::unordered_map<uint64_t, int64_t> reference;
+    std::mt19937_64 rng(13);
+    const std::vector<std::string> areas = {"01", "02", "03", "ALL"};
+
+    for (int i = 0; i < 50000; ++i)
+    {
+        auto key = *SummaryKey::make(areas[rng() % areas.size()], std::to_string(rng() % 500));
+        switch (rng() % 4)
+        {
+        case 0:
+            EXPECT_EQ(table.erase(key), reference.erase(key.packed()) == 1);
+            break;
+        case 1:
+        {
+            auto *data = table.find(key);
+            auto it = reference.find(key.packed());
+            ASSERT_EQ(data != nullptr, it != reference.end());
+            if (data)
+            {
+                EXPECT_EQ(data->margin_available_qty, it->second);
+            }
+            break;
+        }
+        default:
+        {
+            auto [data, inserted] = table.emplace(key);
+            EXPECT_EQ(inserted, reference.count(key.packed()) == 0);
+            data->margin_available_qty = i;
+            reference[key.packed()] = i;
+            break;
+        }
+        }
+        ASSERT_EQ(table.size(), reference.size());
+    }
+
+    table.clear();
+    EXPECT_EQ(table.size(), 0u);
+    EXPECT_EQ(table.find(*SummaryKey::make("01", "1")), nullptr);
+}
+
+TEST(SummaryTableTest, PublishesSnapshotsByKey)
+{
+    SummaryTable table;
+    const auto key = *SummaryKey::make("01", "2330");
+    const auto other = *SummaryKey::make("02", "2317");
+    SummarySnapshot snapshot;
+
+    EXPECT_FALSE(table.readPublished(key, snapshot));
+    EXPECT_FALSE(table.publish(key, SummaryData{}));
+
+    auto *data = table.emplace(key).first;
+    EXPECT_FALSE(table.readPublished(key, snapshot)); // 尚未發佈
+    data->h01_margin_amount = 1200;
+    data->margin_available_qty = 3;
+    ASSERT_TRUE(table.publish(key, *data));
+    ASSERT_TRUE(table.readPublished(key, snapshot));
+    EXPECT_EQ(snapshot.h01_margin_amount, 1200);
+    EXPECT_EQ(snapshot.margin_available_qty, 3);
+    const auto restored = snapshot.toSummaryData();
+    EXPECT_EQ(restored.area_center, "01");
+    EXPECT_EQ(restored.stock_id, "2330");
+    EXPECT_EQ(restored.h01_margin_amount, 1200);
+
+    // 移除後舊 key 無法再發佈或讀取，新 key 使用另一個位置
+    ASSERT_TRUE(table.erase(key));
+    EXPECT_FALSE(table.readPublished(key, snapshot));
+    EXPECT_FALSE(table.publish(key, *data));
+    auto *inserted = table.emplace(other).first;
+    EXPECT_NE(inserted, data);
+    EXPECT_FALSE(table.readPublished(other, snapshot));
+    inserted->h01_margin_amount = 7;
+    ASSERT_TRUE(table.publish(other, *inserted));
+    EXPECT_FALSE(table.readPublished(key, snapshot));
+    ASSERT_TRUE(table.readPublished(other, snapshot));
+    EXPECT_EQ(snapshot.h01_margin_amount, 7);
+}
+
+TEST(SummaryTableTest, LockFreeReadersSeeConsistentSnapshotsWhileTableGrows)
+{
+    SummaryTable table;
+    const auto hot = *SummaryKey::make("01", "2330");
+    table.emplace(hot);
+    std::atomic<bool> done{false};
+    std::atomic<size_t> torn{0};
+    std::atomic<size_t> lost{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&]
+                             {
+                                 SummarySnapshot snapshot;
+                                 while (!done.load(std::memory_order_acquire))
+                                 {
+                                     if (!table.readPublished(hot, snapshot))
+                                         continue;
+                                     // 寫者每次發佈的欄位都相同，讀到不同值代表讀到寫入中途的資料
+                                     if (snapshot.h01_margin_amount != snapshot.h05p_short_sell_offset_qty ||
+                                         snapshot.margin_available_qty != snapshot.h01_margin_amount)
+                                         torn.fetch_add(1, std::memory_order_relaxed);
+                                     // 擴容期間既有的 key 不可查不到
+                                     if (table.find(hot) == nullptr)
+                                         lost.fetch_add(1, std::memory_order_relaxed);
+                                 } });
+    }
+
+    SummaryData data;
+    for (int i = 1; i <= 20000; ++i)
+    {
+        if (i % 4 == 0) // 插入新 key，讓索引持續擴容
+            table.emplace(*SummaryKey::make("02", std::to_string(i)));
+        data.h01_margin_amount = i;
+        data.margin_available_qty = i;
+        data.h05p_short_sell_offset_qty = i;
+        table.publish(hot, data);
+    }
+    done.store(true, std::memory_order_release);
+    for (auto &reader : readers)
+        reader.join();
+
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_EQ(lost.load(), 0u);
+    SummarySnapshot snapshot;
+    ASSERT_TRUE(table.readPublished(hot, snapshot));
+    EXPECT_EQ(snapshot.h01_margin_amount, 20000);
+    EXPECT_EQ(table.size(), 5001u);
+}
+
+TEST(SummaryTableTest, ReserveAvoidsGrowthForReservedEntries)
+{
+    SummaryTable table;
+    table.reserve(5000);
+    const size_t capacity = table.indexCapacity();
+    std::vector<SummaryData *> pointers;
+    for (int id = 0; id < 5000; ++id)
+        pointers.push_back(table.emplace(*SummaryKey::make("91", std::to_string(id))).first);
+    EXPECT_EQ(table.indexCapacity(), capacity);
+
+    // 預留的 slab 為一塊連續記憶體
+    for (size_t i = 1; i < pointers.size(); ++i)
+        ASSERT_EQ(reinterpret_cast<char *>(pointers[i]) - reinterpret_cast<char *>(pointers[i - 1]),
+                  reinterpret_cast<char *>(pointers[1]) - reinterpret_cast<char *>(pointers[0]));
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "infrastructure/network/TransactionHandler.hpp"
+#include "infrastructure/storage/RedisSummaryAdapter.hpp"
+#include <cstring>
+#include <memory>
+
+using namespace finance::domain;
+using finance::infrastructure::network::TransactionProcessor;
+namespace tcode = finance::infrastructure::network::tcode;
+using finance::infrastructure::storage::RedisSummaryAdapter;
+
+namespace
+{
+    class CountingHandler : public IPackageHandler
+    {
+    public:
+        explicit CountingHandler(int &calls) : calls_(calls) {}
+        Result<void, ErrorResult> handle(const FinancePackageMessage &) override
+        {
+            ++calls_;
+            return Result<void, ErrorResult>::Ok();
+        }
+
+    private:
+        int &calls_;
+    };
+
+    FinancePackageMessage makePacket(const char *code, char entryType = 'A')
+    {
+        FinancePackageMessage pkg;
+        std::memset(&pkg, ' ', sizeof(pkg));
+        std::memcpy(pkg.t_code, code, sizeof(pkg.t_code));
+        pkg.ap_data.entry_type[0] = entryType;
+        return pkg;
+    }
+} // namespace
+
+TEST(TransactionProcessorTest, TcodeValueMatchesPacketBytes)
+{
+    static_assert(tcode::HCRTM01 != tcode::HCRTM05P);
+    auto pkg = makePacket("ELD002");
+    EXPECT_EQ(tcode::value(pkg.t_code), tcode::HCRTM05P);
+    EXPECT_NE(tcode::value(makePacket("ELD003").t_code), tcode::HCRTM05P);
+}
+
+TEST(TransactionProcessorTest, UnknownCodeAndEntryTypeAreRejected)
+{
+    TransactionProcessor processor(std::make_shared<RedisSummaryAdapter>());
+
+    auto unknown = processor.handle(makePacket("ELD999"));
+    ASSERT_TRUE(unknown.is_err());
+    EXPECT_EQ(unknown.unwrap_err().code, ErrorCode::UnknownTransactionCode);
+
+    auto badEntry = processor.handle(makePacket("ELD001", 'X'));
+    ASSERT_TRUE(badEntry.is_err());
+    EXPECT_EQ(badEntry.unwrap_err().code, ErrorCode::InvalidPacket);
+}
+
+TEST(TransactionProcessorTest, RuntimeRegisteredCodesUseFallback)
+{
+    TransactionProcessor processor(std::make_shared<RedisSummaryAdapter>());
+    int first = 0, second = 0;
+
+    EXPECT_TRUE(processor.registerHandler("ELD003", std::make_unique<CountingHandler>(first)));
+    EXPECT_TRUE(processor.handle(makePacket("ELD003")).is_ok());
+    EXPECT_EQ(first, 1);
+
+    // 重複註冊時取代舊的處理器
+    EXPECT_TRUE(processor.registerHandler("ELD003", std::make_unique<CountingHandler>(second)));
+    EXPECT_TRUE(processor.handle(makePacket("ELD003")).is_ok());
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(second, 1);
+
+    EXPECT_FALSE(processor.registerHandler("ELD03", std::make_unique<CountingHandler>(first)));
+}
+
+TEST(TransactionProcessorTest, BuiltInCodesCannotBeReplaced)
+{
+    TransactionProcessor processor(std::make_shared<RedisSummaryAdapter>());
+    int calls = 0;
+
+    EXPECT_FALSE(processor.registerHandler("ELD001", std::make_unique<CountingHandler>(calls)));
+
+    // 仍由內建的 Hcrtm01Handler 處理：空白區中心是無效封包，而不是未知代碼
+    auto result = processor.handle(makePacket("ELD001"));
+    ASSERT_TRUE(result.is_err());
+    EXPECT_EQ(result.unwrap_err().code, ErrorCode::InvalidPacket);
+    EXPECT_EQ(calls, 0);
+}
@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include "infrastructure/tasks/RedisWorker.hpp"
+#include "infrastructure/tasks/WriteBehindBuffer.hpp"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace finance::domain;
+using namespace finance::infrastructure::tasks;
+using namespace std::chrono_literals;
+
+namespace
+{
+    // 記錄每次寫入的假 repository
+    class RecordingRepository : public IFinanceRepository<SummaryData, ErrorResult>
+    {
+    public:
+        Result<void, ErrorResult> init() override { return Result<void, ErrorResult>::Ok(); }
+        Result<void, ErrorResult> loadAll() override { return Result<void, ErrorResult>::Ok(); }
+        Result<SummaryData *, ErrorResult> getData(const std::string &) override
+        {
+            return Result<SummaryData *, ErrorResult>::Err(ErrorResult{ErrorCode::InternalError, "unused"});
+        }
+        Result<void, ErrorResult> setData(const std::string &, const SummaryData &) override { return Result<void, ErrorResult>::Ok(); }
+        bool remove(const std::string &) override { return true; }
+        std::future<Result<void, ErrorResult>> sync_async(const std::string &, const SummaryData &) override { return {}; }
+        std::future<Result<void, ErrorResult>> update_async(const std::string &) override { return {}; }
+
+        Result<void, ErrorResult> sync(const std::string &key, const SummaryData *data) override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            syncs.emplace_back(key, data->margin_available_amount);
+            return Result<void, ErrorResult>::Ok();
+        }
+
+        Result<void, ErrorResult> update(const std::string &stock_id) override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            updates.push_back(stock_id);
+            return Result<void, ErrorResult>::Ok();
+        }
+
+        std::vector<Result<void, ErrorResult>> syncBatch(const std::vector<std::pair<std::string, const SummaryData *>> &items,
+                                                         const std::vector<std::string> &updateKeys,
+                                                         size_t lane) override
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                batchSizes.push_back(items.size() + updateKeys.size());
+            }
+            auto results = IFinanceRepository::syncBatch(items, updateKeys, lane);
+            if (failKey.size())
+            {
+                for (size_t i = 0; i < items.size(); ++i)
+                    if (items[i].first == failKey)
+                        results[i] = Result<void, ErrorResult>::Err(ErrorResult{ErrorCode::RedisReplyTypeError, "injected"});
+            }
+            return results;
+        }
+
+        size_t syncCount()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return syncs.size();
+        }
+
+        std::mutex mutex_;
+        std::vector<std::pair<std::string, int64_t>> syncs;
+        std::vector<std::string> updates;
+        std::vector<size_t> batchSizes;
+        std::string failKey;
+    };
+
+    RedisTask syncTask(const std::string &key, int64_t value)
+    {
+        SummaryData data;
+        data.margin_available_amount = value;
+        return RedisTask(RedisOperationType::SYNC_SUMMARY_DATA, key, data, nullptr);
+    }
+}
+
+TEST(WriteBehindBufferTest, CoalescesSameKeyAndKeepsLatestPayload)
+{
+    WriteBehindBuffer buffer(WriteBehindBuffer::Options{1000ms, 512, 1000000us});
+    for (int i = 1; i <= 200; ++i)
+        buffer.push(syncTask("summary:A01:2330", i));
+    buffer.push(syncTask("summary:A02:2330", 7));
+    buffer.push(RedisTask(RedisOperationType::UPDATE_COMPANY_SUMMARY, "2330", nullptr));
+    buffer.push(RedisTask(RedisOperationType::UPDATE_COMPANY_SUMMARY, "2330", nullptr));
+
+    EXPECT_EQ(buffer.size(), 3u);
+    EXPECT_EQ(buffer.coalescedCount(), 200u);
+
+    buffer.close();
+    std::vector<RedisTask> batch;
+    ASSERT_TRUE(buffer.waitForBatch(batch));
+    ASSERT_EQ(batch.size(), 3u);
+    EXPECT_EQ(batch[0].key, "summary:A01:2330");
+    EXPECT_EQ(batch[0].summary_data_payload->margin_available_amount, 200);
+    EXPECT_EQ(batch[1].key, "summary:A02:2330");
+    EXPECT_EQ(batch[2].operation, RedisOperationType::UPDATE_COMPANY_SUMMARY);
+    EXPECT_FALSE(buffer.waitForBatch(batch));
+}
+
+TEST(WriteBehindBufferTest, FlushesWhenBatchSizeReached)
+{
+    WriteBehindBuffer buffer(WriteBehindBuffer::Options{10000ms, 4, 10000000us});
+    for (int i = 0; i < 4; ++i)
+        buffer.push(syncTask("summary:A01:" + std::to_string(i), i));
+
+    std::vector<RedisTask> batch;
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(buffer.waitForBatch(batch));
+    EXPECT_EQ(batch.size(), 4u);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+}
+
+TEST(WriteBehindBufferTest, FlushesWhenIdle)
+{
+    WriteBehindBuffer buffer(WriteBehindBuffer::Options{10000ms, 512, 1000us});
+    buffer.push(syncTask("summary:A01:2330", 1));
+
+    std::vector<RedisTask> batch;
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(buffer.waitForBatch(batch));
+    EXPECT_EQ(batch.size(), 1u);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+}
+
+TEST(WriteBehindBufferTest, StalenessBoundHoldsUnderContinuousUpdates)
+{
+    // 持續有新資料 (永遠不閒置)，仍須在 flushInterval 內寫出
+    WriteBehindBuffer buffer(WriteBehindBuffer::Options{20ms, 512, 10000000us});
+    std::atomic<bool> stop{false};
+    std::thread producer([&]
+                         {
+        int i = 0;
+        while (!stop)
+        {
+            buffer.push(syncTask("summary:A01:2330", ++i));
+            std::this_thread::sleep_for(100us);
+        } });
+
+    std::vector<RedisTask> batch;
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(buffer.waitForBatch(batch));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    stop = true;
+    producer.join();
+
+    EXPECT_EQ(batch.size(), 1u);
+    EXPECT_LT(elapsed, 1s);
+}
+
+TEST(WriteBehindBufferTest, PushAfterCloseFailsImmediately)
+{
+    WriteBehindBuffer buffer;
+    buffer.close();
+    auto promise = std::make_shared<std::promise<Result<void, ErrorResult>>>();
+    auto future = promise->get_future();
+    SummaryData data;
+    buffer.push(RedisTask(RedisOperationType::SYNC_SUMMARY_DATA, "k", data, promise));
+    ASSERT_EQ(future.wait_for(0s), std::future_status::ready);
+    EXPECT_TRUE(future.get().is_err());
+}
+
+TEST(RedisWorkerTest, CoalescedSubmissionsShareOneWrite)
+{
+    auto repo = std::make_shared<RecordingRepository>();
+    RedisWorker worker(repo, WriteBehindBuffer::Options{10000ms, 512, 10000000us});
+
+    std::vector<std::future<Result<void, ErrorResult>>> futures;
+    for (int i = 1; i <= 50; ++i)
+        futures.push_back(worker.submit_task(syncTask("summary:A01:2330", i)));
+    futures.push_back(worker.submit_task(RedisTask(RedisOperationType::UPDATE_COMPANY_SUMMARY, "2330", nullptr)));
+
+    worker.start();
+    worker.stop(); // 停止時寫出剩餘資料，且不可卡住
+
+    for (auto &f : futures)
+    {
+        ASSERT_EQ(f.wait_for(0s), std::future_status::ready);
+        EXPECT_TRUE(f.get().is_ok());
+    }
+    ASSERT_EQ(repo->syncs.size(), 1u);
+    EXPECT_EQ(repo->syncs[0].second, 50);
+    EXPECT_EQ(repo->updates, (std::vector<std::string>{"2330"}));
+}
+
+TEST(RedisWorkerTest, IdleFlushWritesPromptly)
+{
+    auto repo = std::make_shared<RecordingRepository>();
+    RedisWorker worker(repo, WriteBehindBuffer::Options{10000ms, 512, 500us});
+    worker.start();
+
+    auto future = worker.submit_task(syncTask("summary:A01:2330", 1));
+    ASSERT_EQ(future.wait_for(2s), std::future_status::ready);
+    EXPECT_TRUE(future.get().is_ok());
+    EXPECT_EQ(repo->syncCount(), 1u);
+    worker.stop();
+}
+
+TEST(RedisWorkerTest, FlushSendsWholeBatchInOneCallAndMapsResults)
+{
+    auto repo = std::make_shared<RecordingRepository>();
+    repo->failKey = "summary:A02:2330";
+    RedisWorker worker(repo, WriteBehindBuffer::Options{10000ms, 512, 10000000us});
+
+    auto ok1 = worker.submit_task(syncTask("summary:A01:2330", 1));
+    auto failed = worker.submit_task(syncTask("summary:A02:2330", 2));
+    auto ok2 = worker.submit_task(RedisTask(RedisOperationType::UPDATE_COMPANY_SUMMARY, "2330", nullptr));
+    auto missing = worker.submit_task(RedisTask(RedisOperationType::SYNC_SUMMARY_DATA, "summary:A03:2330", nullptr));
+
+    worker.start();
+    worker.stop();
+
+    EXPECT_EQ(repo->batchSizes, (std::vector<size_t>{3}));
+    EXPECT_TRUE(ok1.get().is_ok());
+    EXPECT_TRUE(failed.get().is_err());
+    EXPECT_TRUE(ok2.get().is_ok());
+    EXPECT_TRUE(missing.get().is_err());
+}
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include "infrastructure/network/TransactionHandler.hpp"
+#include "infrastructure/storage/RedisSummaryAdapter.hpp"
+#include "infrastructure/tasks/WriteBehindBuffer.hpp"
+#include "infrastructure/config/AreaBranchProvider.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace finance::domain;
+using finance::infrastructure::config::AreaBranchProvider;
+using finance::infrastructure::network::TransactionProcessor;
+using finance::infrastructure::storage::RedisSummaryAdapter;
+using finance::infrastructure::tasks::RedisOperationType;
+using finance::infrastructure::tasks::RedisTask;
+using finance::infrastructure::tasks::WriteBehindBuffer;
+
+// 計數用的全域 operator new/delete：只統計目前執行緒在計數區間內的配置。
+// 取代全域配置函式會影響整個執行檔，因此本檔另建為 run_allocation_tests (見 cmake/ConfigureTests.cmake)；
+// 一般、nothrow、對齊、sized 與陣列版本全部取代，配對的 new/delete 都走 malloc/free
+namespace
+{
+    thread_local bool g_counting = false;
+    thread_local size_t g_allocations = 0;
+
+    struct AllocationCounter
+    {
+        AllocationCounter()
+        {
+            g_allocations = 0;
+            g_counting = true;
+        }
+        ~AllocationCounter() { g_counting = false; }
+        size_t count() const { return g_allocations; }
+    };
+
+    void *countedAlloc(std::size_t size, std::size_t alignment) noexcept
+    {
+        if (g_counting)
+            ++g_allocations;
+        if (size == 0)
+            size = 1;
+        if (alignment <= alignof(std::max_align_t))
+            return std::malloc(size);
+        // aligned_alloc 要求大小為對齊值的倍數
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+
+    void *countedAllocOrThrow(std::size_t size, std::size_t alignment)
+    {
+        if (void *p = countedAlloc(size, alignment))
+            return p;
+        throw std::bad_alloc();
+    }
+} // namespace
+
+void *operator new(std::size_t size) { return countedAllocOrThrow(size, 0); }
+void *operator new[](std::size_t size) { return countedAllocOrThrow(size, 0); }
+void *operator new(std::size_t size, std::align_val_t al) { return countedAllocOrThrow(size, static_cast<std::size_t>(al)); }
+void *operator new[](std::size_t size, std::align_val_t al) { return countedAllocOrThrow(size, static_cast<std::size_t>(al)); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return countedAlloc(size, 0); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return countedAlloc(size, 0); }
+void *operator new(std::size_t size, std::align_val_t al, const std::nothrow_t &) noexcept { return countedAlloc(size, static_cast<std::size_t>(al)); }
+void *operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t &) noexcept { return countedAlloc(size, static_cast<std::size_t>(al)); }
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept { std::free(p); }
+
+namespace
+{
+    const std::vector<std::string> AREAS = {"91", "92"};
+    const std::vector<std::string> STOCKS = {"2330", "2317", "00632R"};
+
+    void loadAreaConfig()
+    {
+        auto path = std::filesystem::temp_directory_path() / "handler_allocation_area_branch.json";
+        std::ofstream(path) << R"({"91": ["9100", "9101"], "92": ["9200"]})";
+        AreaBranchProvider::loadFromFile(path.string());
+    }
+
+    // 數值欄位全部填 '1' (合法的後台數字)，再覆寫代號欄位
+    FinancePackageMessage makePacket(const char *tcode, const std::string &area, const std::string &stock)
+    {
+        FinancePackageMessage pkg;
+        std::memset(&pkg, ' ', sizeof(pkg));
+        std::memcpy(pkg.t_code, tcode, sizeof(pkg.t_code));
+        pkg.ap_data.entry_type[0] = 'A';
+        std::memcpy(pkg.ap_data.system, area.data(), area.size());
+        std::memset(&pkg.ap_data.data, '1', sizeof(pkg.ap_data.data));
+        if (std::strcmp(tcode, "ELD001") == 0)
+        {
+            auto &d = pkg.ap_data.data.hcrtm01;
+            std::memset(d.area_center, ' ', sizeof(d.area_center));
+            std::memcpy(d.area_center, area.data(), area.size());
+            std::memset(d.stock_id, ' ', sizeof(d.stock_id));
+            std::memcpy(d.stock_id, stock.data(), stock.size());
+        }
+        else
+        {
+            auto &d = pkg.ap_data.data.hcrtm05p;
+            std::memcpy(d.broker_id, area.data(), area.size());
+            std::memset(d.stock_id, ' ', sizeof(d.stock_id));
+            std::memcpy(d.stock_id, stock.data(), stock.size());
+        }
+        return pkg;
+    }
+} // namespace
+
+TEST(HandlerAllocationTest, CounterSeesEveryAllocationOverload)
+{
+    struct alignas(64) Wide
+    {
+        char c;
+    };
+    size_t allocations;
+    {
+        AllocationCounter counter;
+        delete new int(1);
+        delete[] new int[4];
+        delete new (std::nothrow) int(2);
+        auto *wide = new Wide{};
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(wide) % alignof(Wide), 0u);
+        delete wide;
+        delete[] new Wide[3];
+        allocations = counter.count();
+    }
+    EXPECT_EQ(allocations, 5u);
+}
+
+TEST(HandlerAllocationTest, SteadyStatePacketsDoNotAllocate)
+{
+    loadAreaConfig();
+    auto repo = std::make_shared<RedisSummaryAdapter>();
+    WriteBehindBuffer buffer(WriteBehindBuffer::Options{std::chrono::milliseconds(50), 4096, std::chrono::microseconds(1)});
+    size_t posted = 0;
+    repo->setTaskPoster([&](RedisTask task)
+                        {
+                            ++posted;
+                            buffer.push(std::move(task)); });
+    TransactionProcessor processor(repo);
+
+    std::vector<FinancePackageMessage> packets;
+    for (const auto &area : AREAS)
+        for (const auto &stock : STOCKS)
+        {
+            packets.push_back(makePacket("ELD001", area, stock));
+            packets.push_back(makePacket("ELD002", area, stock));
+        }
+
+    std::vector<RedisTask> batch;
+    auto runRound = [&]
+    {
+        for (int repeat = 0; repeat < 20; ++repeat)
+            for (const auto &pkg : packets)
+                ASSERT_TRUE(processor.handle(pkg).is_ok());
+    };
+
+    // 預熱：建立快取項目、合併索引與 pending_ / batch 兩個緩衝的容量
+    for (int warmup = 0; warmup < 3; ++warmup)
+    {
+        runRound();
+        ASSERT_TRUE(buffer.waitForBatch(batch));
+    }
+
+    for (int round = 0; round < 3; ++round)
+    {
+        size_t allocations;
+        {
+            AllocationCounter counter;
+            runRound();
+            allocations = counter.count();
+        }
+        EXPECT_EQ(allocations, 0u) << "round " << round;
+
+        ASSERT_TRUE(buffer.waitForBatch(batch));
+        // 每個 (區中心, 股票) 一筆 SYNC，每檔股票一筆 UPDATE
+        EXPECT_EQ(batch.size(), AREAS.size() * STOCKS.size() + STOCKS.size());
+    }
+    EXPECT_EQ(posted, 6 * 20 * packets.size() * 2);
+
+    // Redis key 只在 worker 端產生
+    for (auto &task : batch)
+    {
+        if (task.operation == RedisOperationType::UPDATE_COMPANY_SUMMARY)
+            EXPECT_EQ(task.resolveKey().find(':'), std::string::npos);
+        else
+            EXPECT_EQ(task.resolveKey().rfind("summary:9", 0), 0u);
+    }
+}
+
+// 獨立執行檔 run_allocation_tests 的進入點 (run_tests 的 main 在 RingBufferTest.cpp)
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    loguru::g_stderr_verbosity = loguru::Verbosity_OFF;
+    return RUN_ALL_TESTS();
+}